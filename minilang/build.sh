@@ -19,6 +19,27 @@ check_tools() {
     echo -e "${GREEN}✅ 所有必需的工具都已安装${NC}"
 }
 
+# 函数：宿主平台的可执行文件后缀与链接选项（Windows 下为 .exe 和 msvcrt，Linux 下生成 ELF 可执行文件）
+host_is_windows() {
+    case "$OSTYPE" in
+        msys*|cygwin*|win32*) return 0 ;;
+        *) return 1 ;;
+    esac
+}
+
+exe_suffix() {
+    if host_is_windows; then echo ".exe"; fi
+}
+
+host_link_libs() {
+    if host_is_windows; then echo "-lmsvcrt"; else echo "-pthread"; fi
+}
+
+# 编译器自身的 C 后端 JIT 用 dlopen 加载共享库
+host_dl_libs() {
+    if ! host_is_windows; then echo "-ldl"; fi
+}
+
 # 函数：显示用法
 show_usage() {
     echo -e "${BLUE}=== MyLang Compiler Build Script ===${NC}"
@@ -29,6 +50,7 @@ show_usage() {
     echo "  asm [文件]  生成指定文件的汇编代码"
     echo "  obj [文件]  生成指定文件的目标文件"
     echo "  exe [文件]  生成指定文件的可执行文件"
+    echo "  cexe [文件] 经 C 后端和 gcc -O2 生成可执行文件"
     echo "  debug [文件] 调试指定文件的可执行文件"
     echo "  test        编译并运行所有示例"
     echo "  clean       清理构建文件"
@@ -40,6 +62,7 @@ show_usage() {
     echo "  ./build.sh asm examples/hello.mylang"
     echo "  ./build.sh obj examples/hello.mylang"
     echo "  ./build.sh exe examples/hello.mylang"
+    echo "  ./build.sh cexe examples/hello.mylang"
     echo "  ./build.sh debug examples/hello.mylang"
     echo "  ./build.sh test"
     echo "  ./build.sh clean"
@@ -75,15 +98,29 @@ compile_only() {
     # 编译所有文件
     echo -e "${YELLOW}编译源文件...${NC}"
     gcc -c ../src/ast.c -I../src
+    gcc -c ../src/mir.c -I../src
+    gcc -c ../src/regalloc.c -I../src
+    gcc -c ../src/peephole.c -I../src
+    gcc -c ../src/x86enc.c -I../src
+    gcc -c ../src/elfobj.c -I../src
+    gcc -c ../src/jit.c -I../src
+    gcc -c ../src/cgen.c -I../src
     gcc -c ../src/symbol.c -I../src
+    gcc -c ../src/mlstring.c -I../src
+    gcc -c ../src/map.c -I../src
     gcc -c ../src/interpreter.c -I../src
     gcc -c parser.tab.c -I../src
     gcc -c lex.yy.c -I../src
-    gcc -c ../src/main.c -I../src
+    gcc -c ../src/main.c -I../src -I.
+
+    # 编译运行时库
+    echo -e "${YELLOW}编译运行时库...${NC}"
+    gcc -c -O2 -pthread ../src/runtime/ml_sort.c -o ml_sort.o
+    ar rcs libmlrt.a ml_sort.o
 
     # 链接
     echo -e "${YELLOW}链接...${NC}"
-    gcc -o minilang ast.o symbol.o interpreter.o parser.tab.o lex.yy.o main.o
+    gcc -o minilang ast.o mir.o regalloc.o peephole.o x86enc.o elfobj.o jit.o cgen.o symbol.o mlstring.o map.o interpreter.o parser.tab.o lex.yy.o main.o ml_sort.o -pthread $(host_dl_libs)
     
     if [ $? -eq 0 ]; then
         echo -e "${GREEN}✅ 编译成功！可执行文件: build/minilang${NC}"
@@ -270,6 +307,24 @@ generate_object() {
     # 先删除可能存在的旧文件
     rm -f "${base_name}.s" "${base_name}.o"
     
+    # Linux 上编译器直接输出 ELF 目标文件，不经过汇编器
+    if ! host_is_windows; then
+        echo -e "${YELLOW}执行命令: ${current_dir}/build/minilang -c ${file_name}${NC}"
+        if "${current_dir}/build/minilang" -c "$file_name" > /dev/null && [ -s "${base_name}.o" ]; then
+            echo -e "${GREEN}✅ 目标文件生成成功: ${base_name}.o${NC}"
+            if [ "$file_dir" != "." ]; then
+                mv "${base_name}.o" "$current_dir/"
+            fi
+        else
+            echo -e "${RED}❌ 目标文件生成失败${NC}"
+            cd "$current_dir"
+            exit 1
+        fi
+        cd "$current_dir"
+        echo "========================================"
+        return
+    fi
+    
     # 生成汇编文件
     echo -e "${YELLOW}正在生成汇编文件...${NC}"
     echo -e "${YELLOW}执行命令: ${current_dir}/build/minilang -S ${file_name}${NC}"
@@ -386,22 +441,29 @@ generate_executable() {
     fi
     
     # 先删除可能存在的旧文件
-    rm -f "${base_name}.s" "${base_name}.o" "${base_name}.exe"
+    local exe_file="${base_name}$(exe_suffix)"
+    rm -f "${base_name}.s" "${base_name}.o" "$exe_file"
     
-    # 生成汇编文件
-    echo -e "${YELLOW}正在生成汇编文件...${NC}"
-    "$current_dir/build/minilang" -S "$file_name"
-    
-    if [ $? -ne 0 ]; then
-        echo -e "${RED}❌ 汇编文件生成失败${NC}"
-        cd "$current_dir"
-        exit 1
+    if host_is_windows; then
+        # 生成汇编文件
+        echo -e "${YELLOW}正在生成汇编文件...${NC}"
+        "$current_dir/build/minilang" -S "$file_name"
+        
+        if [ $? -ne 0 ]; then
+            echo -e "${RED}❌ 汇编文件生成失败${NC}"
+            cd "$current_dir"
+            exit 1
+        fi
+        
+        # 编译汇编文件为目标文件
+        echo -e "${YELLOW}编译为目标文件...${NC}"
+        gcc -c -o "${base_name}.o" "${base_name}.s"
+    else
+        # 直接输出 ELF 目标文件，只有链接经过系统工具
+        echo -e "${YELLOW}正在生成目标文件...${NC}"
+        "$current_dir/build/minilang" -c "$file_name"
     fi
     
-    # 编译汇编文件为目标文件
-    echo -e "${YELLOW}编译为目标文件...${NC}"
-    gcc -c -o "${base_name}.o" "${base_name}.s"
-    
     if [ $? -ne 0 ]; then
         echo -e "${RED}❌ 目标文件生成失败${NC}"
         cd "$current_dir"
@@ -410,13 +472,13 @@ generate_executable() {
     
     # 链接生成可执行文件
     echo -e "${YELLOW}生成可执行文件...${NC}"
-    gcc -o "${base_name}.exe" "${base_name}.o" -lmsvcrt
+    gcc -o "$exe_file" "${base_name}.o" "$current_dir/build/libmlrt.a" $(host_link_libs)
     
     if [ $? -eq 0 ]; then
-        echo -e "${GREEN}✅ 可执行文件生成成功: ${base_name}.exe${NC}"
+        echo -e "${GREEN}✅ 可执行文件生成成功: ${exe_file}${NC}"
         # 如果不是在当前目录，移动生成的文件
         if [ "$file_dir" != "." ]; then
-            mv "${base_name}.exe" "$current_dir/"
+            mv "$exe_file" "$current_dir/"
         fi
         # 清理中间文件
         rm -f "${base_name}.s" "${base_name}.o"
@@ -431,6 +493,43 @@ generate_executable() {
     echo "========================================"
 }
 
+# 函数：经 C 后端生成可执行文件（翻译为 C 后由 gcc -O2 编译）
+generate_c_executable() {
+    local file=$1
+
+    if [ ! -f "$file" ]; then
+        echo -e "${RED}❌ 文件不存在: $file${NC}"
+        exit 1
+    fi
+
+    if [ ! -f "build/minilang" ]; then
+        echo -e "${YELLOW}编译器未编译，正在编译...${NC}"
+        compile_only
+    fi
+
+    echo -e "${BLUE}=== 经 C 后端生成可执行文件: $file ===${NC}"
+    echo "========================================"
+
+    local base_name=$(basename "$file" .mylang)
+    local file_dir=$(dirname "$file")
+    local exe_file="${file_dir}/${base_name}$(exe_suffix)"
+
+    # 编译器在输入文件旁边生成 .c 文件和可执行文件
+    echo -e "${YELLOW}正在生成 C 代码并编译...${NC}"
+    ./build/minilang -native "$file"
+
+    if [ $? -eq 0 ] && [ -f "$exe_file" ]; then
+        echo -e "${GREEN}✅ 可执行文件生成成功: ${exe_file}${NC}"
+        rm -f "${file_dir}/${base_name}.c"
+    else
+        echo -e "${RED}❌ 可执行文件生成失败${NC}"
+        echo -e "${YELLOW}保留 C 文件以便调试: ${file_dir}/${base_name}.c${NC}"
+        exit 1
+    fi
+
+    echo "========================================"
+}
+
 # 函数：调试可执行文件
 debug_executable() {
     local file=$1
@@ -460,7 +559,8 @@ debug_executable() {
     fi
     
     # 检查可执行文件是否存在
-    if [ ! -f "${base_name}.exe" ]; then
+    local exe_file="${base_name}$(exe_suffix)"
+    if [ ! -f "$exe_file" ]; then
         echo -e "${YELLOW}可执行文件不存在，正在生成...${NC}"
         # 先删除可能存在的旧文件
         rm -f "${base_name}.s" "${base_name}.o"
@@ -487,7 +587,7 @@ debug_executable() {
         
         # 链接生成可执行文件
         echo -e "${YELLOW}生成可执行文件...${NC}"
-        gcc -g -o "${base_name}.exe" "${base_name}.o" -lmsvcrt
+        gcc -g -o "$exe_file" "${base_name}.o" "$current_dir/build/libmlrt.a" $(host_link_libs)
         
         if [ $? -ne 0 ]; then
             echo -e "${RED}❌ 可执行文件生成失败${NC}"
@@ -516,7 +616,7 @@ debug_executable() {
     echo "========================================"
     
     # 启动 GDB
-    gdb "${base_name}.exe"
+    gdb "$file_dir/$exe_file"
     
     echo "========================================"
 }
@@ -676,6 +776,14 @@ case "$1" in
         fi
         generate_executable "$2"
         ;;
+    "cexe")
+        if [ -z "$2" ]; then
+            echo -e "${RED}❌ 请指定要生成可执行文件的文件${NC}"
+            show_usage
+            exit 1
+        fi
+        generate_c_executable "$2"
+        ;;
     "debug")
         if [ -z "$2" ]; then
             echo -e "${RED}❌ 请指定要调试的文件${NC}"
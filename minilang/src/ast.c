@@ -1,74 +1,216 @@
 #include "ast.h"
+#include "symbol.h"
+#include "mir.h"
+#include "x86enc.h"
+#include "elfobj.h"
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <ctype.h>
 #include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
 
 // 全局变量
-static int data_section_initialized = 0;
-static int string_label = 0;
-static int float_label = 0;
-static int label_count = 0;
-static int stack_offset = 4;
-static int array_label = 0; // 用于数组标签
-
-// 变量符号表结构
+static bool vectorize = true;
+static int vectorized_loops = 0;
+static bool unroll = true;
+static int unroll_factor = 0;
+static int unrolled_loops = 0;
+// 并行生成函数的线程数，0 表示按处理器个数
+static int codegen_jobs = 0;
+
+// 正在生成的汇编模块
+static MirModule *module = NULL;
+// 非 NULL 时函数直接编码为机器码（-c），不输出汇编文本
+static X86Code *object_code = NULL;
+
+// 变量符号表结构：标量变量是虚拟寄存器，由寄存器分配决定放在寄存器还是栈上；
+// 小数组在栈帧中，大数组和运行时确定大小的数组在堆上
 typedef struct
 {
     char *name;
-    int offset;
+    int offset;      // 数组元素0（堆上的数组为元素指针）相对 %rbp 的偏移（取负）
+    int type;        // TYPE_* 常量
+    int array_size;  // 数组元素个数，普通变量和运行时确定大小的数组为0
+    int vreg;        // 标量变量的虚拟寄存器编号
+    bool heap;       // offset 处的8字节存放元素指针
+    int length_vreg; // 运行时确定大小的数组：存放元素个数的虚拟寄存器，否则为 -1
+    // 非 NULL 时数组在解释器的堆上（OSR），越界时跳转到这个标签
+    const char *bounds_label;
 } Variable;
 
-static Variable *variables = NULL;
-static int variable_count = 0;
-static int variable_capacity = 0;
+// 堆上的数组：声明语句和栈帧中存放元素指针的槽
+typedef struct
+{
+    ASTNode *decl;
+    int offset;
+} HeapArray;
+
+// 代码生成上下文：一个（或一组串行生成的）函数的全部可变状态，不同上下文可以在不同线程中同时使用。
+// 标签、字符串和浮点常量的名字带上下文编号，生成结果与线程调度无关
+typedef struct
+{
+    int id;
+    MirModule *module; // 只读数据和符号名写入这里，并行生成时最后按函数顺序合并
+    MirFunction *fn;   // 正在生成的函数
+    Variable *variables;
+    int variable_count;
+    int variable_capacity;
+    int stack_offset;
+    int label_count;
+    int string_label;
+    int float_label;
+    // 函数体内 pushq 压入、尚未弹出的字节数；调用前据此把 %rsp 对齐到16字节
+    int push_depth;
+    // 正在使用的临时寄存器层数，超出临时寄存器数的部分压栈保存
+    int temp_depth;
+    // 当前函数的返回标签，return 跳转到这里
+    const char *return_label;
+    // 当前函数的返回类型：TYPE_FLOAT 时结果在 %xmm0，其他在 %eax
+    int return_type;
+    HeapArray *heap_arrays;
+    int heap_array_count;
+    int heap_array_capacity;
+    int frame_array_bytes;
+    int vectorized_loops;
+    int unrolled_loops;
+} CodegenContext;
+
+// 当前线程使用的上下文
+static _Thread_local CodegenContext *cg = NULL;
+
+static void context_init(CodegenContext *ctx, int id, MirModule *mod)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->id = id;
+    ctx->module = mod;
+    ctx->stack_offset = 4;
+    ctx->return_type = TYPE_INT;
+}
+
+static void context_free(CodegenContext *ctx)
+{
+    for (int i = 0; i < ctx->variable_count; i++)
+    {
+        free(ctx->variables[i].name);
+    }
+    free(ctx->variables);
+    free(ctx->heap_arrays);
+    ctx->variables = NULL;
+    ctx->heap_arrays = NULL;
+}
+
 
-// 查找变量偏移量
-static int get_variable_offset(const char *name)
+// 查找变量记录
+static Variable *find_variable(const char *name)
 {
-    for (int i = 0; i < variable_count; i++)
+    for (int i = 0; i < cg->variable_count; i++)
     {
-        if (strcmp(variables[i].name, name) == 0)
+        if (strcmp(cg->variables[i].name, name) == 0)
         {
-            return variables[i].offset;
+            return &cg->variables[i];
         }
     }
-    return -1;
+    return NULL;
+}
+
+static Variable *new_variable(const char *name)
+{
+    if (cg->variable_count >= cg->variable_capacity)
+    {
+        cg->variable_capacity = cg->variable_capacity == 0 ? 8 : cg->variable_capacity * 2;
+        cg->variables = realloc(cg->variables, cg->variable_capacity * sizeof(Variable));
+    }
+
+    Variable *var = &cg->variables[cg->variable_count++];
+    var->name = strdup(name);
+    var->offset = 0;
+    var->type = TYPE_INT;
+    var->array_size = 0;
+    var->vreg = -1;
+    var->heap = false;
+    var->length_vreg = -1;
+    var->bounds_label = NULL;
+    return var;
+}
+
+static bool is_array(const Variable *var)
+{
+    return var->type == TYPE_INT_ARRAY || var->type == TYPE_FLOAT_ARRAY || var->type == TYPE_STRING_ARRAY;
 }
 
-// 添加新变量
-static int add_variable(const char *name)
+// 下标检查用的元素个数：常量或运行时的虚拟寄存器
+static MirOperand array_length(const Variable *var)
 {
-    int offset = get_variable_offset(name);
-    if (offset != -1)
+    return var->length_vreg >= 0 ? mir_vreg(var->length_vreg) : mir_imm(var->array_size);
+}
+
+// 添加标量变量，已存在时返回原记录；同一个名字不能声明为不同的类型
+static Variable *add_variable(const char *name, int type)
+{
+    Variable *var = find_variable(name);
+    if (var != NULL)
     {
-        return offset;
+        if (!is_array(var) && var->type != type)
+        {
+            fprintf(stderr, "Error: Variable '%s' is redeclared with a different type\n", name);
+            exit(1);
+        }
+        return var;
     }
 
-    if (variable_count >= variable_capacity)
+    var = new_variable(name);
+    var->type = type;
+    var->vreg = cg->fn->vreg_count++;
+    return var;
+}
+
+// 在栈帧中分配数组：元素0位于最低地址 -offset(%rbp)，元素 size-1 位于 -offset + 4 * (size - 1)(%rbp)；
+// 元素个数补成偶数，按8字节清零
+static Variable *add_array_variable(const char *name, int type, int size)
+{
+    Variable *var = find_variable(name);
+    if (var != NULL && !var->heap && var->array_size == size)
     {
-        variable_capacity = variable_capacity == 0 ? 8 : variable_capacity * 2;
-        variables = realloc(variables, variable_capacity * sizeof(Variable));
+        var->type = type;
+        return var;
     }
 
-    variables[variable_count].name = strdup(name);
-    variables[variable_count].offset = stack_offset;
-    stack_offset += 4;
-    return variables[variable_count++].offset;
+    if (var == NULL)
+        var = new_variable(name);
+    cg->stack_offset += 4 * ((size + 1) / 2 * 2 - 1);
+    var->offset = cg->stack_offset;
+    cg->stack_offset += 4;
+    var->type = type;
+    var->array_size = size;
+    var->heap = false;
+    var->length_vreg = -1;
+    return var;
+}
+
+// 栈帧中的8字节槽，存放指针
+static int add_pointer_slot()
+{
+    cg->stack_offset += 4;
+    int offset = cg->stack_offset;
+    cg->stack_offset += 4;
+    return offset;
 }
 
 // 清理变量表
 static void clear_variables()
 {
-    for (int i = 0; i < variable_count; i++)
+    for (int i = 0; i < cg->variable_count; i++)
     {
-        free(variables[i].name);
+        free(cg->variables[i].name);
     }
-    free(variables);
-    variables = NULL;
-    variable_count = 0;
-    variable_capacity = 0;
-    stack_offset = 4;
+    free(cg->variables);
+    cg->variables = NULL;
+    cg->variable_count = 0;
+    cg->variable_capacity = 0;
+    cg->stack_offset = 4;
 }
 
 // AST节点创建函数
@@ -151,16 +293,27 @@ ASTNode *ast_new_formatted_print(char *format_string, ASTNode **args,
     return node;
 }
 
-ASTNode *ast_new_array_declaration(char *var_name, ASTNode *size, int line_no)
+ASTNode *ast_new_array_declaration(char *var_name, char *var_type, ASTNode *size, int line_no)
 {
     ASTNode *node = malloc(sizeof(ASTNode));
     node->type = AST_ARRAY_DECLARATION;
     node->line_no = line_no;
     node->array_decl.var_name = strdup(var_name);
+    node->array_decl.var_type = strdup(var_type);
     node->array_decl.size = size;
     return node;
 }
 
+ASTNode *ast_new_map_declaration(char *var_name, ASTNode *capacity, int line_no)
+{
+    ASTNode *node = malloc(sizeof(ASTNode));
+    node->type = AST_MAP_DECLARATION;
+    node->line_no = line_no;
+    node->map_decl.var_name = strdup(var_name);
+    node->map_decl.capacity = capacity;
+    return node;
+}
+
 ASTNode *ast_new_array_access(char *var_name, ASTNode *index, int line_no)
 {
     ASTNode *node = malloc(sizeof(ASTNode));
@@ -232,9 +385,21 @@ ASTNode *ast_new_for(ASTNode *init, ASTNode *cond, ASTNode *update, ASTNode *bod
     node->for_loop.cond = cond;
     node->for_loop.update = update;
     node->for_loop.body = body;
+    node->for_loop.unroll = 0;
     return node;
 }
 
+ASTNode *ast_set_unroll_hint(ASTNode *loop, int factor, int line_no)
+{
+    if (factor < 1 || factor > UNROLL_MAX_FACTOR)
+    {
+        fprintf(stderr, "Error: Unroll factor at line %d must be between 1 and %d\n", line_no, UNROLL_MAX_FACTOR);
+        exit(1);
+    }
+    loop->for_loop.unroll = factor;
+    return loop;
+}
+
 ASTNode *ast_new_block(ASTNode **statements, int count, int line_no)
 {
     ASTNode *node = malloc(sizeof(ASTNode));
@@ -245,12 +410,13 @@ ASTNode *ast_new_block(ASTNode **statements, int count, int line_no)
     return node;
 }
 
-ASTNode *ast_new_declaration(char *var_name, int line_no)
+ASTNode *ast_new_declaration(char *var_name, char *var_type, int line_no)
 {
     ASTNode *node = malloc(sizeof(ASTNode));
     node->type = AST_DECLARATION;
     node->line_no = line_no;
     node->decl.var_name = strdup(var_name);
+    node->decl.var_type = strdup(var_type);
     node->decl.init_value = NULL;
     return node;
 }
@@ -266,12 +432,13 @@ ASTNode *ast_new_param_declaration(char *var_name, char *var_type, int line_no)
     return node;
 }
 
-ASTNode *ast_new_declaration_init(char *var_name, ASTNode *init_value, int line_no)
+ASTNode *ast_new_declaration_init(char *var_name, char *var_type, ASTNode *init_value, int line_no)
 {
     ASTNode *node = malloc(sizeof(ASTNode));
     node->type = AST_DECLARATION_INIT;
     node->line_no = line_no;
     node->decl.var_name = strdup(var_name);
+    node->decl.var_type = strdup(var_type);
     node->decl.init_value = init_value;
     return node;
 }
@@ -396,7 +563,7 @@ void ast_print(ASTNode *node, int indent)
         printf("PARAM_DECLARATION(%s: %s)\n", node->decl.var_name, node->decl.var_type);
         break;
     case AST_ARRAY_DECLARATION:
-        printf("ARRAY_DECLARATION(%s", node->array_decl.var_name);
+        printf("ARRAY_DECLARATION(%s %s", node->array_decl.var_type, node->array_decl.var_name);
         if (node->array_decl.size)
         {
             printf("[");
@@ -405,6 +572,16 @@ void ast_print(ASTNode *node, int indent)
         }
         printf(")\n");
         break;
+    case AST_MAP_DECLARATION:
+        printf("MAP_DECLARATION(%s", node->map_decl.var_name);
+        if (node->map_decl.capacity)
+        {
+            printf("[");
+            ast_print(node->map_decl.capacity, 0);
+            printf("]");
+        }
+        printf(")\n");
+        break;
     case AST_ARRAY_ACCESS:
         printf("ARRAY_ACCESS(%s[", node->array_access.var_name);
         ast_print(node->array_access.index, 0);
@@ -440,7 +617,10 @@ void ast_print(ASTNode *node, int indent)
         ast_print(node->while_loop.body, indent + 1);
         break;
     case AST_FOR:
-        printf("FOR\n");
+        if (node->for_loop.unroll > 0)
+            printf("FOR (unroll %d)\n", node->for_loop.unroll);
+        else
+            printf("FOR\n");
         ast_print(node->for_loop.init, indent + 1);
         ast_print(node->for_loop.cond, indent + 1);
         ast_print(node->for_loop.update, indent + 1);
@@ -522,8 +702,13 @@ void ast_free(ASTNode *node)
         break;
     case AST_ARRAY_DECLARATION:
         free(node->array_decl.var_name);
+        free(node->array_decl.var_type);
         ast_free(node->array_decl.size);
         break;
+    case AST_MAP_DECLARATION:
+        free(node->map_decl.var_name);
+        ast_free(node->map_decl.capacity);
+        break;
     case AST_ARRAY_ACCESS:
         free(node->array_access.var_name);
         ast_free(node->array_access.index);
@@ -565,9 +750,11 @@ void ast_free(ASTNode *node)
         break;
     case AST_DECLARATION:
         free(node->decl.var_name);
+        free(node->decl.var_type);
         break;
     case AST_DECLARATION_INIT:
         free(node->decl.var_name);
+        free(node->decl.var_type);
         ast_free(node->decl.init_value);
         break;
     case AST_FUNCTION_CALL:
@@ -597,534 +784,2568 @@ void ast_free(ASTNode *node)
     free(node);
 }
 
-// 汇编代码生成函数
-void ast_write_to_file(ASTNode *node, const char *filename)
+// 代码生成：AST 经指令选择生成 MIR，寄存器分配后由 mir_emit_function 输出
+
+// 用户函数表：先收集全部函数定义，再逐个生成
+typedef struct
 {
-    FILE *output = fopen(filename, "w");
-    if (!output)
-    {
-        fprintf(stderr, "Error: Cannot open file %s\n", filename);
-        return;
-    }
+    const char *name;
+    const char *symbol; // 汇编符号，加前缀避免与 libc 函数重名，字符串归模块所有
+    ASTNode *def;
+    int return_type; // TYPE_FLOAT 或 TYPE_INT
+} FunctionInfo;
+
+static FunctionInfo *functions = NULL;
+static int function_count = 0;
+static int function_capacity = 0;
+
+// 选择代码生成目标，名称无效时返回0
+int ast_set_target(const char *name)
+{
+    return mir_set_target(name) ? 1 : 0;
+}
 
-    clear_variables();
-    stack_offset = 4;
+const char *ast_target_name(void)
+{
+    return mir_target->name;
+}
 
-    char *basename = strrchr(filename, '/');
-    if (!basename)
-        basename = strrchr(filename, '\\');
-    basename = basename ? basename + 1 : (char *)filename;
-    char *dot = strrchr(basename, '.');
-    if (dot)
-        *dot = '\0';
-
-    fprintf(output, "\t.file\t\"%s.c\"\n", basename);
-
-    // 首先定义错误消息字符串
-    fprintf(output, "\t.section .rdata,\"dr\"\n");
-    fprintf(output, ".LC0:\n");
-    fprintf(output, "\t.ascii \"Runtime error: Array index out of bounds\\0\"\n");
-
-    // 错误处理函数作为全局函数
-    fprintf(output, "\t.text\n");
-    fprintf(output, "\t.globl\tarray_bounds_error\n");
-    fprintf(output, "\t.def\tarray_bounds_error; .scl 2; .type 32; .endef\n");
-    fprintf(output, "\t.seh_proc\tarray_bounds_error\n");
-    fprintf(output, "array_bounds_error:\n");
-    fprintf(output, "\tpushq\t%%rbp\n");
-    fprintf(output, "\t.seh_pushreg\t%%rbp\n");
-    fprintf(output, "\tmovq\t%%rsp, %%rbp\n");
-    fprintf(output, "\t.seh_setframe\t%%rbp, 0\n");
-    fprintf(output, "\tsubq\t$32, %%rsp\n");
-    fprintf(output, "\t.seh_stackalloc\t32\n");
-    fprintf(output, "\t.seh_endprologue\n");
-    fprintf(output, "\tleaq\t.LC0(%%rip), %%rcx\n");
-    fprintf(output, "\tcall\tprintf\n");
-    fprintf(output, "\tmovl\t$1, %%ecx\n");
-    fprintf(output, "\tcall\texit\n");
-    fprintf(output, "\tnop\n");
-    fprintf(output, "\t.seh_endproc\n");
-    fprintf(output, "\n");
-
-    // 全局函数声明
-    fprintf(output, "\t.globl\tmain\n");
-    fprintf(output, "\t.def\t__main;\t.scl\t2;\t.type\t32;\t.endef\n");
-    fprintf(output, "\t.def\tprintf;\t.scl\t2;\t.type\t32;\t.endef\n");
-    fprintf(output, "\t.def\texit;\t.scl\t2;\t.type\t32;\t.endef\n");
-
-    // main函数开始
-    fprintf(output, "\t.seh_proc\tmain\n");
-    fprintf(output, "main:\n");
-    fprintf(output, "\tpushq\t%%rbp\n");
-    fprintf(output, "\tmovq\t%%rsp, %%rbp\n");
-    fprintf(output, "\tsubq\t$96, %%rsp\n");
-    fprintf(output, "\tcall\t__main\n");
-
-    ast_generate_assembly(node, output);
-
-    fprintf(output, "\tmovl\t$0, %%eax\n");
-    fprintf(output, "\taddq\t$96, %%rsp\n");
-    fprintf(output, "\tpopq\t%%rbp\n");
-    fprintf(output, "\tret\n");
-    fprintf(output, "\t.seh_endproc\n");
+void ast_set_vectorize(bool enabled)
+{
+    vectorize = enabled;
+}
 
-    fclose(output);
+int ast_vectorized_loops(void)
+{
+    return vectorized_loops;
 }
 
-void ast_generate_assembly(ASTNode *node, FILE *output)
+void ast_set_unroll(bool enabled)
 {
-    if (!node)
-        return;
+    unroll = enabled;
+}
 
-    switch (node->type)
-    {
-    case AST_INTEGER:
-        fprintf(output, "\tmovl\t$%d, %%eax\n", node->int_value);
-        break;
+void ast_set_unroll_factor(int factor)
+{
+    unroll_factor = factor;
+}
 
-    case AST_FLOAT:
-        fprintf(output, "\t.section .rdata\n");
-        fprintf(output, ".LF%d:\n", float_label);
-        fprintf(output, "\t.float\t%f\n", node->float_value);
-        fprintf(output, "\t.section .text\n");
-        fprintf(output, "\tmovss\t.LF%d(%%rip), %%xmm0\n", float_label);
-        float_label++;
-        break;
+int ast_unrolled_loops(void)
+{
+    return unrolled_loops;
+}
 
-    case AST_STRING:
-        fprintf(output, "\t.section .rdata\n");
-        fprintf(output, ".LS%d:\n", string_label);
-        fprintf(output, "\t.ascii\t\"");
-        for (int i = 0; node->string_value[i]; i++)
-        {
-            switch (node->string_value[i])
-            {
-            case '\n':
-                fprintf(output, "\\12");
-                break;
-            case '\t':
-                fprintf(output, "\\11");
-                break;
-            case '\r':
-                fprintf(output, "\\15");
-                break;
-            case '\\':
-                fprintf(output, "\\\\");
-                break;
-            case '\"':
-                fprintf(output, "\\\"");
-                break;
-            default:
-                if (isprint(node->string_value[i]))
-                {
-                    fputc(node->string_value[i], output);
-                }
-                break;
-            }
-        }
-        fprintf(output, "\\0\"\n");
-        fprintf(output, "\t.section .text\n");
-        fprintf(output, "\tleaq\t.LS%d(%%rip), %%rax\n", string_label);
-        string_label++;
-        break;
+void ast_set_jobs(int jobs)
+{
+    codegen_jobs = jobs;
+}
 
-    case AST_VARIABLE:
+static FunctionInfo *find_function(const char *name)
+{
+    for (int i = 0; i < function_count; i++)
     {
-        int var_offset = get_variable_offset(node->string_value);
-        if (var_offset == -1)
+        if (strcmp(functions[i].name, name) == 0)
         {
-            fprintf(stderr, "Error: Undefined variable '%s'\n", node->string_value);
-            exit(1);
+            return &functions[i];
         }
-        fprintf(output, "\tmovl\t-%d(%%rbp), %%eax\n", var_offset);
     }
-    break;
-    case AST_FORMATTED_PRINT:
-    {
-        int format_label = string_label++;
-
-        fprintf(output, "\t.section .rdata,\"dr\"\n");
-        fprintf(output, ".LS%d:\n", format_label);
-        fprintf(output, "\t.ascii \"");
-
-        // 格式字符串处理
-        for (int i = 0; node->formatted_print.format_string[i]; i++)
-        {
-            char c = node->formatted_print.format_string[i];
-            if (c == '\n')
-                fprintf(output, "\\\\n");
-            else if (c == '\t')
-                fprintf(output, "\\\\t");
-            else if (c == '\r')
-                fprintf(output, "\\\\r");
-            else if (c == '\\')
-                fprintf(output, "\\\\\\\\");
-            else if (c == '\"')
-                fprintf(output, "\\\\\"");
-            else if (c == '%')
-                fprintf(output, "%%%%");
-            else if (isprint(c))
-                fputc(c, output);
-        }
-        fprintf(output, "\\\\0\"\n");
-        fprintf(output, "\t.section .text\n");
-
-        // Windows x64调用约定：计算需要的栈空间
-        int total_args = node->formatted_print.arg_count;
-        int stack_args = (total_args > 4) ? (total_args - 4) : 0;
-        int shadow_space = 32; // 前4个参数的shadow space
-        int stack_space = shadow_space + (stack_args * 8);
-
-        // 确保16字节对齐
-        stack_space = (stack_space + 15) & ~15;
-
-        // 分配栈空间
-        fprintf(output, "\tsubq\t$%d, %%rsp\n", stack_space);
-
-        // 处理所有参数
-        for (int i = 0; i < total_args; i++)
-        {
-            ast_generate_assembly(node->formatted_print.args[i], output);
-
-            // 根据参数位置选择寄存器或栈位置
-            switch (i)
-            {
-            case 0: // 第一个参数：格式字符串 -> RCX
-                fprintf(output, "\tmovq\t%%rax, %%rcx\n");
-                break;
-            case 1: // 第二个参数 -> RDX
-                fprintf(output, "\tmovl\t%%eax, %%edx\n");
-                break;
-            case 2: // 第三个参数 -> R8
-                fprintf(output, "\tmovl\t%%eax, %%r8d\n");
-                break;
-            case 3: // 第四个参数 -> R9
-                fprintf(output, "\tmovl\t%%eax, %%r9d\n");
-                break;
-            default: // 其他参数放在栈上
-                // 栈参数从shadow space之后开始（32字节偏移）
-                int stack_offset = 32 + (i - 4) * 8;
-                fprintf(output, "\tmovl\t%%eax, %d(%%rsp)\n", stack_offset);
-                break;
-            }
-        }
-
-        // 对于可变参数函数，设置AL=使用的XMM寄存器数量（这里设为0）
-        fprintf(output, "\txor\t%%al, %%al\n");
-
-        // 调用printf
-        fprintf(output, "\tcall\tprintf\n");
+    return NULL;
+}
 
-        // 恢复栈指针
-        fprintf(output, "\taddq\t$%d, %%rsp\n", stack_space);
+static void add_function(ASTNode *def)
+{
+    if (find_function(def->func_def.func_name))
+    {
+        fprintf(stderr, "Error: Function '%s' is defined more than once\n", def->func_def.func_name);
+        exit(1);
     }
-    break;
-
-    case AST_FUNCTION_CALL:
+    if (function_count >= function_capacity)
     {
-        // Windows x64调用约定
-        int total_args = node->func_call.arg_count;
-        int stack_args = (total_args > 4) ? (total_args - 4) : 0;
-        int shadow_space = 32;
-        int stack_space = shadow_space + (stack_args * 8);
-        stack_space = (stack_space + 15) & ~15; // 16字节对齐
+        function_capacity = function_capacity == 0 ? 8 : function_capacity * 2;
+        functions = realloc(functions, function_capacity * sizeof(FunctionInfo));
+    }
+    FunctionInfo *info = &functions[function_count++];
+    info->name = def->func_def.func_name;
+    info->symbol = mir_intern(module, "ml_fn_%s", info->name);
+    info->def = def;
+    info->return_type = get_type_from_string(def->func_def.return_type) == TYPE_FLOAT ? TYPE_FLOAT : TYPE_INT;
+}
 
-        fprintf(output, "\tsubq\t$%d, %%rsp\n", stack_space);
+static void collect_functions(ASTNode *node)
+{
+    if (!node)
+        return;
 
-        // 处理参数
-        for (int i = 0; i < total_args; i++)
+    switch (node->type)
+    {
+    case AST_FUNCTION_DEF:
+        add_function(node);
+        collect_functions(node->func_def.body);
+        break;
+    case AST_BLOCK:
+        for (int i = 0; i < node->block.count; i++)
         {
-            ast_generate_assembly(node->func_call.args[i], output);
-
-            switch (i)
-            {
-            case 0:
-                fprintf(output, "\tmov\t%%eax, %%ecx\n");
-                break;
-            case 1:
-                fprintf(output, "\tmov\t%%eax, %%edx\n");
-                break;
-            case 2:
-                fprintf(output, "\tmov\t%%eax, %%r8d\n");
-                break;
-            case 3:
-                fprintf(output, "\tmov\t%%eax, %%r9d\n");
-                break;
-            default:
-                fprintf(output, "\tmov\t%%eax, %d(%%rsp)\n",
-                        32 + (i - 4) * 8);
-                break;
-            }
+            collect_functions(node->block.statements[i]);
         }
-
-        // 设置AL=0（没有向量参数）
-        fprintf(output, "\txor\t%%al, %%al\n");
-
-        fprintf(output, "\tcall\t%s\n", node->func_call.func_name);
-        fprintf(output, "\taddq\t$%d, %%rsp\n", stack_space);
+        break;
+    case AST_IF:
+        collect_functions(node->if_stmt.then_body);
+        collect_functions(node->if_stmt.else_body);
+        break;
+    case AST_WHILE:
+        collect_functions(node->while_loop.body);
+        break;
+    case AST_FOR:
+        collect_functions(node->for_loop.body);
+        break;
+    default:
         break;
     }
+}
 
-    case AST_ARRAY_DECLARATION:
-    {
-        // 获取数组大小，如果没有指定则使用默认大小12
-        int array_size = 12; // 默认大小
-        if (node->array_decl.size)
-        {
-            ast_generate_assembly(node->array_decl.size, output);
-            fprintf(output, "\tmovl\t%%eax, -%d(%%rbp)\n", stack_offset);
-            fprintf(output, "\tmovl\t-%d(%%rbp), %%eax\n", stack_offset);
-            array_size = node->array_decl.size->int_value;
-        }
+static void clear_functions()
+{
+    free(functions);
+    functions = NULL;
+    function_count = 0;
+    function_capacity = 0;
+}
 
-        // 计算需要的总字节数（每个元素4字节）
-        int total_bytes = array_size * 4;
+static MirOperand reg32(MirReg reg)
+{
+    return mir_reg(reg, 4);
+}
 
-        // 确保栈对齐
-        total_bytes = (total_bytes + 15) & ~15;
+static MirOperand reg64(MirReg reg)
+{
+    return mir_reg(reg, 8);
+}
 
-        // 分配栈空间
-        fprintf(output, "\tsubq\t$%d, %%rsp\n", total_bytes);
+static void emit1(MirOpcode op, int size, MirOperand a)
+{
+    mir_emit1(cg->fn, op, size, a);
+}
 
-        // 添加变量到符号表
-        int var_offset = add_variable(node->array_decl.var_name);
+static void emit2(MirOpcode op, int size, MirOperand src, MirOperand dst)
+{
+    mir_emit2(cg->fn, op, size, src, dst);
+}
 
-        // 初始化数组为0
-        fprintf(output, "\tmovq\t$0, %%rax\n");
-        fprintf(output, "\tmovq\t$%d, %%rcx\n", (total_bytes + 7) / 8); // 按8字节块计算循环次数
-        fprintf(output, "\tleaq\t-%d(%%rbp), %%rdi\n", var_offset);
-        fprintf(output, ".Linit_array_%d:\n", array_label);
-        fprintf(output, "\tmovq\t%%rax, (%%rdi)\n");
-        fprintf(output, "\taddq\t$8, %%rdi\n");
-        fprintf(output, "\tloop\t.Linit_array_%d\n", array_label);
-        array_label++;
+static const char *new_label(const char *prefix, int label)
+{
+    return mir_intern(cg->module, ".L%s%d_%d", prefix, cg->id, label);
+}
 
-        // 保存数组大小信息
-        fprintf(output, "\tmovl\t$%d, -%d(%%rbp)\n", array_size, stack_offset);
-        stack_offset += 4;
-        break;
+// 标量变量作为指令操作数（虚拟寄存器）
+static MirOperand variable_operand(const char *name)
+{
+    Variable *var = find_variable(name);
+    if (var == NULL)
+    {
+        fprintf(stderr, "Error: Undefined variable '%s'\n", name);
+        exit(1);
     }
+    if (is_array(var))
+        return mir_mem(REG_RBP, -var->offset);
+    return mir_vreg(var->vreg);
+}
 
+static bool comparison_cond(const char *op, MirCond *cond);
+
+// 表达式的静态类型：TYPE_INT、TYPE_FLOAT 或 TYPE_STRING。
+// 浮点值和整数一样在 %eax 中传递（float 的位模式），运算时经 movd 装入 %xmm0/%xmm1
+static int expr_type(ASTNode *node)
+{
+    switch (node->type)
+    {
+    case AST_FLOAT:
+        return TYPE_FLOAT;
+    case AST_STRING:
+        return TYPE_STRING;
+    case AST_VARIABLE:
+    {
+        Variable *var = find_variable(node->string_value);
+        return var != NULL && !is_array(var) ? var->type : TYPE_INT;
+    }
     case AST_ARRAY_ACCESS:
     {
-        int var_offset = get_variable_offset(node->array_access.var_name);
-        if (var_offset == -1)
-        {
-            fprintf(stderr, "Error: Undefined array '%s'\n", node->array_access.var_name);
-            exit(1);
-        }
-
-        // 生成索引值的汇编代码
-        ast_generate_assembly(node->array_access.index, output);
-        fprintf(output, "\tmovl\t%%eax, %%ecx\n");
-
-        // 保存索引值
-        fprintf(output, "\tpushq\t%%rcx\n");
-
-        // 获取数组大小
-        fprintf(output, "\tmovl\t-%d(%%rbp), %%edx\n", stack_offset - 4);
-
-        // 恢复索引值
-        fprintf(output, "\tpopq\t%%rcx\n");
-
-        // 边界检查
-        fprintf(output, "\tcmpl\t$0, %%ecx\n");
-        fprintf(output, "\tjl\tarray_bounds_error\n");
-        fprintf(output, "\tcmpl\t%%edx, %%ecx\n");
-        fprintf(output, "\tjge\tarray_bounds_error\n");
-
-        // 访问数组元素
-        fprintf(output, "\tmovl\t-%d(%%rbp,%%rcx,4), %%eax\n", var_offset);
-        break;
+        Variable *var = find_variable(node->array_access.var_name);
+        return var != NULL && var->type == TYPE_FLOAT_ARRAY ? TYPE_FLOAT : TYPE_INT;
+    }
+    case AST_ASSIGNMENT:
+        return expr_type(node->binary.left);
+    case AST_BINARY_OP:
+    {
+        MirCond cond;
+        const char *op = node->binary.op;
+        if (comparison_cond(op, &cond) || strcmp(op, "&&") == 0 || strcmp(op, "||") == 0 || strcmp(op, "%") == 0)
+            return TYPE_INT;
+        // 与解释器和 C 后端一致，除法的结果总是浮点数
+        if (strcmp(op, "/") == 0)
+            return TYPE_FLOAT;
+        if (expr_type(node->binary.left) == TYPE_FLOAT || expr_type(node->binary.right) == TYPE_FLOAT)
+            return TYPE_FLOAT;
+        return TYPE_INT;
+    }
+    case AST_FUNCTION_CALL:
+    {
+        FunctionInfo *callee = find_function(node->func_call.func_name);
+        return callee != NULL ? callee->return_type : TYPE_INT;
     }
+    default:
+        return TYPE_INT;
+    }
+}
 
-    case AST_ARRAY_ASSIGNMENT:
+// %eax 中的值在 int 与 float 之间转换（float → int 向零截断）
+static void convert_value(int from, int to)
+{
+    if (from == TYPE_INT && to == TYPE_FLOAT)
     {
-        char *array_name = node->array_assignment.array_access->array_access.var_name;
-        int var_offset = get_variable_offset(array_name);
-        if (var_offset == -1)
-        {
-            fprintf(stderr, "Error: Undefined array '%s'\n", array_name);
-            exit(1);
-        }
+        emit2(MIR_CVTSI2SS, 4, reg32(REG_RAX), mir_xmm(0));
+        emit2(MIR_MOVD, 4, mir_xmm(0), reg32(REG_RAX));
+    }
+    else if (from == TYPE_FLOAT && to == TYPE_INT)
+    {
+        emit2(MIR_MOVD, 4, reg32(REG_RAX), mir_xmm(0));
+        emit2(MIR_CVTTSS2SI, 4, mir_xmm(0), reg32(REG_RAX));
+    }
+}
 
-        // 生成要赋值的表达式的汇编代码
-        ast_generate_assembly(node->array_assignment.value, output);
-        fprintf(output, "\tmovl\t%%eax, %%edx\n");
+// 求值到 %eax 并转换为 type（字符串不转换）
+static bool generate_truncated_division(ASTNode *node);
 
-        // 生成索引值的汇编代码
-        ast_generate_assembly(node->array_assignment.array_access->array_access.index, output);
-        fprintf(output, "\tmovl\t%%eax, %%ecx\n");
+static void generate_value(ASTNode *node, int type)
+{
+    if (type == TYPE_INT && generate_truncated_division(node))
+        return;
+    ast_generate_assembly(node, cg->fn);
+    convert_value(expr_type(node), type);
+}
 
-        // 保存索引值
-        fprintf(output, "\tpushq\t%%rcx\n");
+static void emit_push(MirReg reg)
+{
+    emit1(MIR_PUSH, 8, reg64(reg));
+    cg->push_depth += 8;
+}
 
-        // 获取数组大小
-        fprintf(output, "\tmovl\t-%d(%%rbp), %%eax\n", stack_offset - 4);
+static void emit_pop(MirReg reg)
+{
+    emit1(MIR_POP, 8, reg64(reg));
+    cg->push_depth -= 8;
+}
 
-        // 恢复索引值
-        fprintf(output, "\tpopq\t%%rcx\n");
+// 保存 %eax 中的中间结果：优先放入临时寄存器，临时寄存器用完才压栈
+static void save_temp()
+{
+    if (cg->temp_depth < mir_target->temp_reg_count)
+        emit2(MIR_MOV, 4, reg32(REG_RAX), reg32(mir_target->temp_regs[cg->temp_depth]));
+    else
+        emit_push(REG_RAX);
+    cg->temp_depth++;
+}
 
-        // 边界检查
-        fprintf(output, "\tcmpl\t$0, %%ecx\n");
-        fprintf(output, "\tjl\tarray_bounds_error\n");
-        fprintf(output, "\tcmpl\t%%eax, %%ecx\n");
-        fprintf(output, "\tjge\tarray_bounds_error\n");
+// 取回最近保存的中间结果到 %eax
+static void restore_temp()
+{
+    cg->temp_depth--;
+    if (cg->temp_depth < mir_target->temp_reg_count)
+        emit2(MIR_MOV, 4, reg32(mir_target->temp_regs[cg->temp_depth]), reg32(REG_RAX));
+    else
+        emit_pop(REG_RAX);
+}
 
-        // 赋值到数组元素
-        fprintf(output, "\tmovl\t%%edx, -%d(%%rbp,%%rcx,4)\n", var_offset);
-        break;
+// 调用会破坏调用者保存寄存器，调用前把仍在临时寄存器中的中间结果压栈
+static int save_live_temps()
+{
+    int live = cg->temp_depth < mir_target->temp_reg_count ? cg->temp_depth : mir_target->temp_reg_count;
+    for (int i = 0; i < live; i++)
+    {
+        emit_push(mir_target->temp_regs[i]);
     }
+    return live;
+}
 
-    case AST_BINARY_OP:
-        ast_generate_assembly(node->binary.left, output);
-        fprintf(output, "\tpushq\t%%rax\n");
-        ast_generate_assembly(node->binary.right, output);
-        fprintf(output, "\tmovl\t%%eax, %%ecx\n");
-        fprintf(output, "\tpopq\t%%rdx\n");
+static void restore_live_temps(int live)
+{
+    for (int i = live - 1; i >= 0; i--)
+    {
+        emit_pop(mir_target->temp_regs[i]);
+    }
+}
 
-        if (strcmp(node->binary.op, "+") == 0)
-        {
-            fprintf(output, "\taddl\t%%edx, %%eax\n");
-        }
-        else if (strcmp(node->binary.op, "-") == 0)
-        {
-            fprintf(output, "\tsubl\t%%edx, %%eax\n");
-        }
-        else if (strcmp(node->binary.op, "*") == 0)
-        {
-            fprintf(output, "\timull\t%%edx, %%eax\n");
-        }
-        else if (strcmp(node->binary.op, "/") == 0)
-        {
-            fprintf(output, "\tcltd\n");
-            fprintf(output, "\tidivl\t%%ecx\n");
-        }
-        else if (strcmp(node->binary.op, "<") == 0)
+// 可直接作为指令源操作数的表达式（立即数或标量变量）
+static bool simple_operand(ASTNode *node, MirOperand *operand)
+{
+    if (node->type == AST_INTEGER)
+    {
+        *operand = mir_imm(node->int_value);
+        return true;
+    }
+    if (node->type == AST_VARIABLE)
+    {
+        Variable *var = find_variable(node->string_value);
+        if (var != NULL && !is_array(var))
         {
-            fprintf(output, "\tcmpl\t%%ecx, %%edx\n");
-            fprintf(output, "\tsetl\t%%al\n");
-            fprintf(output, "\tmovzbl\t%%al, %%eax\n");
+            *operand = mir_vreg(var->vreg);
+            return true;
         }
-        else if (strcmp(node->binary.op, "<=") == 0)
+    }
+    return false;
+}
+
+// 字符串字面量放入只读数据的常量池，返回其标签；相同的字符串只保存一次
+static const char *emit_string_literal(const char *str)
+{
+    const char *label = mir_rodata_find_string(cg->module, str);
+    if (label)
+        return label;
+    label = mir_intern(cg->module, ".LS%d_%d", cg->id, cg->string_label++);
+    mir_rodata_string(cg->module, label, str);
+    return label;
+}
+
+// 浮点常量放入只读数据的常量池，返回其标签；位模式相同的常量只保存一次
+static const char *emit_float_literal(float value)
+{
+    const char *label = mir_rodata_find_float(cg->module, value);
+    if (label)
+        return label;
+    label = mir_intern(cg->module, ".LF%d_%d", cg->id, cg->float_label++);
+    mir_rodata_float(cg->module, label, value);
+    return label;
+}
+
+// 实参的位置：整数寄存器、%xmm 寄存器和栈参数的编号，-1 表示不用
+typedef struct
+{
+    int gpr;
+    int xmm;
+    int stack;
+} ArgSlot;
+
+// System V 的整数和浮点实参各自依次占用寄存器；Win64 按位置占用 arg_regs[i] 或 %xmm<i>，
+// 可变参数函数的浮点实参同时放入整数寄存器。返回栈参数个数
+static int classify_args(const int *types, int count, bool variadic, ArgSlot *slots)
+{
+    int gpr = 0, xmm = 0, stack = 0;
+    for (int i = 0; i < count; i++)
+    {
+        ArgSlot *slot = &slots[i];
+        bool is_float = types[i] == TYPE_FLOAT;
+        slot->gpr = -1;
+        slot->xmm = -1;
+        slot->stack = -1;
+        if (mir_target->windows)
+        {
+            if (i >= mir_target->arg_reg_count)
+            {
+                slot->stack = stack++;
+                continue;
+            }
+            if (is_float)
+                slot->xmm = i;
+            if (!is_float || variadic)
+                slot->gpr = i;
+        }
+        else if (is_float && xmm < mir_target->float_arg_reg_count)
+        {
+            slot->xmm = xmm++;
+        }
+        else if (!is_float && gpr < mir_target->arg_reg_count)
+        {
+            slot->gpr = gpr++;
+        }
+        else
+        {
+            slot->stack = stack++;
+        }
+    }
+    return stack;
+}
+
+// 为一次调用分配出参区（影子空间 + 栈参数），保证 call 时 %rsp 16字节对齐，返回出参区大小
+static int reserve_call_area(int stack_args)
+{
+    int area = mir_target->shadow_space + stack_args * 8;
+    area += (16 - (cg->push_depth + area) % 16) % 16;
+    if (area > 0)
+        emit2(MIR_SUB, 8, mir_imm(area), reg64(REG_RSP));
+    return area;
+}
+
+// 实参都是整数或指针时的出参区
+static int begin_call(int arg_count)
+{
+    return reserve_call_area(arg_count > mir_target->arg_reg_count ? arg_count - mir_target->arg_reg_count : 0);
+}
+
+static void end_call(int release)
+{
+    if (release > 0)
+        emit2(MIR_ADD, 8, mir_imm(release), reg64(REG_RSP));
+}
+
+// 第 slot 个栈参数在出参区中的位置
+static MirOperand stack_slot(int slot)
+{
+    return mir_mem(REG_RSP, mir_target->shadow_space + slot * 8);
+}
+
+// 全是整数实参时，第 index 个实参（index >= 参数寄存器数）的栈参数位置
+static MirOperand stack_arg(int index)
+{
+    return stack_slot(index - mir_target->arg_reg_count);
+}
+
+static void emit_arg_imm(int index, int value)
+{
+    if (index < mir_target->arg_reg_count)
+        emit2(MIR_MOV, 4, mir_imm(value), reg32(mir_target->arg_regs[index]));
+    else
+        emit2(MIR_MOV, 8, mir_imm(value), stack_arg(index));
+}
+
+static void emit_arg_address(int index, int rbp_offset)
+{
+    if (index < mir_target->arg_reg_count)
+    {
+        emit2(MIR_LEA, 8, mir_mem(REG_RBP, -rbp_offset), reg64(mir_target->arg_regs[index]));
+    }
+    else
+    {
+        emit2(MIR_LEA, 8, mir_mem(REG_RBP, -rbp_offset), reg64(REG_RAX));
+        emit2(MIR_MOV, 8, reg64(REG_RAX), stack_arg(index));
+    }
+}
+
+// 数组元素的地址作为实参
+static void emit_arg_array(int index, Variable *var)
+{
+    if (!var->heap)
+    {
+        emit_arg_address(index, var->offset);
+        return;
+    }
+    MirOperand pointer = mir_mem(REG_RBP, -var->offset);
+    if (index < mir_target->arg_reg_count)
+    {
+        emit2(MIR_MOV, 8, pointer, reg64(mir_target->arg_regs[index]));
+    }
+    else
+    {
+        emit2(MIR_MOV, 8, pointer, reg64(REG_RAX));
+        emit2(MIR_MOV, 8, reg64(REG_RAX), stack_arg(index));
+    }
+}
+
+// 字符串字面量的地址作为实参
+static void emit_arg_string(int index, const char *str)
+{
+    MirOperand address = mir_rip(emit_string_literal(str));
+    if (index < mir_target->arg_reg_count)
+    {
+        emit2(MIR_LEA, 8, address, reg64(mir_target->arg_regs[index]));
+    }
+    else
+    {
+        emit2(MIR_LEA, 8, address, reg64(REG_RAX));
+        emit2(MIR_MOV, 8, reg64(REG_RAX), stack_arg(index));
+    }
+}
+
+// 数组的元素个数作为实参
+static void emit_arg_length(int index, Variable *var)
+{
+    if (var->length_vreg < 0)
+    {
+        emit_arg_imm(index, var->array_size);
+    }
+    else if (index < mir_target->arg_reg_count)
+    {
+        emit2(MIR_MOV, 4, mir_vreg(var->length_vreg), reg32(mir_target->arg_regs[index]));
+    }
+    else
+    {
+        emit2(MIR_MOV, 4, mir_vreg(var->length_vreg), reg32(REG_RAX));
+        emit2(MIR_MOV, 8, reg64(REG_RAX), stack_arg(index));
+    }
+}
+
+// 调用外部（libc/运行时库）函数；可变参数函数需在 %al 中给出使用的向量寄存器数
+static void emit_call_extern(const char *callee, bool variadic, int vector_args)
+{
+    if (variadic && vector_args == 0)
+        emit2(MIR_XOR, 4, reg32(REG_RAX), reg32(REG_RAX));
+    else if (variadic)
+        emit2(MIR_MOV, 4, mir_imm(vector_args), reg32(REG_RAX));
+    emit1(MIR_CALL, 8, mir_label(mir_intern(cg->module, "%s%s", callee, mir_target->extern_suffix)));
+}
+
+static void emit_call(const char *callee, bool external, bool variadic, int vector_args)
+{
+    if (external)
+    {
+        emit_call_extern(callee, variadic, vector_args);
+    }
+    else
+    {
+        emit1(MIR_CALL, 8, mir_label(callee));
+    }
+}
+
+// 实参都是整数常量、字符串字面量或整数标量变量时可以直接装入参数位置，不经过栈
+static bool direct_arguments(ASTNode **args, const int *types, int arg_count)
+{
+    MirOperand operand;
+    for (int i = 0; i < arg_count; i++)
+    {
+        if (types[i] == TYPE_FLOAT || expr_type(args[i]) == TYPE_FLOAT)
+            return false;
+        if (args[i]->type != AST_STRING && !simple_operand(args[i], &operand))
+            return false;
+    }
+    return true;
+}
+
+static void emit_direct_argument(int index, ASTNode *arg)
+{
+    MirOperand operand;
+    bool in_reg = index < mir_target->arg_reg_count;
+    MirReg dst = in_reg ? mir_target->arg_regs[index] : REG_RAX;
+    if (arg->type == AST_STRING)
+    {
+        emit2(MIR_LEA, 8, mir_rip(emit_string_literal(arg->string_value)), reg64(dst));
+    }
+    else if (arg->type == AST_INTEGER && !in_reg)
+    {
+        emit_arg_imm(index, arg->int_value);
+        return;
+    }
+    else
+    {
+        simple_operand(arg, &operand);
+        emit2(MIR_MOV, 4, operand, reg32(dst));
+    }
+    if (!in_reg)
+        emit2(MIR_MOV, 8, reg64(REG_RAX), stack_arg(index));
+}
+
+// 通用调用：实参依次求值、按 types 转换后压栈（嵌套调用不会破坏已装入的参数寄存器），
+// 再从栈上装入参数寄存器或复制到栈参数区；可变参数函数的浮点实参按 double 传递。结果在 %eax
+static void generate_call(const char *callee, ASTNode **args, const int *types, int arg_count, bool external,
+                          bool variadic)
+{
+    int live = save_live_temps();
+    ArgSlot *slots = malloc((arg_count + 1) * sizeof(ArgSlot));
+    int stack_args = classify_args(types, arg_count, variadic, slots);
+    int vector_args = 0;
+    for (int i = 0; i < arg_count; i++)
+    {
+        if (slots[i].xmm >= 0)
+            vector_args++;
+    }
+
+    if (direct_arguments(args, types, arg_count))
+    {
+        int area = begin_call(arg_count);
+        for (int i = 0; i < arg_count; i++)
+        {
+            emit_direct_argument(i, args[i]);
+        }
+        emit_call(callee, external, variadic, 0);
+        end_call(area);
+        restore_live_temps(live);
+        free(slots);
+        return;
+    }
+
+    for (int i = 0; i < arg_count; i++)
+    {
+        generate_value(args[i], types[i]);
+        if (types[i] == TYPE_FLOAT && variadic)
+        {
+            emit2(MIR_MOVD, 4, reg32(REG_RAX), mir_xmm(0));
+            emit2(MIR_CVTSS2SD, 4, mir_xmm(0), mir_xmm(0));
+            emit2(MIR_MOVD, 8, mir_xmm(0), reg64(REG_RAX));
+        }
+        emit_push(REG_RAX);
+    }
+
+    int area = reserve_call_area(stack_args);
+    // 第 i 个实参压栈后位于 area + (arg_count - 1 - i) * 8 (%rsp)
+    for (int i = arg_count - 1; i >= 0; i--)
+    {
+        MirOperand src = mir_mem(REG_RSP, area + (arg_count - 1 - i) * 8);
+        if (slots[i].gpr >= 0)
+            emit2(MIR_MOV, 8, src, reg64(mir_target->arg_regs[slots[i].gpr]));
+        if (slots[i].xmm >= 0)
+            emit2(MIR_MOVD, 8, src, mir_xmm(slots[i].xmm));
+        if (slots[i].stack >= 0)
+        {
+            emit2(MIR_MOV, 8, src, reg64(REG_RAX));
+            emit2(MIR_MOV, 8, reg64(REG_RAX), stack_slot(slots[i].stack));
+        }
+    }
+
+    emit_call(callee, external, variadic, vector_args);
+    end_call(area + arg_count * 8);
+    cg->push_depth -= arg_count * 8;
+    restore_live_temps(live);
+    free(slots);
+}
+
+// printf 实参的传递类型：%d/%i 按 int、%f/%e/%g 按浮点，与解释器一样必要时转换，
+// 其他实参按自身类型；types[0] 为格式串。跳过标志、宽度和精度，%% 不消耗实参
+static void printf_arg_types(ASTNode **args, int arg_count, int *types)
+{
+    for (int i = 0; i < arg_count; i++)
+    {
+        types[i] = expr_type(args[i]);
+    }
+    if (arg_count == 0 || args[0]->type != AST_STRING)
+        return;
+
+    const char *format = args[0]->string_value;
+    int arg = 1;
+    for (const char *p = format; *p && arg < arg_count; p++)
+    {
+        if (*p != '%')
+            continue;
+        p++;
+        while (*p && strchr("-+ #0123456789.", *p))
+        {
+            p++;
+        }
+        if (*p == '\0')
+            break;
+        if (*p == '%')
+            continue;
+        if (types[arg] != TYPE_STRING)
+        {
+            if (strchr("dic", *p))
+                types[arg] = TYPE_INT;
+            else if (strchr("feEgG", *p))
+                types[arg] = TYPE_FLOAT;
+        }
+        arg++;
+    }
+}
+
+// printf 交给运行时库的 ml_printf，写入同一个输出缓冲区
+static void generate_printf(ASTNode **args, int arg_count)
+{
+    int *types = malloc((arg_count + 1) * sizeof(int));
+    printf_arg_types(args, arg_count, types);
+    generate_call("ml_printf", args, types, arg_count, true, true);
+    free(types);
+}
+
+static bool is_print_leaf(const ASTNode *node)
+{
+    return node->type == AST_INTEGER || node->type == AST_FLOAT || node->type == AST_STRING ||
+           node->type == AST_VARIABLE;
+}
+
+static void emit_print_text(const char *text)
+{
+    ASTNode node;
+    memset(&node, 0, sizeof(node));
+    node.type = AST_STRING;
+    node.string_value = (char *)text;
+    ASTNode *args[1] = {&node};
+    int types[1] = {TYPE_STRING};
+    generate_call("ml_print_str", args, types, 1, true, false);
+}
+
+// print 语句按格式串拆成 ml_print_str/ml_print_int/ml_print_float 调用，运行时不再解析格式。
+// 只处理不带标志和宽度的 %d/%i/%f/%s/%%，且实参个数与类型都与格式一致；printf 先求值全部实参再输出，
+// 所以前面已有输出时实参只能是常量或变量（没有副作用，也不会出错）。不能拆分时返回 false
+static bool generate_print_segments(ASTNode **args, int arg_count, const int *types)
+{
+    if (arg_count == 0 || args[0]->type != AST_STRING)
+        return false;
+
+    // 第一遍只检查，不生成代码
+    const char *format = args[0]->string_value;
+    int arg = 1;
+    bool output_before = false;
+    for (const char *p = format; *p; p++)
+    {
+        if (*p != '%')
+        {
+            output_before = true;
+            continue;
+        }
+        p++;
+        if (*p == '%')
+        {
+            output_before = true;
+            continue;
+        }
+        if (*p == '\0' || !strchr("difs", *p))
+            return false;
+        if (arg >= arg_count || (*p == 's') != (types[arg] == TYPE_STRING))
+            return false;
+        if (output_before && !is_print_leaf(args[arg]))
+            return false;
+        output_before = true;
+        arg++;
+    }
+    if (arg != arg_count)
+        return false;
+
+    char *text = malloc(strlen(format) + 1);
+    int length = 0;
+    arg = 1;
+    for (const char *p = format; *p; p++)
+    {
+        if (*p != '%' || p[1] == '%')
+        {
+            text[length++] = *p;
+            p += *p == '%';
+            continue;
+        }
+        if (length > 0)
+        {
+            text[length] = '\0';
+            emit_print_text(text);
+            length = 0;
+        }
+        p++;
+        const char *callee = *p == 's' ? "ml_print_str" : *p == 'f' ? "ml_print_float" : "ml_print_int";
+        generate_call(callee, &args[arg], &types[arg], 1, true, false);
+        arg++;
+    }
+    if (length > 0)
+    {
+        text[length] = '\0';
+        emit_print_text(text);
+    }
+    free(text);
+    return true;
+}
+
+static void generate_print(ASTNode **args, int arg_count)
+{
+    int *types = malloc((arg_count + 1) * sizeof(int));
+    printf_arg_types(args, arg_count, types);
+    if (!generate_print_segments(args, arg_count, types))
+        generate_call("ml_printf", args, types, arg_count, true, true);
+    free(types);
+}
+
+// 一个函数的栈帧中数组的总字节数上限，超过的数组和运行时确定大小的数组由运行时库在堆上分配；
+// 这样 Win64 的栈帧也不会超过一页，不需要栈探测
+#define FRAME_ARRAY_LIMIT 4096
+
+
+// 数组声明的常量大小：没有指定时为12，大小不是整数常量时返回0
+static int constant_array_size(ASTNode *decl)
+{
+    ASTNode *size = decl->array_decl.size;
+    if (size == NULL)
+        return 12;
+    if (size->type != AST_INTEGER)
+        return 0;
+    if (size->int_value <= 0)
+    {
+        fprintf(stderr, "Error: Array '%s' size must be positive\n", decl->array_decl.var_name);
+        exit(1);
+    }
+    return size->int_value;
+}
+
+static HeapArray *find_heap_array(ASTNode *decl)
+{
+    for (int i = 0; i < cg->heap_array_count; i++)
+    {
+        if (cg->heap_arrays[i].decl == decl)
+            return &cg->heap_arrays[i];
+    }
+    return NULL;
+}
+
+// 按出现顺序决定函数体中每个数组声明放在栈帧还是堆上（嵌套的函数定义单独处理）
+static void plan_arrays(ASTNode *node)
+{
+    if (node == NULL)
+        return;
+    switch (node->type)
+    {
+    case AST_BLOCK:
+        for (int i = 0; i < node->block.count; i++)
+        {
+            plan_arrays(node->block.statements[i]);
+        }
+        break;
+    case AST_IF:
+        plan_arrays(node->if_stmt.then_body);
+        plan_arrays(node->if_stmt.else_body);
+        break;
+    case AST_WHILE:
+        plan_arrays(node->while_loop.body);
+        break;
+    case AST_FOR:
+        plan_arrays(node->for_loop.init);
+        plan_arrays(node->for_loop.body);
+        break;
+    case AST_ARRAY_DECLARATION:
+    {
+        int size = constant_array_size(node);
+        int bytes = (size + 1) / 2 * 8;
+        if (size > 0 && cg->frame_array_bytes + bytes <= FRAME_ARRAY_LIMIT)
+        {
+            cg->frame_array_bytes += bytes;
+            break;
+        }
+        if (cg->heap_array_count >= cg->heap_array_capacity)
+        {
+            cg->heap_array_capacity = cg->heap_array_capacity == 0 ? 4 : cg->heap_array_capacity * 2;
+            cg->heap_arrays = realloc(cg->heap_arrays, cg->heap_array_capacity * sizeof(HeapArray));
+        }
+        cg->heap_arrays[cg->heap_array_count].decl = node;
+        cg->heap_arrays[cg->heap_array_count].offset = add_pointer_slot();
+        cg->heap_array_count++;
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// 生成函数体之前：规划数组并把堆数组的指针槽清零（声明可能不执行，返回时统一 free）
+static void begin_arrays(ASTNode *body)
+{
+    plan_arrays(body);
+    for (int i = 0; i < cg->heap_array_count; i++)
+    {
+        emit2(MIR_MOV, 8, mir_imm(0), mir_mem(REG_RBP, -cg->heap_arrays[i].offset));
+    }
+}
+
+// 开始生成一个函数：新建 MIR 函数并重置函数内状态
+static void begin_function(const char *name, bool global)
+{
+    cg->fn = mir_function_new(name, global);
+    clear_variables();
+    cg->push_depth = 0;
+    cg->temp_depth = 0;
+    cg->heap_array_count = 0;
+    cg->frame_array_bytes = 0;
+    cg->return_type = TYPE_INT;
+    cg->return_label = mir_intern(cg->module, ".Lreturn_%s", name);
+}
+
+// 结束函数：寄存器分配和窥孔优化，返回完成的 MIR 函数
+static MirFunction *finish_function()
+{
+    MirFunction *fn = cg->fn;
+    fn->frame_size = cg->stack_offset - 4;
+    mir_allocate_registers(fn);
+    mir_peephole(fn);
+    cg->fn = NULL;
+    return fn;
+}
+
+// 输出到模块的代码缓冲区；直接输出目标文件时编码为机器码
+static void emit_function(MirFunction *fn)
+{
+    if (object_code)
+    {
+        if (!x86_encode_function(object_code, fn))
+        {
+            fprintf(stderr, "Error: Function %s cannot be encoded directly, use -S instead\n", fn->name);
+            exit(1);
+        }
+    }
+    else
+    {
+        mir_emit_function(module, fn);
+    }
+    mir_function_free(fn);
+}
+
+// 没有执行 return 时返回0；释放堆上的数组（保留 %eax 中的返回值），float 返回值从 %eax 移入 %xmm0
+static void emit_return_sequence()
+{
+    emit2(MIR_MOV, 4, mir_imm(0), reg32(REG_RAX));
+    mir_emit_label(cg->fn, cg->return_label);
+    if (cg->heap_array_count > 0)
+    {
+        emit_push(REG_RAX);
+        for (int i = 0; i < cg->heap_array_count; i++)
+        {
+            int area = begin_call(1);
+            emit2(MIR_MOV, 8, mir_mem(REG_RBP, -cg->heap_arrays[i].offset), reg64(mir_target->arg_regs[0]));
+            emit_call_extern("ml_array_free", false, 0);
+            end_call(area);
+        }
+        emit_pop(REG_RAX);
+    }
+    if (cg->return_type == TYPE_FLOAT)
+        emit2(MIR_MOVD, 4, reg32(REG_RAX), mir_xmm(0));
+    mir_emit0(cg->fn, MIR_RET);
+}
+
+// 运行时错误处理：由检查直接跳转进入，先重新对齐栈，再调用运行时库报告错误（不返回）
+static void generate_error_handler(const char *name, const char *callee)
+{
+    begin_function(name, true);
+    emit2(MIR_AND, 8, mir_imm(-16), reg64(REG_RSP));
+    if (mir_target->shadow_space > 0)
+        emit2(MIR_SUB, 8, mir_imm(mir_target->shadow_space), reg64(REG_RSP));
+    emit_call_extern(callee, false, 0);
+    mir_emit0(cg->fn, MIR_NOP);
+    emit_function(finish_function());
+}
+
+// 用户函数：参数装入各自的虚拟寄存器（整数/浮点参数寄存器和调用者栈上的参数），
+// 返回值在 %eax（float 在 %xmm0）
+static MirFunction *generate_function(FunctionInfo *info)
+{
+    ASTNode *def = info->def;
+    int param_count = def->func_def.param_count;
+    int *types = malloc((param_count + 1) * sizeof(int));
+    ArgSlot *slots = malloc((param_count + 1) * sizeof(ArgSlot));
+
+    for (int i = 0; i < param_count; i++)
+    {
+        ASTNode *param = def->func_def.params[i];
+        types[i] = get_type_from_string(param->decl.var_type);
+        if (types[i] != TYPE_INT && types[i] != TYPE_FLOAT)
+        {
+            fprintf(stderr, "Error: Parameter '%s' of type %s is not supported by the assembly backend\n",
+                    param->decl.var_name, param->decl.var_type);
+            exit(1);
+        }
+    }
+    classify_args(types, param_count, false, slots);
+
+    begin_function(info->symbol, false);
+    cg->return_type = info->return_type;
+    for (int i = 0; i < param_count; i++)
+    {
+        Variable *var = add_variable(def->func_def.params[i]->decl.var_name, types[i]);
+        if (slots[i].xmm >= 0)
+        {
+            emit2(MIR_MOVD, 4, mir_xmm(slots[i].xmm), mir_vreg(var->vreg));
+        }
+        else if (slots[i].gpr >= 0)
+        {
+            emit2(MIR_MOV, 4, reg32(mir_target->arg_regs[slots[i].gpr]), mir_vreg(var->vreg));
+        }
+        else
+        {
+            // 调用者的影子空间之上依次是栈参数
+            int offset = mir_target->shadow_space + slots[i].stack * 8;
+            emit2(MIR_MOV, 4, mir_arg_slot(offset), reg32(REG_RAX));
+            emit2(MIR_MOV, 4, reg32(REG_RAX), mir_vreg(var->vreg));
+        }
+    }
+    free(types);
+    free(slots);
+
+    begin_arrays(def->func_def.body);
+    ast_generate_assembly(def->func_def.body, cg->fn);
+    emit_return_sequence();
+    return finish_function();
+}
+
+// JIT 入口：只生成给定的函数（调用的用户函数必须都在 defs 中），不输出汇编
+void ast_lower_functions(ASTNode **defs, int count, MirModule *mod, MirFunction **out)
+{
+    CodegenContext ctx;
+    context_init(&ctx, 0, mod);
+    cg = &ctx;
+    module = mod;
+    clear_functions();
+    for (int i = 0; i < count; i++)
+    {
+        add_function(defs[i]);
+    }
+    for (int i = 0; i < count; i++)
+    {
+        out[i] = generate_function(&functions[i]);
+    }
+    clear_functions();
+    context_free(&ctx);
+    cg = NULL;
+    module = NULL;
+}
+
+// 开始生成一个模块：重置窥孔统计
+static void begin_module(MirModule *mod)
+{
+    mir_module_init(mod);
+    module = mod;
+    mir_peephole_reset_stats();
+    vectorized_loops = 0;
+    unrolled_loops = 0;
+}
+
+static void end_module()
+{
+    clear_functions();
+    mir_module_free(module);
+    module = NULL;
+}
+
+// 与 gcc 输出一致，.file 为源文件名去掉扩展名再加 .c
+static const char *source_file_name(const char *filename)
+{
+    const char *basename = strrchr(filename, '/');
+    if (!basename)
+        basename = strrchr(filename, '\\');
+    basename = basename ? basename + 1 : filename;
+    const char *dot = strrchr(basename, '.');
+    int base_len = dot ? (int)(dot - basename) : (int)strlen(basename);
+    return mir_intern(module, "%.*s.c", base_len, basename);
+}
+
+// main 函数：顶层语句（函数定义单独生成）
+static MirFunction *generate_main(ASTNode *node)
+{
+    begin_function("main", true);
+    if (mir_target->windows)
+    {
+        // MinGW 运行时初始化
+        emit2(MIR_SUB, 8, mir_imm(32), reg64(REG_RSP));
+        emit1(MIR_CALL, 8, mir_label("__main"));
+        emit2(MIR_ADD, 8, mir_imm(32), reg64(REG_RSP));
+    }
+    begin_arrays(node);
+    ast_generate_assembly(node, cg->fn);
+    emit_return_sequence();
+    return finish_function();
+}
+
+// 并行生成的一个函数：info 为 NULL 时是 main。生成汇编时在线程中直接输出到自己的模块
+typedef struct
+{
+    FunctionInfo *info;
+    ASTNode *program;
+    bool emit_text;
+    MirModule module;
+    CodegenContext ctx;
+    MirFunction *fn; // 输出目标文件时留给主线程编码
+} CodegenJob;
+
+static void run_job(CodegenJob *job)
+{
+    cg = &job->ctx;
+    MirFunction *fn = job->info ? generate_function(job->info) : generate_main(job->program);
+    if (job->emit_text)
+    {
+        mir_emit_function(&job->module, fn);
+        mir_function_free(fn);
+        fn = NULL;
+    }
+    job->fn = fn;
+    cg = NULL;
+}
+
+// 线程数：-j 指定，否则为环境变量 MYLANG_JOBS 或处理器个数，不超过函数个数
+static int codegen_thread_count(int job_count)
+{
+    int threads = codegen_jobs;
+    const char *env = getenv("MYLANG_JOBS");
+    if (threads <= 0 && env != NULL)
+        threads = atoi(env);
+#ifndef _WIN32
+    if (threads <= 0)
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (threads <= 0)
+        threads = 1;
+    return threads < job_count ? threads : job_count;
+}
+
+#ifndef _WIN32
+// 工作线程依次领取下一个函数，直到全部生成
+typedef struct
+{
+    CodegenJob *jobs;
+    int count;
+    int next;
+    pthread_mutex_t lock;
+} JobQueue;
+
+static void *codegen_worker(void *arg)
+{
+    JobQueue *queue = arg;
+    for (;;)
+    {
+        pthread_mutex_lock(&queue->lock);
+        int index = queue->next++;
+        pthread_mutex_unlock(&queue->lock);
+        if (index >= queue->count)
+            return NULL;
+        run_job(&queue->jobs[index]);
+    }
+}
+#endif
+
+// 生成全部函数：多于一个线程时由线程池并行生成（主线程也参与），否则依次生成
+static void run_jobs(CodegenJob *jobs, int count)
+{
+    int threads = codegen_thread_count(count);
+#ifndef _WIN32
+    if (threads > 1)
+    {
+        JobQueue queue;
+        queue.jobs = jobs;
+        queue.count = count;
+        queue.next = 0;
+        pthread_mutex_init(&queue.lock, NULL);
+        pthread_t *workers = malloc((threads - 1) * sizeof(pthread_t));
+        int started = 0;
+        while (started < threads - 1 && pthread_create(&workers[started], NULL, codegen_worker, &queue) == 0)
+        {
+            started++;
+        }
+        codegen_worker(&queue);
+        for (int i = 0; i < started; i++)
+        {
+            pthread_join(workers[i], NULL);
+        }
+        free(workers);
+        pthread_mutex_destroy(&queue.lock);
+        return;
+    }
+#endif
+    for (int i = 0; i < count; i++)
+    {
+        run_job(&jobs[i]);
+    }
+}
+
+// 在串行上下文中生成运行时错误处理函数
+static void emit_error_handler(const char *name, const char *callee)
+{
+    CodegenContext ctx;
+    context_init(&ctx, 0, module);
+    cg = &ctx;
+    generate_error_handler(name, callee);
+    context_free(&ctx);
+    cg = NULL;
+}
+
+// 整个程序：数组越界处理、用户函数和 main（顶层语句）。各函数在自己的上下文和模块中生成，
+// 再按源码顺序合并，输出与线程数无关
+static void generate_program(ASTNode *node)
+{
+    emit_error_handler("array_bounds_error", "ml_bounds_error");
+    emit_error_handler("division_by_zero_error", "ml_division_error");
+
+    if (mir_target->windows)
+    {
+        static const char *const externs[] = {"__main",       "ml_printf",     "ml_print_int",  "ml_print_float",
+                                              "ml_print_str", "ml_array_new", "ml_array_free", "ml_bounds_error",
+                                              "ml_division_error"};
+        for (size_t i = 0; i < sizeof(externs) / sizeof(externs[0]); i++)
+        {
+            mir_buffer_printf(&module->text, "\t.def\t%s;\t.scl\t2;\t.type\t32;\t.endef\n", externs[i]);
+        }
+    }
+
+    clear_functions();
+    collect_functions(node);
+
+    // 最后一个任务是 main
+    int job_count = function_count + 1;
+    CodegenJob *jobs = calloc(job_count, sizeof(CodegenJob));
+    for (int i = 0; i < job_count; i++)
+    {
+        jobs[i].info = i < function_count ? &functions[i] : NULL;
+        jobs[i].program = node;
+        jobs[i].emit_text = object_code == NULL;
+        mir_module_init(&jobs[i].module);
+        context_init(&jobs[i].ctx, i + 1, &jobs[i].module);
+    }
+    run_jobs(jobs, job_count);
+
+    for (int i = 0; i < job_count; i++)
+    {
+        if (jobs[i].fn != NULL)
+            emit_function(jobs[i].fn);
+        mir_module_append(module, &jobs[i].module);
+        vectorized_loops += jobs[i].ctx.vectorized_loops;
+        unrolled_loops += jobs[i].ctx.unrolled_loops;
+        context_free(&jobs[i].ctx);
+    }
+    free(jobs);
+}
+
+// 汇编代码生成函数
+void ast_write_to_file(ASTNode *node, const char *filename)
+{
+    FILE *output = fopen(filename, "w");
+    if (!output)
+    {
+        fprintf(stderr, "Error: Cannot open file %s\n", filename);
+        return;
+    }
+
+    MirModule asm_module;
+    begin_module(&asm_module);
+    mir_buffer_printf(&module->text, "\t.file\t\"%s\"\n", source_file_name(filename));
+    mir_buffer_printf(&module->text, "\t.text\n");
+    mir_buffer_printf(&module->rodata, "\t%s\n", mir_target->rodata);
+
+    generate_program(node);
+
+    if (!mir_target->windows)
+        mir_buffer_printf(&module->rodata, "\t.section\t.note.GNU-stack,\"\",@progbits\n");
+
+    if (!mir_module_write(module, output))
+    {
+        fprintf(stderr, "Error: Failed to write %s\n", filename);
+    }
+
+    end_module();
+    fclose(output);
+}
+
+bool ast_write_object(ASTNode *node, const char *filename)
+{
+    if (mir_target->windows)
+    {
+        fprintf(stderr, "Error: Object file output supports only the linux target, use -S instead\n");
+        return false;
+    }
+
+    MirModule object_module;
+    X86Code code;
+    x86_code_init(&code);
+    begin_module(&object_module);
+    object_code = &code;
+    generate_program(node);
+    object_code = NULL;
+
+    // 函数之间的调用和跳转在这里填好，剩下只读数据和外部函数的重定位
+    x86_resolve_local(&code);
+    bool ok = elf_write_object(filename, source_file_name(filename), &code, module);
+
+    x86_code_free(&code);
+    end_module();
+    return ok;
+}
+
+// 排序内建函数的数组实参
+static Variable *sort_array_argument(ASTNode *call, int index)
+{
+    ASTNode *arg = call->func_call.args[index];
+    if (arg == NULL || arg->type != AST_VARIABLE)
+    {
+        fprintf(stderr, "Error: %s expects an array variable as argument %d\n",
+                call->func_call.func_name, index + 1);
+        exit(1);
+    }
+
+    Variable *var = find_variable(arg->string_value);
+    if (var == NULL || (var->type != TYPE_INT_ARRAY && var->type != TYPE_FLOAT_ARRAY))
+    {
+        fprintf(stderr, "Error: '%s' is not an int[] or float[] array\n", arg->string_value);
+        exit(1);
+    }
+    return var;
+}
+
+// 与解释器和 C 后端一致，sort_by 的两个数组元素个数不同时由 ml_sort_size_error 报告运行时错误；
+// 两个大小都是相同的常量时不检查
+static void generate_sort_size_check(Variable *arr, Variable *keys)
+{
+    MirOperand size = array_length(arr);
+    MirOperand key_size = array_length(keys);
+    const char *same_label = NULL;
+    if (size.kind == MOP_IMM && key_size.kind == MOP_IMM)
+    {
+        if (size.value == key_size.value)
+            return;
+    }
+    else
+    {
+        same_label = new_label("samesize", cg->label_count++);
+        emit2(MIR_MOV, 4, key_size, reg32(REG_RAX));
+        emit2(MIR_CMP, 4, size, reg32(REG_RAX));
+        mir_emit_jcc(cg->fn, COND_E, same_label);
+    }
+
+    // ml_sort_size_error(name, keys, size, key_size)，不返回
+    int area = begin_call(4);
+    emit_arg_string(0, arr->name);
+    emit_arg_string(1, keys->name);
+    emit_arg_length(2, arr);
+    emit_arg_length(3, keys);
+    emit_call_extern("ml_sort_size_error", false, 0);
+    end_call(area);
+    if (same_label != NULL)
+        mir_emit_label(cg->fn, same_label);
+}
+
+// sort/sort_desc/sort_by 调用运行时库 libmlrt；不是排序内建函数时返回0
+static int generate_sort_call(ASTNode *node)
+{
+    const char *name = node->func_call.func_name;
+    bool keyed = strcmp(name, "sort_by") == 0;
+    if (!keyed && strcmp(name, "sort") != 0 && strcmp(name, "sort_desc") != 0)
+        return 0;
+
+    int expected = keyed ? 2 : 1;
+    if (node->func_call.arg_count != expected)
+    {
+        fprintf(stderr, "Error: %s function expects exactly %d argument(s)\n", name, expected);
+        exit(1);
+    }
+
+    Variable *arr = sort_array_argument(node, 0);
+    int live = save_live_temps();
+    int area;
+    if (keyed)
+    {
+        // ml_sort_by_key(values, keys, n, key_is_float, descending)
+        Variable *keys = sort_array_argument(node, 1);
+        generate_sort_size_check(arr, keys);
+        area = begin_call(5);
+        emit_arg_array(0, arr);
+        emit_arg_array(1, keys);
+        emit_arg_length(2, arr);
+        emit_arg_imm(3, keys->type == TYPE_FLOAT_ARRAY);
+        emit_arg_imm(4, 0);
+        emit_call_extern("ml_sort_by_key", false, 0);
+    }
+    else
+    {
+        // ml_sort_int/ml_sort_float(data, n, descending)
+        area = begin_call(3);
+        emit_arg_array(0, arr);
+        emit_arg_length(1, arr);
+        emit_arg_imm(2, strcmp(name, "sort_desc") == 0);
+        emit_call_extern(arr->type == TYPE_FLOAT_ARRAY ? "ml_sort_float" : "ml_sort_int", false, 0);
+    }
+    end_call(area);
+    restore_live_temps(live);
+    emit2(MIR_XOR, 4, reg32(REG_RAX), reg32(REG_RAX));
+    return 1;
+}
+
+// 数组下标检查：%ecx 为下标，按无符号比较同时排除负数
+static Variable *generate_array_index(ASTNode *access)
+{
+    Variable *var = find_variable(access->array_access.var_name);
+    if (var == NULL || !is_array(var))
+    {
+        fprintf(stderr, "Error: Undefined array '%s'\n", access->array_access.var_name);
+        exit(1);
+    }
+
+    generate_value(access->array_access.index, TYPE_INT);
+    emit2(MIR_MOV, 4, reg32(REG_RAX), reg32(REG_RCX));
+    emit2(MIR_CMP, 4, array_length(var), reg32(REG_RCX));
+    mir_emit_jcc(cg->fn, COND_AE, var->bounds_label ? var->bounds_label : "array_bounds_error");
+    return var;
+}
+
+// 数组元素 base[%rcx]；堆上的数组先把元素指针装入 %rdx
+static MirOperand array_element(Variable *var)
+{
+    if (var->heap)
+    {
+        emit2(MIR_MOV, 8, mir_mem(REG_RBP, -var->offset), reg64(REG_RDX));
+        return mir_mem_index(REG_RDX, 0, REG_RCX, 4);
+    }
+    return mir_mem_index(REG_RBP, -var->offset, REG_RCX, 4);
+}
+
+// 堆上的数组：求出大小，由运行时库释放上一次执行声明时分配的元素并分配清零的新元素
+// （大小不是正数或内存不足时报错退出）
+static void generate_heap_array(ASTNode *node, int type, int offset)
+{
+    Variable *var = find_variable(node->array_decl.var_name);
+    if (var == NULL)
+        var = new_variable(node->array_decl.var_name);
+    var->type = type;
+    var->offset = offset;
+    var->heap = true;
+    var->array_size = constant_array_size(node);
+
+    MirOperand pointer = mir_mem(REG_RBP, -offset);
+    if (var->array_size == 0)
+    {
+        generate_value(node->array_decl.size, TYPE_INT);
+        if (var->length_vreg < 0)
+            var->length_vreg = cg->fn->vreg_count++;
+        emit2(MIR_MOV, 4, reg32(REG_RAX), mir_vreg(var->length_vreg));
+    }
+    else
+    {
+        var->length_vreg = -1;
+    }
+
+    int area = begin_call(2);
+    emit2(MIR_MOV, 8, pointer, reg64(mir_target->arg_regs[0]));
+    emit_arg_length(1, var);
+    emit_call_extern("ml_array_new", false, 0);
+    end_call(area);
+    emit2(MIR_MOV, 8, reg64(REG_RAX), pointer);
+}
+
+// 求值条件并设置标志位，ZF=1 表示假；float 左移一位去掉符号位，-0.0 也为假
+static void generate_condition(ASTNode *cond)
+{
+    ast_generate_assembly(cond, cg->fn);
+    if (expr_type(cond) == TYPE_FLOAT)
+        emit2(MIR_ADD, 4, reg32(REG_RAX), reg32(REG_RAX));
+    else
+        emit2(MIR_TEST, 4, reg32(REG_RAX), reg32(REG_RAX));
+}
+
+// 短路求值的 && 与 ||，结果为0或1
+static void generate_logical_op(ASTNode *node)
+{
+    int label = cg->label_count++;
+    bool is_and = strcmp(node->binary.op, "&&") == 0;
+    const char *short_label = new_label("logic_short", label);
+    const char *end_label = new_label("logic_end", label);
+
+    generate_condition(node->binary.left);
+    mir_emit_jcc(cg->fn, is_and ? COND_E : COND_NE, short_label);
+    generate_condition(node->binary.right);
+    mir_emit_setcc(cg->fn, COND_NE, REG_RAX);
+    emit2(MIR_MOVZB, 4, mir_reg(REG_RAX, 1), reg32(REG_RAX));
+    emit1(MIR_JMP, 8, mir_label(end_label));
+    mir_emit_label(cg->fn, short_label);
+    emit2(MIR_MOV, 4, mir_imm(is_and ? 0 : 1), reg32(REG_RAX));
+    mir_emit_label(cg->fn, end_label);
+}
+
+// 比较运算符对应的条件码，不是比较运算符时返回 false
+static bool comparison_cond(const char *op, MirCond *cond)
+{
+    if (strcmp(op, "<") == 0)
+        *cond = COND_L;
+    else if (strcmp(op, "<=") == 0)
+        *cond = COND_LE;
+    else if (strcmp(op, ">") == 0)
+        *cond = COND_G;
+    else if (strcmp(op, ">=") == 0)
+        *cond = COND_GE;
+    else if (strcmp(op, "==") == 0)
+        *cond = COND_E;
+    else if (strcmp(op, "!=") == 0)
+        *cond = COND_NE;
+    else
+        return false;
+    return true;
+}
+
+// 条件为假（%eax 为0）时跳转到 label
+static void emit_branch_if_false(ASTNode *cond, const char *label)
+{
+    generate_condition(cond);
+    mir_emit_jcc(cg->fn, COND_E, label);
+}
+
+// 浮点二元运算：左操作数在 %xmm0，右操作数是常量时从常量区直接读取，是 float 变量时
+// movd 到 %xmm1，否则求值后放入 %xmm1。比较用 ucomiss 的无符号条件码，< 和 <= 交换操作数
+// 后按 > 和 >= 判断；无序（任一侧为 NaN）时 ucomiss 置 ZF=PF=CF=1，所以 == 还要求 PF=0，
+// != 取 == 的反。这样与 C 一样，NaN 与任何值比较时只有 != 为真
+static void generate_float_op(ASTNode *node)
+{
+    const char *op = node->binary.op;
+    ASTNode *rhs = node->binary.right;
+    MirOperand right;
+    MirCond cond;
+    if (strcmp(op, "%") == 0)
+    {
+        fprintf(stderr, "Error: Operator %% needs integer operands\n");
+        exit(1);
+    }
+
+    generate_value(node->binary.left, TYPE_FLOAT);
+    if (rhs->type == AST_INTEGER || rhs->type == AST_FLOAT)
+    {
+        float value = rhs->type == AST_INTEGER ? (float)rhs->int_value : rhs->float_value;
+        right = mir_rip(emit_float_literal(value));
+    }
+    else if (simple_operand(rhs, &right) && expr_type(rhs) == TYPE_FLOAT)
+    {
+        emit2(MIR_MOVD, 4, right, mir_xmm(1));
+        right = mir_xmm(1);
+    }
+    else
+    {
+        save_temp();
+        generate_value(rhs, TYPE_FLOAT);
+        emit2(MIR_MOVD, 4, reg32(REG_RAX), mir_xmm(1));
+        restore_temp();
+        right = mir_xmm(1);
+    }
+    emit2(MIR_MOVD, 4, reg32(REG_RAX), mir_xmm(0));
+
+    if (comparison_cond(op, &cond))
+    {
+        if (cond == COND_L || cond == COND_LE)
+        {
+            if (right.kind != MOP_XMM)
+                emit2(MIR_MOVSS, 4, right, mir_xmm(1));
+            emit2(MIR_UCOMISS, 4, mir_xmm(0), mir_xmm(1));
+            cond = cond == COND_L ? COND_A : COND_AE;
+        }
+        else
+        {
+            emit2(MIR_UCOMISS, 4, right, mir_xmm(0));
+            if (cond == COND_E || cond == COND_NE)
+            {
+                mir_emit_setcc(cg->fn, COND_E, REG_RAX);
+                mir_emit_setcc(cg->fn, COND_NP, REG_RCX);
+                emit2(MIR_MOVZB, 4, mir_reg(REG_RAX, 1), reg32(REG_RAX));
+                emit2(MIR_MOVZB, 4, mir_reg(REG_RCX, 1), reg32(REG_RCX));
+                emit2(MIR_AND, 4, reg32(REG_RCX), reg32(REG_RAX));
+                if (cond == COND_NE)
+                    emit2(MIR_XOR, 4, mir_imm(1), reg32(REG_RAX));
+                return;
+            }
+            if (cond == COND_G)
+                cond = COND_A;
+            else if (cond == COND_GE)
+                cond = COND_AE;
+        }
+        mir_emit_setcc(cg->fn, cond, REG_RAX);
+        emit2(MIR_MOVZB, 4, mir_reg(REG_RAX, 1), reg32(REG_RAX));
+        return;
+    }
+
+    MirOpcode opcode = MIR_ADDSS;
+    if (strcmp(op, "-") == 0)
+        opcode = MIR_SUBSS;
+    else if (strcmp(op, "*") == 0)
+        opcode = MIR_MULSS;
+    else if (strcmp(op, "/") == 0)
+    {
+        opcode = MIR_DIVSS;
+        // 与解释器和 C 后端一致，除数为0（包括 -0.0，不包括 NaN）时报告运行时错误
+        if (rhs->type == AST_INTEGER || rhs->type == AST_FLOAT)
+        {
+            if ((rhs->type == AST_INTEGER ? (float)rhs->int_value : rhs->float_value) == 0.0f)
+                emit1(MIR_JMP, 8, mir_label("division_by_zero_error"));
+        }
+        else
+        {
+            const char *nonzero_label = new_label("divisor", cg->label_count++);
+            emit2(MIR_UCOMISS, 4, mir_rip(emit_float_literal(0.0f)), mir_xmm(1));
+            mir_emit_jcc(cg->fn, COND_P, nonzero_label);
+            mir_emit_jcc(cg->fn, COND_E, "division_by_zero_error");
+            mir_emit_label(cg->fn, nonzero_label);
+        }
+    }
+    emit2(opcode, 4, right, mir_xmm(0));
+    emit2(MIR_MOVD, 4, mir_xmm(0), reg32(REG_RAX));
+}
+
+// 除以常量 ad（>= 2，不是2的幂）的有符号乘法因子 multiplier 和右移位数 shift：
+// q = ((x × multiplier) 的高32位 [+ x]) >> shift，再加上 x 的符号位（Hacker's Delight 10-4）
+static void division_magic(uint32_t ad, int32_t *multiplier, int *shift)
+{
+    const uint32_t two31 = 0x80000000u;
+    uint32_t anc = two31 - 1 - two31 % ad;
+    uint32_t q1 = two31 / anc;
+    uint32_t r1 = two31 - q1 * anc;
+    uint32_t q2 = two31 / ad;
+    uint32_t r2 = two31 - q2 * ad;
+    uint32_t delta;
+    int p = 31;
+    do
+    {
+        p++;
+        q1 *= 2;
+        r1 *= 2;
+        if (r1 >= anc)
+        {
+            q1++;
+            r1 -= anc;
+        }
+        q2 *= 2;
+        r2 *= 2;
+        if (r2 >= ad)
+        {
+            q2++;
+            r2 -= ad;
+        }
+        delta = ad - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+    *multiplier = (int32_t)(q2 + 1);
+    *shift = p - 32;
+}
+
+// 2的幂 ad = 2^k 的除法先给负的被除数加上 ad - 1，使算术右移向零截断：%edx = x + 偏移，x 在 %ecx。返回 k
+static int generate_power_of_two_bias(uint32_t ad)
+{
+    int k = 0;
+    while ((ad >> k) != 1)
+    {
+        k++;
+    }
+    emit2(MIR_MOV, 4, reg32(REG_RCX), reg32(REG_RDX));
+    emit2(MIR_SAR, 4, mir_imm(31), reg32(REG_RDX));
+    emit2(MIR_SHR, 4, mir_imm(32 - k), reg32(REG_RDX));
+    emit2(MIR_ADD, 4, reg32(REG_RCX), reg32(REG_RDX));
+    return k;
+}
+
+// ad >= 3 且不是2的幂：%edx = 向零截断的 x / ad，即 (x × multiplier) 的高32位 [+ x] 右移后加上 x 的符号位。
+// x 同时在 %eax 和 %ecx，改写 %eax
+static void generate_magic_quotient(uint32_t ad)
+{
+    int32_t multiplier;
+    int shift;
+    division_magic(ad, &multiplier, &shift);
+    emit2(MIR_MOV, 4, mir_imm(multiplier), reg32(REG_RDX));
+    emit1(MIR_IMUL_WIDE, 4, reg32(REG_RDX));
+    if (multiplier < 0)
+        emit2(MIR_ADD, 4, reg32(REG_RCX), reg32(REG_RDX));
+    if (shift > 0)
+        emit2(MIR_SAR, 4, mir_imm(shift), reg32(REG_RDX));
+    emit2(MIR_MOV, 4, reg32(REG_RCX), reg32(REG_RAX));
+    emit2(MIR_SHR, 4, mir_imm(31), reg32(REG_RAX));
+    emit2(MIR_ADD, 4, reg32(REG_RAX), reg32(REG_RDX));
+}
+
+// 整数除以正的常量 d、向零截断的商。被除数和结果在 %eax，改写 %ecx 和 %edx
+static void generate_constant_quotient(uint32_t d)
+{
+    if (d == 1)
+        return;
+    emit2(MIR_MOV, 4, reg32(REG_RAX), reg32(REG_RCX));
+    if ((d & (d - 1)) == 0)
+        emit2(MIR_SAR, 4, mir_imm(generate_power_of_two_bias(d)), reg32(REG_RDX));
+    else
+        generate_magic_quotient(d);
+    emit2(MIR_MOV, 4, reg32(REG_RDX), reg32(REG_RAX));
+}
+
+// 整数对非0常量 d 取余：r = x - q × |d|，q 是向零截断的商 x / |d|，余数与 idivl 相同（INT_MIN % -1 为0）。
+// 被除数和结果在 %eax，改写 %ecx 和 %edx
+static void generate_constant_modulo(int32_t d)
+{
+    uint32_t ad = d < 0 ? 0u - (uint32_t)d : (uint32_t)d;
+    if (ad == 1)
+    {
+        emit2(MIR_XOR, 4, reg32(REG_RAX), reg32(REG_RAX));
+        return;
+    }
+
+    emit2(MIR_MOV, 4, reg32(REG_RAX), reg32(REG_RCX));
+    if ((ad & (ad - 1)) == 0)
+    {
+        generate_power_of_two_bias(ad);
+        emit2(MIR_AND, 4, mir_imm(-(long)ad), reg32(REG_RDX));
+    }
+    else
+    {
+        generate_magic_quotient(ad);
+        emit2(MIR_IMUL, 4, mir_imm((int32_t)ad), reg32(REG_RDX));
+    }
+    emit2(MIR_MOV, 4, reg32(REG_RCX), reg32(REG_RAX));
+    emit2(MIR_SUB, 4, reg32(REG_RDX), reg32(REG_RAX));
+}
+
+// 结果截断为 int 的 x / d（x 为 int，d 为正的整数常量且 d <= 2^24）：-2^24 < x < 2^24 时 float 除法
+// 向零截断的结果与整数除法相同（x 和 d 都能精确表示为 float，舍入不会越过下一个整数），改用乘法和移位；
+// 其他 x 仍按 float 除法计算。不是这种形式时返回 false
+static bool generate_truncated_division(ASTNode *node)
+{
+    if (node->type != AST_BINARY_OP || strcmp(node->binary.op, "/") != 0 ||
+        expr_type(node->binary.left) != TYPE_INT || node->binary.right->type != AST_INTEGER)
+        return false;
+    int d = node->binary.right->int_value;
+    if (d <= 0 || d > (1 << 24))
+        return false;
+
+    int label = cg->label_count++;
+    const char *float_label = new_label("fdiv", label);
+    const char *end_label = new_label("enddiv", label);
+    generate_value(node->binary.left, TYPE_INT);
+    // 无符号比较 x + 2^24 - 1 <= 2^25 - 2 即 -2^24 < x < 2^24
+    emit2(MIR_MOV, 4, reg32(REG_RAX), reg32(REG_RCX));
+    emit2(MIR_ADD, 4, mir_imm((1 << 24) - 1), reg32(REG_RCX));
+    emit2(MIR_CMP, 4, mir_imm((1 << 25) - 2), reg32(REG_RCX));
+    mir_emit_jcc(cg->fn, COND_A, float_label);
+    generate_constant_quotient((uint32_t)d);
+    emit1(MIR_JMP, 8, mir_label(end_label));
+    mir_emit_label(cg->fn, float_label);
+    emit2(MIR_CVTSI2SS, 4, reg32(REG_RAX), mir_xmm(0));
+    emit2(MIR_DIVSS, 4, mir_rip(emit_float_literal((float)d)), mir_xmm(0));
+    emit2(MIR_CVTTSS2SI, 4, mir_xmm(0), reg32(REG_RAX));
+    mir_emit_label(cg->fn, end_label);
+    return true;
+}
+
+// 整数取余，与解释器和 C 后端相同：除数为0时报告运行时错误，x % -1 为0（INT_MIN % -1 不会溢出）。
+// 被除数和结果在 %eax，right 为立即数或不是 %eax/%edx 的寄存器、虚拟寄存器
+static void generate_modulo(MirOperand right)
+{
+    if (right.kind == MOP_IMM)
+    {
+        if (right.value == 0)
+            emit1(MIR_JMP, 8, mir_label("division_by_zero_error"));
+        else
+            generate_constant_modulo((int32_t)right.value);
+        return;
+    }
+
+    int label = cg->label_count++;
+    const char *divide_label = new_label("mod", label);
+    const char *end_label = new_label("endmod", label);
+    emit2(MIR_CMP, 4, mir_imm(0), right);
+    mir_emit_jcc(cg->fn, COND_E, "division_by_zero_error");
+    emit2(MIR_CMP, 4, mir_imm(-1), right);
+    mir_emit_jcc(cg->fn, COND_NE, divide_label);
+    emit2(MIR_XOR, 4, reg32(REG_RAX), reg32(REG_RAX));
+    emit1(MIR_JMP, 8, mir_label(end_label));
+    mir_emit_label(cg->fn, divide_label);
+    mir_emit0(cg->fn, MIR_CDQ);
+    emit1(MIR_IDIV, 4, right);
+    emit2(MIR_MOV, 4, reg32(REG_RDX), reg32(REG_RAX));
+    mir_emit_label(cg->fn, end_label);
+}
+
+// 循环向量化：for (i = A; i < B; i = i + 1) 的循环体只有数组赋值 x[i] = 表达式，表达式由 y[i]、
+// 常量和循环不变的标量组成时，先用 SSE2 每次处理4个元素，剩下的元素（以及不满足下标范围的情况）
+// 交给原来的标量循环。所有数组访问的下标都是 i 本身，同一次迭代内按语句顺序读写，
+// 不同迭代之间没有依赖；不同名字的数组不重叠。元素用 movups 不对齐访问，不需要对齐的前导循环
+#define VECTOR_WIDTH 4
+#define VECTOR_REGS 6 // 只用 %xmm0-%xmm5，Win64 的 %xmm6 起由被调者保存
+
+// 访问的数组中最小的大小，下标范围只需按它检查
+typedef struct
+{
+    const char *index;
+    int elem_type;
+    int min_size;
+} VectorPlan;
+
+// 表达式能否按 elem_type 向量化，返回需要的 %xmm 个数（0 表示不能）
+static int vector_expr_regs(VectorPlan *plan, ASTNode *node)
+{
+    switch (node->type)
+    {
+    case AST_INTEGER:
+        return 1;
+    case AST_FLOAT:
+        return plan->elem_type == TYPE_FLOAT ? 1 : 0;
+    case AST_VARIABLE:
+    {
+        Variable *var = find_variable(node->string_value);
+        if (var == NULL || is_array(var) || var->type != plan->elem_type ||
+            strcmp(node->string_value, plan->index) == 0)
+            return 0;
+        return 1;
+    }
+    case AST_ARRAY_ACCESS:
+    {
+        Variable *var = find_variable(node->array_access.var_name);
+        ASTNode *index = node->array_access.index;
+        int type = plan->elem_type == TYPE_FLOAT ? TYPE_FLOAT_ARRAY : TYPE_INT_ARRAY;
+        if (var == NULL || var->type != type || index->type != AST_VARIABLE ||
+            strcmp(index->string_value, plan->index) != 0)
+            return 0;
+        if (var->array_size < plan->min_size)
+            plan->min_size = var->array_size;
+        return 1;
+    }
+    case AST_BINARY_OP:
+    {
+        const char *op = node->binary.op;
+        bool int_op = strcmp(op, "+") == 0 || strcmp(op, "-") == 0;
+        bool float_op = int_op || strcmp(op, "*") == 0 || strcmp(op, "/") == 0;
+        // SSE2 没有 32 位整数乘法（pmulld 需要 SSE4.1）
+        if (!(plan->elem_type == TYPE_FLOAT ? float_op : int_op))
+            return 0;
+        // divps 不检查除数，只有除以非0常量时向量化，否则由标量代码报告除零错误
+        if (strcmp(op, "/") == 0)
+        {
+            ASTNode *divisor = node->binary.right;
+            if (!((divisor->type == AST_INTEGER && divisor->int_value != 0) ||
+                  (divisor->type == AST_FLOAT && divisor->float_value != 0.0f)))
+                return 0;
+        }
+        int left = vector_expr_regs(plan, node->binary.left);
+        int right = vector_expr_regs(plan, node->binary.right);
+        if (left == 0 || right == 0)
+            return 0;
+        return left > right + 1 ? left : right + 1;
+    }
+    default:
+        return 0;
+    }
+}
+
+// 检查循环的形式和循环体中的数组赋值，可以向量化时填好 plan
+static bool plan_vector_loop(ASTNode *loop, VectorPlan *plan)
+{
+    ASTNode *cond = loop->for_loop.cond;
+    ASTNode *update = loop->for_loop.update;
+    ASTNode *body = loop->for_loop.body;
+    MirOperand bound;
+    if (cond == NULL || update == NULL || body == NULL || cond->type != AST_BINARY_OP ||
+        (strcmp(cond->binary.op, "<") != 0 && strcmp(cond->binary.op, "<=") != 0) ||
+        cond->binary.left->type != AST_VARIABLE || !simple_operand(cond->binary.right, &bound) ||
+        expr_type(cond->binary.right) != TYPE_INT)
+        return false;
+
+    const char *index = cond->binary.left->string_value;
+    Variable *var = find_variable(index);
+    if (var == NULL || is_array(var) || var->type != TYPE_INT ||
+        (cond->binary.right->type == AST_VARIABLE && strcmp(cond->binary.right->string_value, index) == 0))
+        return false;
+
+    // i = i + 1
+    ASTNode *step = update->binary.right;
+    if (update->type != AST_ASSIGNMENT || strcmp(update->binary.left->string_value, index) != 0 ||
+        step->type != AST_BINARY_OP || strcmp(step->binary.op, "+") != 0 ||
+        step->binary.left->type != AST_VARIABLE || strcmp(step->binary.left->string_value, index) != 0 ||
+        step->binary.right->type != AST_INTEGER || step->binary.right->int_value != 1)
+        return false;
+
+    ASTNode **stmts = body->type == AST_BLOCK ? body->block.statements : &body;
+    int count = body->type == AST_BLOCK ? body->block.count : 1;
+    if (count == 0)
+        return false;
+    plan->index = index;
+    plan->elem_type = 0;
+    plan->min_size = 0x7fffffff;
+    for (int i = 0; i < count; i++)
+    {
+        if (stmts[i]->type != AST_ARRAY_ASSIGNMENT)
+            return false;
+        ASTNode *target = stmts[i]->array_assignment.array_access;
+        Variable *array = find_variable(target->array_access.var_name);
+        if (array == NULL || !is_array(array))
+            return false;
+        int elem_type = array->type == TYPE_FLOAT_ARRAY ? TYPE_FLOAT : TYPE_INT;
+        if (plan->elem_type != 0 && plan->elem_type != elem_type)
+            return false;
+        plan->elem_type = elem_type;
+        if (vector_expr_regs(plan, target) == 0)
+            return false;
+        int regs = vector_expr_regs(plan, stmts[i]->array_assignment.value);
+        if (regs == 0 || regs > VECTOR_REGS)
+            return false;
+    }
+    return plan->min_size >= VECTOR_WIDTH;
+}
+
+// 把 %eax 的值广播到 %xmm<reg> 的4个元素
+static void emit_broadcast(int reg)
+{
+    emit2(MIR_MOVD, 4, reg32(REG_RAX), mir_xmm(reg));
+    emit2(MIR_PUNPCKLDQ, 16, mir_xmm(reg), mir_xmm(reg));
+    emit2(MIR_PUNPCKLQDQ, 16, mir_xmm(reg), mir_xmm(reg));
+}
+
+// 求值到 %xmm<reg>，更高编号的寄存器存放中间结果；%rcx 为下标 i
+static void generate_vector_expr(const VectorPlan *plan, ASTNode *node, int reg)
+{
+    switch (node->type)
+    {
+    case AST_INTEGER:
+        if (plan->elem_type == TYPE_FLOAT)
+            emit2(MIR_MOV, 4, mir_rip(emit_float_literal((float)node->int_value)), reg32(REG_RAX));
+        else
+            emit2(MIR_MOV, 4, mir_imm(node->int_value), reg32(REG_RAX));
+        emit_broadcast(reg);
+        break;
+    case AST_FLOAT:
+        emit2(MIR_MOV, 4, mir_rip(emit_float_literal(node->float_value)), reg32(REG_RAX));
+        emit_broadcast(reg);
+        break;
+    case AST_VARIABLE:
+        emit2(MIR_MOV, 4, variable_operand(node->string_value), reg32(REG_RAX));
+        emit_broadcast(reg);
+        break;
+    case AST_ARRAY_ACCESS:
+        emit2(MIR_MOVUPS, 16, array_element(find_variable(node->array_access.var_name)), mir_xmm(reg));
+        break;
+    default:
+    {
+        const char *op = node->binary.op;
+        bool is_float = plan->elem_type == TYPE_FLOAT;
+        MirOpcode opcode = is_float ? MIR_ADDPS : MIR_PADDD;
+        if (strcmp(op, "-") == 0)
+            opcode = is_float ? MIR_SUBPS : MIR_PSUBD;
+        else if (strcmp(op, "*") == 0)
+            opcode = MIR_MULPS;
+        else if (strcmp(op, "/") == 0)
+            opcode = MIR_DIVPS;
+        generate_vector_expr(plan, node->binary.left, reg);
+        generate_vector_expr(plan, node->binary.right, reg + 1);
+        emit2(opcode, 16, mir_xmm(reg + 1), mir_xmm(reg));
+        break;
+    }
+    }
+}
+
+// 在 for 循环的标量代码之前生成向量循环：0 <= i 且 i + 3 < 所有数组的大小、i + 3 仍满足循环条件时
+// 每次处理4个元素，否则落到标量循环（由它处理剩余元素和下标越界）
+static bool generate_vector_loop(ASTNode *loop)
+{
+    VectorPlan plan;
+    if (!vectorize || !plan_vector_loop(loop, &plan))
+        return false;
+
+    ASTNode *cond = loop->for_loop.cond;
+    ASTNode *body = loop->for_loop.body;
+    ASTNode **stmts = body->type == AST_BLOCK ? body->block.statements : &body;
+    int count = body->type == AST_BLOCK ? body->block.count : 1;
+    MirOperand index = variable_operand(plan.index);
+    MirOperand bound;
+    simple_operand(cond->binary.right, &bound);
+
+    int label = cg->label_count++;
+    const char *loop_label = new_label("vector", label);
+    const char *end_label = new_label("endvector", label);
+    mir_emit_label(cg->fn, loop_label);
+    emit2(MIR_MOV, 4, index, reg32(REG_RAX));
+    emit2(MIR_CMP, 4, mir_imm(plan.min_size - VECTOR_WIDTH), reg32(REG_RAX));
+    mir_emit_jcc(cg->fn, COND_A, end_label);
+    emit2(MIR_ADD, 4, mir_imm(VECTOR_WIDTH - 1), reg32(REG_RAX));
+    emit2(MIR_CMP, 4, bound, reg32(REG_RAX));
+    mir_emit_jcc(cg->fn, strcmp(cond->binary.op, "<") == 0 ? COND_GE : COND_G, end_label);
+    emit2(MIR_MOV, 4, index, reg32(REG_RCX));
+    for (int i = 0; i < count; i++)
+    {
+        ASTNode *target = stmts[i]->array_assignment.array_access;
+        generate_vector_expr(&plan, stmts[i]->array_assignment.value, 0);
+        emit2(MIR_MOVUPS, 16, mir_xmm(0), array_element(find_variable(target->array_access.var_name)));
+    }
+    emit2(MIR_ADD, 4, mir_imm(VECTOR_WIDTH), index);
+    emit1(MIR_JMP, 8, mir_label(loop_label));
+    mir_emit_label(cg->fn, end_label);
+    cg->vectorized_loops++;
+    return true;
+}
+
+// 循环展开：for (i = A; i < B; i = i + C) 形式的循环（<=，或 C 为负时的 > 和 >=），B 是常量或标量变量，
+// 循环体不修改 i 和 B。迭代次数是常量且不多时完全展开，不再判断条件；否则在原来的循环之前生成
+// 每次执行 U 份循环体的展开循环，只在 i + (U-1)*C 仍满足条件时进入，剩下不足 U 次的迭代由原来的循环完成。
+// U 由源码提示 unroll(U) 指定，否则为 -unroll 的倍数或按循环体大小选择；自动展开只处理最内层循环
+#define UNROLL_AUTO_FACTOR 4   // 按大小选择时的最大倍数
+#define UNROLL_BODY_BUDGET 48  // 自动展开后循环体（含更新表达式）的 AST 节点总数上限
+#define FULL_UNROLL_MAX_TRIPS 16
+#define FULL_UNROLL_BUDGET 64
+
+typedef struct
+{
+    const char *index;
+    MirOperand bound;
+    MirCond exit_cond; // 索引与 B - (U-1)*C 比较，满足时离开展开的循环
+    int step;
+    int factor;
+    long trips; // 完全展开时的迭代次数，否则为 -1
+} UnrollPlan;
+
+// 循环体中的 AST 节点数；修改 index 或 bound、声明数组和映射或定义函数时不能展开，返回 -1。
+// 包含循环时 *nested 置为 true
+static int unroll_cost(ASTNode *node, const char *index, const char *bound, bool *nested);
+
+static int unroll_cost_list(ASTNode **nodes, int count, const char *index, const char *bound, bool *nested)
+{
+    int total = 0;
+    for (int i = 0; i < count; i++)
+    {
+        int cost = unroll_cost(nodes[i], index, bound, nested);
+        if (cost < 0)
+            return -1;
+        total += cost;
+    }
+    return total;
+}
+
+static int unroll_cost(ASTNode *node, const char *index, const char *bound, bool *nested)
+{
+    if (node == NULL)
+        return 0;
+    ASTNode *children[4] = {NULL, NULL, NULL, NULL};
+    switch (node->type)
+    {
+    case AST_ASSIGNMENT:
+        if (strcmp(node->binary.left->string_value, index) == 0 ||
+            (bound != NULL && strcmp(node->binary.left->string_value, bound) == 0))
+            return -1;
+        children[0] = node->binary.right;
+        break;
+    case AST_DECLARATION:
+    case AST_DECLARATION_INIT:
+        if (strcmp(node->decl.var_name, index) == 0 || (bound != NULL && strcmp(node->decl.var_name, bound) == 0))
+            return -1;
+        if (node->type == AST_DECLARATION_INIT)
+            children[0] = node->decl.init_value;
+        break;
+    case AST_BINARY_OP:
+        children[0] = node->binary.left;
+        children[1] = node->binary.right;
+        break;
+    case AST_RETURN:
+        children[0] = node->binary.left;
+        break;
+    case AST_ARRAY_ACCESS:
+        children[0] = node->array_access.index;
+        break;
+    case AST_ARRAY_ASSIGNMENT:
+        children[0] = node->array_assignment.array_access;
+        children[1] = node->array_assignment.value;
+        break;
+    case AST_IF:
+        children[0] = node->if_stmt.cond;
+        children[1] = node->if_stmt.then_body;
+        children[2] = node->if_stmt.else_body;
+        break;
+    case AST_WHILE:
+        *nested = true;
+        children[0] = node->while_loop.cond;
+        children[1] = node->while_loop.body;
+        break;
+    case AST_FOR:
+        *nested = true;
+        children[0] = node->for_loop.init;
+        children[1] = node->for_loop.cond;
+        children[2] = node->for_loop.update;
+        children[3] = node->for_loop.body;
+        break;
+    case AST_BLOCK:
+        return unroll_cost_list(node->block.statements, node->block.count, index, bound, nested);
+    case AST_FUNCTION_CALL:
+    {
+        int cost = unroll_cost_list(node->func_call.args, node->func_call.arg_count, index, bound, nested);
+        return cost < 0 ? -1 : cost + 1;
+    }
+    case AST_FORMATTED_PRINT:
+    {
+        int cost = unroll_cost_list(node->formatted_print.args, node->formatted_print.arg_count, index, bound, nested);
+        return cost < 0 ? -1 : cost + 1;
+    }
+    case AST_ARRAY_DECLARATION:
+    case AST_MAP_DECLARATION:
+    case AST_FUNCTION_DEF:
+        return -1;
+    default:
+        break;
+    }
+    int cost = unroll_cost_list(children, 4, index, bound, nested);
+    return cost < 0 ? -1 : cost + 1;
+}
+
+// 检查循环的形式并选择展开方式，不展开时返回 false
+static bool plan_unroll(ASTNode *loop, UnrollPlan *plan)
+{
+    ASTNode *init = loop->for_loop.init;
+    ASTNode *cond = loop->for_loop.cond;
+    ASTNode *update = loop->for_loop.update;
+    int hint = loop->for_loop.unroll;
+    if (!unroll || hint == 1 || cond == NULL || update == NULL || cond->type != AST_BINARY_OP ||
+        cond->binary.left->type != AST_VARIABLE || !simple_operand(cond->binary.right, &plan->bound) ||
+        expr_type(cond->binary.right) != TYPE_INT)
+        return false;
+
+    const char *index = cond->binary.left->string_value;
+    const char *bound = cond->binary.right->type == AST_VARIABLE ? cond->binary.right->string_value : NULL;
+    Variable *var = find_variable(index);
+    if (var == NULL || is_array(var) || var->type != TYPE_INT || (bound != NULL && strcmp(bound, index) == 0))
+        return false;
+
+    // i = i + C 或 i = i - C
+    ASTNode *step = update->binary.right;
+    if (update->type != AST_ASSIGNMENT || strcmp(update->binary.left->string_value, index) != 0 ||
+        step->type != AST_BINARY_OP || (strcmp(step->binary.op, "+") != 0 && strcmp(step->binary.op, "-") != 0) ||
+        step->binary.left->type != AST_VARIABLE || strcmp(step->binary.left->string_value, index) != 0 ||
+        step->binary.right->type != AST_INTEGER || step->binary.right->int_value == 0 ||
+        step->binary.right->int_value == INT32_MIN)
+        return false;
+    plan->index = index;
+    plan->step = strcmp(step->binary.op, "+") == 0 ? step->binary.right->int_value : -step->binary.right->int_value;
+
+    // 索引必须单调地接近 B
+    const char *op = cond->binary.op;
+    bool inclusive = strcmp(op, "<=") == 0 || strcmp(op, ">=") == 0;
+    if (plan->step > 0 && (strcmp(op, "<") == 0 || strcmp(op, "<=") == 0))
+        plan->exit_cond = inclusive ? COND_G : COND_GE;
+    else if (plan->step < 0 && (strcmp(op, ">") == 0 || strcmp(op, ">=") == 0))
+        plan->exit_cond = inclusive ? COND_L : COND_LE;
+    else
+        return false;
+
+    bool nested = false;
+    int cost = unroll_cost(loop->for_loop.body, index, bound, &nested);
+    if (cost < 0)
+        return false;
+    cost += 3; // 更新 i = i + C
+    if (nested && hint == 0)
+        return false;
+
+    // A 和 B 都是常量时求出迭代次数，最后一次更新后的索引也不能溢出
+    plan->trips = -1;
+    if (init != NULL && init->type == AST_ASSIGNMENT && strcmp(init->binary.left->string_value, index) == 0 &&
+        init->binary.right->type == AST_INTEGER && plan->bound.kind == MOP_IMM)
+    {
+        long start = init->binary.right->int_value;
+        long distance = plan->step > 0 ? plan->bound.value - start : start - plan->bound.value;
+        long stride = plan->step > 0 ? plan->step : -(long)plan->step;
+        long trips = 0;
+        if (inclusive && distance >= 0)
+            trips = distance / stride + 1;
+        else if (!inclusive && distance > 0)
+            trips = (distance + stride - 1) / stride;
+        long last = start + trips * plan->step;
+        if (last >= INT32_MIN && last <= INT32_MAX)
+            plan->trips = trips;
+    }
+
+    if (hint > 0)
+    {
+        plan->factor = hint;
+        if (plan->trips > hint)
+            plan->trips = -1;
+    }
+    else
+    {
+        if (plan->trips > FULL_UNROLL_MAX_TRIPS || plan->trips * cost > FULL_UNROLL_BUDGET)
+            plan->trips = -1;
+        plan->factor = unroll_factor;
+        if (plan->factor == 0)
+        {
+            plan->factor = UNROLL_AUTO_FACTOR;
+            while (plan->factor > 1 && plan->factor * cost > UNROLL_BODY_BUDGET)
+            {
+                plan->factor /= 2;
+            }
+        }
+    }
+    if (plan->trips >= 0)
+        return true;
+    // 部分展开：比较的界限 B - (U-1)*C 要能用32位表示
+    long lookahead = (long)(plan->factor - 1) * plan->step;
+    if (plan->factor < 2 || lookahead < INT32_MIN || lookahead > INT32_MAX)
+        return false;
+    if (plan->bound.kind == MOP_IMM &&
+        (plan->bound.value - lookahead < INT32_MIN || plan->bound.value - lookahead > INT32_MAX))
+        return false;
+    return true;
+}
+
+// 完全展开：初始化之后依次生成每次迭代的循环体和更新
+static void generate_full_unroll(ASTNode *loop, const UnrollPlan *plan)
+{
+    for (long i = 0; i < plan->trips; i++)
+    {
+        ast_generate_assembly(loop->for_loop.body, cg->fn);
+        ast_generate_assembly(loop->for_loop.update, cg->fn);
+    }
+    cg->unrolled_loops++;
+}
+
+// 部分展开：在原来的循环之前生成展开 U 倍的循环。i 与 B - (U-1)*C 比较，代替 i + (U-1)*C 与 B 比较，
+// 不会因为加法溢出而多执行迭代；B 是变量时在循环前求出界限，减法会溢出时展开的循环一次也不执行
+static void generate_unrolled_loop(ASTNode *loop, const UnrollPlan *plan)
+{
+    int label = cg->label_count++;
+    const char *loop_label = new_label("unroll", label);
+    const char *end_label = new_label("endunroll", label);
+    long lookahead = (long)(plan->factor - 1) * plan->step;
+    MirOperand limit;
+    if (plan->bound.kind == MOP_IMM)
+    {
+        limit = mir_imm(plan->bound.value - lookahead);
+    }
+    else
+    {
+        limit = mir_vreg(cg->fn->vreg_count++);
+        emit2(MIR_MOV, 4, plan->bound, reg32(REG_RAX));
+        if (lookahead > 0)
+        {
+            emit2(MIR_CMP, 4, mir_imm(INT32_MIN + lookahead), reg32(REG_RAX));
+            mir_emit_jcc(cg->fn, COND_L, end_label);
+        }
+        else
         {
-            fprintf(output, "\tcmpl\t%%ecx, %%edx\n");
-            fprintf(output, "\tsetle\t%%al\n");
-            fprintf(output, "\tmovzbl\t%%al, %%eax\n");
+            emit2(MIR_CMP, 4, mir_imm(INT32_MAX + lookahead), reg32(REG_RAX));
+            mir_emit_jcc(cg->fn, COND_G, end_label);
         }
-        else if (strcmp(node->binary.op, ">") == 0)
+        emit2(MIR_SUB, 4, mir_imm(lookahead), reg32(REG_RAX));
+        emit2(MIR_MOV, 4, reg32(REG_RAX), limit);
+    }
+
+    mir_emit_label(cg->fn, loop_label);
+    emit2(MIR_MOV, 4, variable_operand(plan->index), reg32(REG_RAX));
+    emit2(MIR_CMP, 4, limit, reg32(REG_RAX));
+    mir_emit_jcc(cg->fn, plan->exit_cond, end_label);
+    for (int i = 0; i < plan->factor; i++)
+    {
+        ast_generate_assembly(loop->for_loop.body, cg->fn);
+        ast_generate_assembly(loop->for_loop.update, cg->fn);
+    }
+    emit1(MIR_JMP, 8, mir_label(loop_label));
+    mir_emit_label(cg->fn, end_label);
+    cg->unrolled_loops++;
+}
+
+void ast_generate_assembly(ASTNode *node, MirFunction *fn)
+{
+    if (!node)
+        return;
+
+    cg->fn = fn;
+    switch (node->type)
+    {
+    case AST_INTEGER:
+        emit2(MIR_MOV, 4, mir_imm(node->int_value), reg32(REG_RAX));
+        break;
+
+    case AST_FLOAT:
+    {
+        // 浮点字面量放入常量区，按32位位模式装入 %eax
+        emit2(MIR_MOV, 4, mir_rip(emit_float_literal(node->float_value)), reg32(REG_RAX));
+        break;
+    }
+
+    case AST_STRING:
+        emit2(MIR_LEA, 8, mir_rip(emit_string_literal(node->string_value)), reg64(REG_RAX));
+        break;
+
+    case AST_VARIABLE:
+        emit2(MIR_MOV, 4, variable_operand(node->string_value), reg32(REG_RAX));
+        break;
+
+    case AST_FORMATTED_PRINT:
+        // args[0] 是格式字符串
+        generate_print(node->formatted_print.args, node->formatted_print.arg_count);
+        break;
+
+    case AST_FUNCTION_CALL:
+    {
+        // 用户定义的函数优先于同名的内建函数
+        if (find_function(node->func_call.func_name) == NULL && generate_sort_call(node))
+            break;
+
+        if (strcmp(node->func_call.func_name, "printf") == 0)
         {
-            fprintf(output, "\tcmpl\t%%ecx, %%edx\n");
-            fprintf(output, "\tsetg\t%%al\n");
-            fprintf(output, "\tmovzbl\t%%al, %%eax\n");
+            generate_printf(node->func_call.args, node->func_call.arg_count);
+            break;
         }
-        else if (strcmp(node->binary.op, ">=") == 0)
+
+        FunctionInfo *callee = find_function(node->func_call.func_name);
+        if (callee == NULL)
         {
-            fprintf(output, "\tcmpl\t%%ecx, %%edx\n");
-            fprintf(output, "\tsetge\t%%al\n");
-            fprintf(output, "\tmovzbl\t%%al, %%eax\n");
+            fprintf(stderr, "Error: Unknown function '%s'\n", node->func_call.func_name);
+            exit(1);
         }
-        else if (strcmp(node->binary.op, "==") == 0)
+        if (callee->def->func_def.param_count != node->func_call.arg_count)
         {
-            fprintf(output, "\tcmpl\t%%ecx, %%edx\n");
-            fprintf(output, "\tsete\t%%al\n");
-            fprintf(output, "\tmovzbl\t%%al, %%eax\n");
+            fprintf(stderr, "Error: Function '%s' expects %d arguments, got %d\n", callee->name,
+                    callee->def->func_def.param_count, node->func_call.arg_count);
+            exit(1);
         }
-        else if (strcmp(node->binary.op, "!=") == 0)
+        int *types = malloc((node->func_call.arg_count + 1) * sizeof(int));
+        for (int i = 0; i < node->func_call.arg_count; i++)
         {
-            fprintf(output, "\tcmpl\t%%ecx, %%edx\n");
-            fprintf(output, "\tsetne\t%%al\n");
-            fprintf(output, "\tmovzbl\t%%al, %%eax\n");
+            types[i] = get_type_from_string(callee->def->func_def.params[i]->decl.var_type);
         }
+        generate_call(callee->symbol, node->func_call.args, types, node->func_call.arg_count, false, false);
+        free(types);
+        if (callee->return_type == TYPE_FLOAT)
+            emit2(MIR_MOVD, 4, mir_xmm(0), reg32(REG_RAX));
         break;
+    }
 
-    case AST_DECLARATION_INIT:
-        ast_generate_assembly(node->decl.init_value, output);
+    case AST_ARRAY_DECLARATION:
+    {
+        int type = get_type_from_string(node->array_decl.var_type);
+        HeapArray *heap = find_heap_array(node);
+        if (heap != NULL)
         {
-            int var_offset = add_variable(node->decl.var_name);
-            fprintf(output, "\tmovl\t%%eax, -%d(%%rbp)\n", var_offset);
+            generate_heap_array(node, type, heap->offset);
+            break;
         }
+
+        // 栈帧中的数组用 rep stosq 清零（%rdi 在 Win64 下由被调者保存）
+        int array_size = constant_array_size(node);
+        Variable *array_var = add_array_variable(node->array_decl.var_name, type, array_size);
+        if (mir_target->windows)
+            emit_push(REG_RDI);
+        emit2(MIR_LEA, 8, mir_mem(REG_RBP, -array_var->offset), reg64(REG_RDI));
+        emit2(MIR_MOV, 4, mir_imm((array_size + 1) / 2), reg32(REG_RCX));
+        emit2(MIR_XOR, 4, reg32(REG_RAX), reg32(REG_RAX));
+        mir_emit0(cg->fn, MIR_REP_STOSQ);
+        if (mir_target->windows)
+            emit_pop(REG_RDI);
         break;
+    }
 
-    case AST_ASSIGNMENT:
-        ast_generate_assembly(node->binary.right, output);
+    case AST_MAP_DECLARATION:
+        fprintf(stderr, "Error: map '%s' is not supported by the assembly backend\n",
+                node->map_decl.var_name);
+        exit(1);
+
+    case AST_ARRAY_ACCESS:
+    {
+        Variable *var = generate_array_index(node);
+        emit2(MIR_MOV, 4, array_element(var), reg32(REG_RAX));
+        break;
+    }
+
+    case AST_ARRAY_ASSIGNMENT:
+    {
+        // 先求值右侧并转换为元素类型后保存，再计算下标
+        ASTNode *access = node->array_assignment.array_access;
+        generate_value(node->array_assignment.value, expr_type(access));
+        save_temp();
+        Variable *var = generate_array_index(access);
+        restore_temp();
+        emit2(MIR_MOV, 4, reg32(REG_RAX), array_element(var));
+        break;
+    }
+
+    case AST_BINARY_OP:
+    {
+        if (strcmp(node->binary.op, "&&") == 0 || strcmp(node->binary.op, "||") == 0)
         {
-            int var_offset = get_variable_offset(node->binary.left->string_value);
-            if (var_offset == -1)
-            {
-                fprintf(stderr, "Error: Undefined variable '%s'\n", node->binary.left->string_value);
-                exit(1);
-            }
-            fprintf(output, "\tmovl\t%%eax, -%d(%%rbp)\n", var_offset);
+            generate_logical_op(node);
+            break;
+        }
+        if (expr_type(node->binary.left) == TYPE_FLOAT || expr_type(node->binary.right) == TYPE_FLOAT ||
+            strcmp(node->binary.op, "/") == 0)
+        {
+            generate_float_op(node);
+            break;
+        }
+
+        // 左操作数在 %eax；右操作数是常量或变量时直接作源操作数，否则经临时寄存器放到 %ecx
+        MirOperand right;
+        ast_generate_assembly(node->binary.left, cg->fn);
+        if (!simple_operand(node->binary.right, &right))
+        {
+            save_temp();
+            ast_generate_assembly(node->binary.right, cg->fn);
+            emit2(MIR_MOV, 4, reg32(REG_RAX), reg32(REG_RCX));
+            restore_temp();
+            right = reg32(REG_RCX);
         }
+
+        MirCond cond;
+        if (comparison_cond(node->binary.op, &cond))
+        {
+            emit2(MIR_CMP, 4, right, reg32(REG_RAX));
+            mir_emit_setcc(cg->fn, cond, REG_RAX);
+            emit2(MIR_MOVZB, 4, mir_reg(REG_RAX, 1), reg32(REG_RAX));
+        }
+        else if (strcmp(node->binary.op, "+") == 0)
+        {
+            emit2(MIR_ADD, 4, right, reg32(REG_RAX));
+        }
+        else if (strcmp(node->binary.op, "-") == 0)
+        {
+            emit2(MIR_SUB, 4, right, reg32(REG_RAX));
+        }
+        else if (strcmp(node->binary.op, "*") == 0)
+        {
+            emit2(MIR_IMUL, 4, right, reg32(REG_RAX));
+        }
+        else if (strcmp(node->binary.op, "%") == 0)
+        {
+            generate_modulo(right);
+        }
+        break;
+    }
+
+    case AST_DECLARATION:
+    {
+        Variable *var = add_variable(node->decl.var_name, get_type_from_string(node->decl.var_type));
+        emit2(MIR_MOV, 4, mir_imm(0), mir_vreg(var->vreg));
+        break;
+    }
+
+    case AST_DECLARATION_INIT:
+    {
+        int type = get_type_from_string(node->decl.var_type);
+        generate_value(node->decl.init_value, type);
+        Variable *var = add_variable(node->decl.var_name, type);
+        emit2(MIR_MOV, 4, reg32(REG_RAX), mir_vreg(var->vreg));
+        break;
+    }
+
+    case AST_ASSIGNMENT:
+        generate_value(node->binary.right, expr_type(node->binary.left));
+        emit2(MIR_MOV, 4, reg32(REG_RAX), variable_operand(node->binary.left->string_value));
         break;
 
     case AST_IF:
-        ast_generate_assembly(node->if_stmt.cond, output);
-        fprintf(output, "\ttestl\t%%eax, %%eax\n");
-        fprintf(output, "\tje\t.Lelse%d\n", label_count);
-        ast_generate_assembly(node->if_stmt.then_body, output);
-        fprintf(output, "\tjmp\t.Lendif%d\n", label_count);
-        fprintf(output, ".Lelse%d:\n", label_count);
+    {
+        int label = cg->label_count++;
+        const char *else_label = new_label("else", label);
+        const char *end_label = new_label("endif", label);
+        emit_branch_if_false(node->if_stmt.cond, else_label);
+        ast_generate_assembly(node->if_stmt.then_body, cg->fn);
+        emit1(MIR_JMP, 8, mir_label(end_label));
+        mir_emit_label(cg->fn, else_label);
         if (node->if_stmt.else_body)
         {
-            ast_generate_assembly(node->if_stmt.else_body, output);
+            ast_generate_assembly(node->if_stmt.else_body, cg->fn);
         }
-        fprintf(output, ".Lendif%d:\n", label_count);
-        label_count++;
+        mir_emit_label(cg->fn, end_label);
         break;
+    }
 
     case AST_WHILE:
     {
-        int saved_stack_offset = stack_offset;
-        fprintf(output, ".Lwhile%d:\n", label_count);
-        ast_generate_assembly(node->while_loop.cond, output);
-        fprintf(output, "\ttestl\t%%eax, %%eax\n");
-        fprintf(output, "\tjz\t.Lendwhile%d\n", label_count);
-        ast_generate_assembly(node->while_loop.body, output);
-        fprintf(output, "\tjmp\t.Lwhile%d\n", label_count);
-        fprintf(output, ".Lendwhile%d:\n", label_count);
-        stack_offset = saved_stack_offset;
-        label_count++;
+        int label = cg->label_count++;
+        const char *loop_label = new_label("while", label);
+        const char *end_label = new_label("endwhile", label);
+        mir_emit_label(cg->fn, loop_label);
+        emit_branch_if_false(node->while_loop.cond, end_label);
+        ast_generate_assembly(node->while_loop.body, cg->fn);
+        emit1(MIR_JMP, 8, mir_label(loop_label));
+        mir_emit_label(cg->fn, end_label);
         break;
     }
 
     case AST_FOR:
     {
-        int saved_stack_offset = stack_offset;
-        ast_generate_assembly(node->for_loop.init, output);
-        fprintf(output, ".Lfor%d:\n", label_count);
-        ast_generate_assembly(node->for_loop.cond, output);
-        fprintf(output, "\ttestl\t%%eax, %%eax\n");
-        fprintf(output, "\tje\t.Lendfor%d\n", label_count);
-        ast_generate_assembly(node->for_loop.body, output);
-        ast_generate_assembly(node->for_loop.update, output);
-        fprintf(output, "\tjmp\t.Lfor%d\n", label_count);
-        fprintf(output, ".Lendfor%d:\n", label_count);
-        stack_offset = saved_stack_offset;
-        label_count++;
-    }
-    break;
+        int label = cg->label_count++;
+        const char *loop_label = new_label("for", label);
+        const char *end_label = new_label("endfor", label);
+        ast_generate_assembly(node->for_loop.init, cg->fn);
+        // 先尝试向量化，能向量化的循环不再展开（包括次数已知的小循环）
+        UnrollPlan unroll_plan;
+        if (!generate_vector_loop(node) && plan_unroll(node, &unroll_plan))
+        {
+            if (unroll_plan.trips >= 0)
+            {
+                generate_full_unroll(node, &unroll_plan);
+                break;
+            }
+            generate_unrolled_loop(node, &unroll_plan);
+        }
+        mir_emit_label(cg->fn, loop_label);
+        emit_branch_if_false(node->for_loop.cond, end_label);
+        ast_generate_assembly(node->for_loop.body, cg->fn);
+        ast_generate_assembly(node->for_loop.update, cg->fn);
+        emit1(MIR_JMP, 8, mir_label(loop_label));
+        mir_emit_label(cg->fn, end_label);
+        break;
+    }
 
     case AST_BLOCK:
         for (int i = 0; i < node->block.count; i++)
         {
-            ast_generate_assembly(node->block.statements[i], output);
+            ast_generate_assembly(node->block.statements[i], cg->fn);
         }
         break;
 
     case AST_RETURN:
         if (node->binary.left)
         {
-            ast_generate_assembly(node->binary.left, output);
+            generate_value(node->binary.left, cg->return_type);
         }
-        fprintf(output, "\tmovl\t$0, %%eax\n");
-        fprintf(output, "\taddq\t$48, %%rsp\n");
-        fprintf(output, "\tpopq\t%%rbp\n");
-        fprintf(output, "\tret\n");
+        emit1(MIR_JMP, 8, mir_label(cg->return_label));
+        break;
+
+    case AST_FUNCTION_DEF:
+        // 函数体由 generate_function 单独生成
         break;
 
     default:
         break;
     }
+}
+
+// OSR 循环函数 int ml_osr_loop(int *state, int **arrays)：标量从 state 装入虚拟寄存器，
+// 数组元素指针存入栈帧，从条件判断开始继续执行循环，结束后把标量写回 state
+static MirFunction *generate_osr_loop(ASTNode *loop, const OsrLayout *layout)
+{
+    begin_function("ml_osr_loop", false);
+    int state_slot = add_pointer_slot();
+    emit2(MIR_MOV, 8, reg64(mir_target->arg_regs[0]), mir_mem(REG_RBP, -state_slot));
+    for (int i = 0; i < layout->array_count; i++)
+    {
+        Variable *var = new_variable(layout->arrays[i]);
+        var->type = TYPE_INT_ARRAY;
+        var->array_size = layout->array_sizes[i];
+        var->offset = add_pointer_slot();
+        var->heap = true;
+        var->bounds_label = mir_intern(cg->module, ".Losr_bounds_%d", i);
+        emit2(MIR_MOV, 8, mir_mem(mir_target->arg_regs[1], 8 * i), reg64(REG_RAX));
+        emit2(MIR_MOV, 8, reg64(REG_RAX), mir_mem(REG_RBP, -var->offset));
+    }
+    for (int i = 0; i < layout->scalar_count; i++)
+    {
+        Variable *var = add_variable(layout->scalars[i], TYPE_INT);
+        emit2(MIR_MOV, 4, mir_mem(mir_target->arg_regs[0], 4 * i), reg32(REG_RAX));
+        emit2(MIR_MOV, 4, reg32(REG_RAX), mir_vreg(var->vreg));
+    }
+
+    int label = cg->label_count++;
+    const char *loop_label = new_label("osr", label);
+    const char *end_label = new_label("endosr", label);
+    const char *bounds_label = new_label("osr_bounds", label);
+    mir_emit_label(cg->fn, loop_label);
+    if (loop->type == AST_FOR)
+    {
+        emit_branch_if_false(loop->for_loop.cond, end_label);
+        ast_generate_assembly(loop->for_loop.body, cg->fn);
+        ast_generate_assembly(loop->for_loop.update, cg->fn);
+    }
+    else
+    {
+        emit_branch_if_false(loop->while_loop.cond, end_label);
+        ast_generate_assembly(loop->while_loop.body, cg->fn);
+    }
+    emit1(MIR_JMP, 8, mir_label(loop_label));
+
+    // 越界：%ecx 为下标，%edx 为数组大小，记录到 state 后同样写回标量
+    for (int i = 0; i < layout->array_count; i++)
+    {
+        Variable *var = find_variable(layout->arrays[i]);
+        mir_emit_label(cg->fn, var->bounds_label);
+        emit2(MIR_MOV, 4, mir_imm(var->array_size), reg32(REG_RDX));
+        emit1(MIR_JMP, 8, mir_label(bounds_label));
+    }
+    mir_emit_label(cg->fn, bounds_label);
+    emit2(MIR_MOV, 8, mir_mem(REG_RBP, -state_slot), reg64(REG_RAX));
+    emit2(MIR_MOV, 4, mir_imm(1), mir_mem(REG_RAX, 4 * layout->scalar_count));
+    emit2(MIR_MOV, 4, reg32(REG_RCX), mir_mem(REG_RAX, 4 * (layout->scalar_count + 1)));
+    emit2(MIR_MOV, 4, reg32(REG_RDX), mir_mem(REG_RAX, 4 * (layout->scalar_count + 2)));
+
+    mir_emit_label(cg->fn, end_label);
+    emit2(MIR_MOV, 8, mir_mem(REG_RBP, -state_slot), reg64(REG_RCX));
+    for (int i = 0; i < layout->scalar_count; i++)
+    {
+        emit2(MIR_MOV, 4, variable_operand(layout->scalars[i]), reg32(REG_RAX));
+        emit2(MIR_MOV, 4, reg32(REG_RAX), mir_mem(REG_RCX, 4 * i));
+    }
+    emit_return_sequence();
+    return finish_function();
+}
+
+void ast_lower_loop(ASTNode *loop, const OsrLayout *layout, ASTNode **defs, int count, MirModule *mod,
+                    MirFunction **out)
+{
+    CodegenContext ctx;
+    context_init(&ctx, 0, mod);
+    cg = &ctx;
+    module = mod;
+    clear_functions();
+    for (int i = 0; i < count; i++)
+    {
+        add_function(defs[i]);
+    }
+    for (int i = 0; i < count; i++)
+    {
+        out[i] = generate_function(&functions[i]);
+    }
+    out[count] = generate_osr_loop(loop, layout);
+    clear_functions();
+    context_free(&ctx);
+    cg = NULL;
+    module = NULL;
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include "mir.h"
 
 // AST节点类型
 typedef enum {
@@ -28,7 +29,8 @@ typedef enum {
     AST_ARRAY_DECLARATION,
     AST_ARRAY_ACCESS,
     AST_ARRAY_ASSIGNMENT,
-    AST_FUNCTION_DEF
+    AST_FUNCTION_DEF,
+    AST_MAP_DECLARATION
 } ASTNodeType;
 
 // AST节点结构
@@ -49,9 +51,15 @@ typedef struct ASTNode {
         
         struct {
             char* var_name;
+            char* var_type;
             struct ASTNode* size;
         } array_decl;
         
+        struct {
+            char* var_name;
+            struct ASTNode* capacity; // 预留容量提示，可为NULL
+        } map_decl;
+        
         struct {
             char* var_name;
             struct ASTNode* index;
@@ -78,6 +86,7 @@ typedef struct ASTNode {
             struct ASTNode* cond;
             struct ASTNode* update;
             struct ASTNode* body;
+            int unroll; // 源码提示 unroll(N) 的展开倍数，0 表示由编译器决定
         } for_loop;
         
         struct {
@@ -120,15 +129,17 @@ ASTNode *ast_new_string(char *value, int line_no);
 ASTNode *ast_new_variable(char *name, int line_no);
 ASTNode *ast_new_binary_op(char *op, ASTNode *left, ASTNode *right, int line_no);
 ASTNode *ast_new_assignment(ASTNode *var, ASTNode *expr, int line_no);
-ASTNode *ast_new_array_declaration(char *var_name, ASTNode *size, int line_no);
+ASTNode *ast_new_array_declaration(char *var_name, char *var_type, ASTNode *size, int line_no);
+ASTNode *ast_new_map_declaration(char *var_name, ASTNode *capacity, int line_no);
 ASTNode *ast_new_array_access(char *var_name, ASTNode *index, int line_no);
 ASTNode *ast_new_array_assignment(ASTNode *array_access, ASTNode *value, int line_no);
 ASTNode *ast_new_if(ASTNode *cond, ASTNode *then_body, ASTNode *else_body, int line_no);
 ASTNode *ast_new_while(ASTNode *cond, ASTNode *body, int line_no);
 ASTNode *ast_new_for(ASTNode *init, ASTNode *cond, ASTNode *update, ASTNode *body, int line_no);
+ASTNode *ast_set_unroll_hint(ASTNode *loop, int factor, int line_no);
 ASTNode *ast_new_block(ASTNode **statements, int count, int line_no);
-ASTNode *ast_new_declaration(char *var_name, int line_no);
-ASTNode *ast_new_declaration_init(char *var_name, ASTNode *init_value, int line_no);
+ASTNode *ast_new_declaration(char *var_name, char *var_type, int line_no);
+ASTNode *ast_new_declaration_init(char *var_name, char *var_type, ASTNode *init_value, int line_no);
 ASTNode *ast_new_function_call(char *func_name, ASTNode **args, int arg_count, int line_no);
 ASTNode *ast_new_function_def(char *func_name, char *return_type, ASTNode *param_block, ASTNode *body, int line_no);
 ASTNode *ast_new_formatted_print(char *format_string, ASTNode **args, int arg_count, int line_no);
@@ -139,6 +150,51 @@ ASTNode *ast_new_param_declaration(char *var_name, char *var_type, int line_no);
 // AST打印和释放函数
 void ast_print(ASTNode *node, int indent);
 void ast_free(ASTNode *node);
-void ast_generate_assembly(ASTNode *node, FILE *output);
+void ast_generate_assembly(ASTNode *node, MirFunction *fn);
 void ast_write_to_file(ASTNode *node, const char *filename);
+
+// 不经过汇编器，直接编码机器码并输出 ELF64 可重定位目标文件（只支持 linux 目标）；
+// 无法写入时返回 false
+bool ast_write_object(ASTNode *node, const char *filename);
+
+// 把函数定义生成为寄存器分配后的 MIR（不输出汇编），符号为 ml_fn_<函数名>；
+// 被调用的用户函数必须都在 defs 中，out[i] 由调用者用 mir_function_free 释放
+void ast_lower_functions(ASTNode **defs, int count, MirModule *module, MirFunction **out);
+
+// 栈上替换（OSR）循环用到的解释器变量：标量都是 int，数组都是 int[]
+typedef struct
+{
+    const char **scalars;
+    int scalar_count;
+    const char **arrays;
+    const int *array_sizes;
+    int array_count;
+} OsrLayout;
+
+// 把循环生成为 int ml_osr_loop(int *state, int **arrays)：state 依次为各标量、
+// 状态（1 表示数组越界）、越界下标和数组大小，arrays 为各数组的元素指针；
+// 循环从条件判断开始执行，结束后标量写回 state。out[count] 为循环函数，其余同 ast_lower_functions
+void ast_lower_loop(ASTNode *loop, const OsrLayout *layout, ASTNode **defs, int count, MirModule *module,
+                    MirFunction **out);
+
+// 代码生成目标："win64"（Windows x64）或 "linux"（System V AMD64），默认与宿主平台一致
+int ast_set_target(const char *name);
+const char *ast_target_name(void);
+
+// 数组循环的自动向量化（SSE2，每次4个元素），默认开启
+void ast_set_vectorize(bool enabled);
+// 最近一次生成的模块中向量化的循环个数
+int ast_vectorized_loops(void);
+
+// 循环展开，默认开启：次数是小常量的循环完全展开，其他循环按倍数部分展开。
+// factor 为没有源码提示的循环使用的倍数，0（默认）按循环体大小选择
+#define UNROLL_MAX_FACTOR 64
+void ast_set_unroll(bool enabled);
+void ast_set_unroll_factor(int factor);
+// 最近一次生成的模块中展开的循环个数
+int ast_unrolled_loops(void);
+
+// 生成汇编/目标文件时并行生成函数的线程数，0（默认）为环境变量 MYLANG_JOBS 或处理器个数；
+// 输出与线程数无关
+void ast_set_jobs(int jobs);
 #endif // AST_H
\ No newline at end of file
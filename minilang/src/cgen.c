@@ -0,0 +1,1406 @@
+#include "cgen.h"
+#include "symbol.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 没有写大小的数组与汇编后端一致，按12个元素分配
+#define CGEN_DEFAULT_ARRAY_SIZE 12
+
+// 函数内超过这个元素个数的数组放到堆上，避免递归时撑爆栈；顶层数组是 static，不受限制
+#define CGEN_STACK_ARRAY_LIMIT 4096
+
+typedef struct
+{
+    const char *name;
+    int type;
+    int array_size; // 常量大小的 C 数组；0 表示运行时在堆上分配，大小存放在 v_<名字>_size
+    bool param;
+} CVar;
+
+typedef struct
+{
+    MirBuffer *out;
+    bool bounds_checks;
+    bool exported; // 函数不加 static，供 dlopen 后按名字查找
+    ASTNode **functions;
+    int function_count;
+    int function_capacity;
+
+    // 正在生成的函数（顶层代码为 NULL）及其全部变量：MyLang 的变量在整个函数内可见，
+    // 所以都提升到 C 函数开头声明，声明语句本身变成赋值
+    ASTNode *function;
+    CVar *vars;
+    int var_count;
+    int var_capacity;
+    int indent;
+    int temp_count;
+} CGen;
+
+static void emit_expr(CGen *g, ASTNode *node);
+static void emit_statement(CGen *g, ASTNode *node);
+static int expr_type(CGen *g, ASTNode *node);
+
+static void unsupported(const char *what)
+{
+    fprintf(stderr, "Error: %s is not supported by the C backend\n", what);
+    exit(1);
+}
+
+static const char *type_name(int type)
+{
+    switch (type)
+    {
+    case TYPE_INT:
+        return "int";
+    case TYPE_FLOAT:
+        return "float";
+    case TYPE_STRING:
+        return "string";
+    case TYPE_INT_ARRAY:
+        return "int[]";
+    case TYPE_FLOAT_ARRAY:
+        return "float[]";
+    case TYPE_STRING_ARRAY:
+        return "string[]";
+    case TYPE_MAP:
+        return "map";
+    default:
+        return "function";
+    }
+}
+
+static bool is_array_type(int type)
+{
+    return type == TYPE_INT_ARRAY || type == TYPE_FLOAT_ARRAY;
+}
+
+static int element_type(int array_type)
+{
+    return array_type == TYPE_FLOAT_ARRAY ? TYPE_FLOAT : TYPE_INT;
+}
+
+static const char *c_type(int type)
+{
+    switch (type)
+    {
+    case TYPE_FLOAT:
+    case TYPE_FLOAT_ARRAY:
+        return "float";
+    case TYPE_STRING:
+        return "const char *";
+    default:
+        return "int";
+    }
+}
+
+// 输出“类型 名字”：指针类型的 * 紧贴名字。MyLang 变量加 v_ 前缀，生成的临时变量和函数用 ml_ 前缀
+static void emit_c_declaration(MirBuffer *out, int type, const char *prefix, const char *name)
+{
+    const char *ctype = c_type(type);
+    mir_buffer_printf(out, "%s%s%s%s", ctype, ctype[strlen(ctype) - 1] == '*' ? "" : " ", prefix, name);
+}
+
+static const char *zero_value(int type)
+{
+    switch (type)
+    {
+    case TYPE_FLOAT:
+        return "0.0f";
+    case TYPE_STRING:
+        return "\"\"";
+    default:
+        return "0";
+    }
+}
+
+static void emit_indent(CGen *g)
+{
+    for (int i = 0; i < g->indent; i++)
+    {
+        mir_buffer_printf(g->out, "    ");
+    }
+}
+
+// 输出 C 字符串字面量的内容；printf_format 为 true 时 % 写成 %%
+static void emit_c_chars(MirBuffer *out, const char *text, int length, bool printf_format)
+{
+    for (int i = 0; i < length; i++)
+    {
+        unsigned char c = (unsigned char)text[i];
+        switch (c)
+        {
+        case '"':
+        case '\\':
+        case '?': // 避免三字符组
+            mir_buffer_printf(out, "\\%c", c);
+            break;
+        case '\n':
+            mir_buffer_printf(out, "\\n");
+            break;
+        case '\r':
+            mir_buffer_printf(out, "\\r");
+            break;
+        case '\t':
+            mir_buffer_printf(out, "\\t");
+            break;
+        case '%':
+            mir_buffer_printf(out, printf_format ? "%%%%" : "%%");
+            break;
+        default:
+            if (c < 32 || c >= 127)
+                mir_buffer_printf(out, "\\%03o", c);
+            else
+                mir_buffer_printf(out, "%c", c);
+            break;
+        }
+    }
+}
+
+static void emit_string_literal(CGen *g, const char *text)
+{
+    mir_buffer_printf(g->out, "\"");
+    emit_c_chars(g->out, text, (int)strlen(text), false);
+    mir_buffer_printf(g->out, "\"");
+}
+
+static void emit_float_literal(CGen *g, float value)
+{
+    char text[64];
+    snprintf(text, sizeof(text), "%.9g", value);
+    if (strpbrk(text, ".e") == NULL)
+        strcat(text, ".0");
+    mir_buffer_printf(g->out, "%sf", text);
+}
+
+// ---- 函数与变量 ----
+
+static void add_function(CGen *g, ASTNode *def)
+{
+    for (int i = 0; i < g->function_count; i++)
+    {
+        if (strcmp(g->functions[i]->func_def.func_name, def->func_def.func_name) == 0)
+        {
+            fprintf(stderr, "Error: Function '%s' is defined more than once\n", def->func_def.func_name);
+            exit(1);
+        }
+    }
+
+    int return_type = get_type_from_string(def->func_def.return_type);
+    if (return_type != TYPE_INT && return_type != TYPE_FLOAT && return_type != TYPE_STRING)
+    {
+        fprintf(stderr, "Error: Return type %s of function '%s' is not supported by the C backend\n",
+                def->func_def.return_type, def->func_def.func_name);
+        exit(1);
+    }
+    for (int i = 0; i < def->func_def.param_count; i++)
+    {
+        ASTNode *param = def->func_def.params[i];
+        int type = get_type_from_string(param->decl.var_type);
+        if (type != TYPE_INT && type != TYPE_FLOAT && type != TYPE_STRING)
+        {
+            fprintf(stderr, "Error: Parameter '%s' of type %s is not supported by the C backend\n",
+                    param->decl.var_name, param->decl.var_type);
+            exit(1);
+        }
+    }
+
+    if (g->function_count >= g->function_capacity)
+    {
+        g->function_capacity = g->function_capacity == 0 ? 8 : g->function_capacity * 2;
+        g->functions = realloc(g->functions, g->function_capacity * sizeof(ASTNode *));
+        if (!g->functions)
+        {
+            fprintf(stderr, "Error: Memory allocation failed\n");
+            exit(1);
+        }
+    }
+    g->functions[g->function_count++] = def;
+}
+
+// 函数定义可以出现在任意语句块中，全部提取为 C 的顶层函数
+static void collect_functions(CGen *g, ASTNode *node)
+{
+    if (!node)
+        return;
+
+    switch (node->type)
+    {
+    case AST_FUNCTION_DEF:
+        add_function(g, node);
+        collect_functions(g, node->func_def.body);
+        break;
+    case AST_BLOCK:
+        for (int i = 0; i < node->block.count; i++)
+        {
+            collect_functions(g, node->block.statements[i]);
+        }
+        break;
+    case AST_IF:
+        collect_functions(g, node->if_stmt.then_body);
+        collect_functions(g, node->if_stmt.else_body);
+        break;
+    case AST_WHILE:
+        collect_functions(g, node->while_loop.body);
+        break;
+    case AST_FOR:
+        collect_functions(g, node->for_loop.body);
+        break;
+    default:
+        break;
+    }
+}
+
+static ASTNode *find_function(CGen *g, const char *name)
+{
+    for (int i = 0; i < g->function_count; i++)
+    {
+        if (strcmp(g->functions[i]->func_def.func_name, name) == 0)
+            return g->functions[i];
+    }
+    return NULL;
+}
+
+static CVar *find_var(CGen *g, const char *name)
+{
+    for (int i = 0; i < g->var_count; i++)
+    {
+        if (strcmp(g->vars[i].name, name) == 0)
+            return &g->vars[i];
+    }
+    return NULL;
+}
+
+static void declare_var(CGen *g, const char *name, int type, int array_size, bool param)
+{
+    CVar *var = find_var(g, name);
+    if (var)
+    {
+        if (var->type != type)
+        {
+            fprintf(stderr, "Error: Variable '%s' is declared as both %s and %s; the C backend needs one type per name\n",
+                    name, type_name(var->type), type_name(type));
+            exit(1);
+        }
+        // 同名数组以不同大小重复声明时改为运行时分配
+        if (var->array_size != array_size)
+            var->array_size = 0;
+        return;
+    }
+
+    if (g->var_count >= g->var_capacity)
+    {
+        g->var_capacity = g->var_capacity == 0 ? 16 : g->var_capacity * 2;
+        g->vars = realloc(g->vars, g->var_capacity * sizeof(CVar));
+        if (!g->vars)
+        {
+            fprintf(stderr, "Error: Memory allocation failed\n");
+            exit(1);
+        }
+    }
+    g->vars[g->var_count].name = name;
+    g->vars[g->var_count].type = type;
+    g->vars[g->var_count].array_size = array_size;
+    g->vars[g->var_count].param = param;
+    g->var_count++;
+}
+
+// 数组声明的常量大小；大小是表达式或数组太大而不适合放在栈上时返回0
+static int constant_array_size(CGen *g, ASTNode *decl)
+{
+    ASTNode *size = decl->array_decl.size;
+    if (size == NULL)
+        return CGEN_DEFAULT_ARRAY_SIZE;
+    if (size->type != AST_INTEGER)
+        return 0;
+    if (size->int_value <= 0)
+    {
+        fprintf(stderr, "Error: Array size must be positive\n");
+        exit(1);
+    }
+    if (g->function != NULL && size->int_value > CGEN_STACK_ARRAY_LIMIT)
+        return 0;
+    return size->int_value;
+}
+
+static void collect_variables(CGen *g, ASTNode *node)
+{
+    if (!node)
+        return;
+
+    switch (node->type)
+    {
+    case AST_BLOCK:
+        for (int i = 0; i < node->block.count; i++)
+        {
+            collect_variables(g, node->block.statements[i]);
+        }
+        break;
+    case AST_DECLARATION:
+    case AST_DECLARATION_INIT:
+        declare_var(g, node->decl.var_name, get_type_from_string(node->decl.var_type), 0, false);
+        break;
+    case AST_ARRAY_DECLARATION:
+    {
+        int type = get_type_from_string(node->array_decl.var_type);
+        if (!is_array_type(type))
+            unsupported("string[] array");
+        declare_var(g, node->array_decl.var_name, type, constant_array_size(g, node), false);
+        break;
+    }
+    case AST_MAP_DECLARATION:
+        unsupported("map");
+        break;
+    case AST_IF:
+        collect_variables(g, node->if_stmt.then_body);
+        collect_variables(g, node->if_stmt.else_body);
+        break;
+    case AST_WHILE:
+        collect_variables(g, node->while_loop.body);
+        break;
+    case AST_FOR:
+        collect_variables(g, node->for_loop.body);
+        break;
+    default:
+        break;
+    }
+}
+
+static CVar *lookup_var(CGen *g, const char *name)
+{
+    CVar *var = find_var(g, name);
+    if (var == NULL)
+    {
+        fprintf(stderr, "Error: Undefined variable '%s'\n", name);
+        exit(1);
+    }
+    return var;
+}
+
+static CVar *scalar_var(CGen *g, const char *name)
+{
+    CVar *var = lookup_var(g, name);
+    if (is_array_type(var->type))
+    {
+        fprintf(stderr, "Error: Array '%s' cannot be used as a value\n", name);
+        exit(1);
+    }
+    return var;
+}
+
+static CVar *array_var(CGen *g, const char *name)
+{
+    CVar *var = find_var(g, name);
+    if (var == NULL)
+    {
+        fprintf(stderr, "Error: Undefined array '%s'\n", name);
+        exit(1);
+    }
+    if (!is_array_type(var->type))
+    {
+        fprintf(stderr, "Error: '%s' is not an array\n", name);
+        exit(1);
+    }
+    return var;
+}
+
+static void emit_array_size(CGen *g, const CVar *var)
+{
+    if (var->array_size > 0)
+        mir_buffer_printf(g->out, "%d", var->array_size);
+    else
+        mir_buffer_printf(g->out, "v_%s_size", var->name);
+}
+
+// ---- 表达式 ----
+
+static bool is_sort_builtin(const char *name)
+{
+    return strcmp(name, "sort") == 0 || strcmp(name, "sort_desc") == 0 || strcmp(name, "sort_by") == 0;
+}
+
+static int binary_type(CGen *g, ASTNode *node)
+{
+    const char *op = node->binary.op;
+    int left = expr_type(g, node->binary.left);
+    int right = expr_type(g, node->binary.right);
+
+    if (left == TYPE_STRING || right == TYPE_STRING)
+    {
+        if (strcmp(op, "+") == 0)
+            unsupported("String concatenation");
+        fprintf(stderr, "Error: Operator '%s' on strings is not supported by the C backend\n", op);
+        exit(1);
+    }
+
+    if (strcmp(op, "+") == 0 || strcmp(op, "-") == 0 || strcmp(op, "*") == 0)
+        return (left == TYPE_FLOAT || right == TYPE_FLOAT) ? TYPE_FLOAT : TYPE_INT;
+    // 与解释器一致，除法的结果总是浮点数
+    if (strcmp(op, "/") == 0)
+        return TYPE_FLOAT;
+    if (strcmp(op, "%") == 0)
+    {
+        if (left != TYPE_INT || right != TYPE_INT)
+        {
+            fprintf(stderr, "Error: Operator %% needs int operands in the C backend\n");
+            exit(1);
+        }
+        return TYPE_INT;
+    }
+    if (strcmp(op, "<") == 0 || strcmp(op, "<=") == 0 || strcmp(op, ">") == 0 || strcmp(op, ">=") == 0 ||
+        strcmp(op, "==") == 0 || strcmp(op, "!=") == 0 || strcmp(op, "&&") == 0 || strcmp(op, "||") == 0)
+        return TYPE_INT;
+
+    fprintf(stderr, "Error: Unknown operator %s\n", op);
+    exit(1);
+}
+
+static int expr_type(CGen *g, ASTNode *node)
+{
+    switch (node->type)
+    {
+    case AST_INTEGER:
+        return TYPE_INT;
+    case AST_FLOAT:
+        return TYPE_FLOAT;
+    case AST_STRING:
+        return TYPE_STRING;
+    case AST_VARIABLE:
+        return scalar_var(g, node->string_value)->type;
+    case AST_ASSIGNMENT:
+        return scalar_var(g, node->binary.left->string_value)->type;
+    case AST_ARRAY_ACCESS:
+        return element_type(array_var(g, node->array_access.var_name)->type);
+    case AST_ARRAY_ASSIGNMENT:
+        return element_type(array_var(g, node->array_assignment.array_access->array_access.var_name)->type);
+    case AST_BINARY_OP:
+        return binary_type(g, node);
+    case AST_FUNCTION_CALL:
+    {
+        const char *name = node->func_call.func_name;
+        if (strcmp(name, "printf") == 0 || (is_sort_builtin(name) && find_function(g, name) == NULL))
+            return TYPE_INT;
+        ASTNode *def = find_function(g, name);
+        if (def == NULL)
+        {
+            fprintf(stderr, "Error: Unknown function '%s'\n", name);
+            exit(1);
+        }
+        return get_type_from_string(def->func_def.return_type);
+    }
+    default:
+    {
+        char what[64];
+        snprintf(what, sizeof(what), "Expression node type %d", node->type);
+        unsupported(what);
+        return TYPE_INT;
+    }
+    }
+}
+
+// 按目标类型输出表达式：int 与 float 之间显式转换，字符串不能与数值互相转换
+static void emit_expr_as(CGen *g, ASTNode *node, int type)
+{
+    int actual = expr_type(g, node);
+    if (actual == type)
+    {
+        emit_expr(g, node);
+        return;
+    }
+    if (actual == TYPE_STRING || type == TYPE_STRING)
+    {
+        fprintf(stderr, "Error: Cannot convert %s to %s in the C backend\n", type_name(actual), type_name(type));
+        exit(1);
+    }
+    mir_buffer_printf(g->out, "(%s)(", c_type(type));
+    emit_expr(g, node);
+    mir_buffer_printf(g->out, ")");
+}
+
+static void emit_element(CGen *g, ASTNode *access)
+{
+    CVar *var = array_var(g, access->array_access.var_name);
+    mir_buffer_printf(g->out, "v_%s[", var->name);
+    if (g->bounds_checks)
+    {
+        mir_buffer_printf(g->out, "ml_index(");
+        emit_expr_as(g, access->array_access.index, TYPE_INT);
+        mir_buffer_printf(g->out, ", ");
+        emit_array_size(g, var);
+        mir_buffer_printf(g->out, ")");
+    }
+    else
+    {
+        emit_expr_as(g, access->array_access.index, TYPE_INT);
+    }
+    mir_buffer_printf(g->out, "]");
+}
+
+static void emit_binary(CGen *g, ASTNode *node, bool parens)
+{
+    const char *op = node->binary.op;
+    binary_type(g, node);
+
+    if (strcmp(op, "/") == 0)
+    {
+        mir_buffer_printf(g->out, "ml_div(");
+        emit_expr_as(g, node->binary.left, TYPE_FLOAT);
+        mir_buffer_printf(g->out, ", ");
+        emit_expr_as(g, node->binary.right, TYPE_FLOAT);
+        mir_buffer_printf(g->out, ")");
+    }
+    else if (strcmp(op, "%") == 0)
+    {
+        mir_buffer_printf(g->out, "ml_mod(");
+        emit_expr(g, node->binary.left);
+        mir_buffer_printf(g->out, ", ");
+        emit_expr(g, node->binary.right);
+        mir_buffer_printf(g->out, ")");
+    }
+    else
+    {
+        // 混合运算按 C 的常规转换提升为 float，与解释器相同
+        mir_buffer_printf(g->out, parens ? "(" : "");
+        emit_expr(g, node->binary.left);
+        mir_buffer_printf(g->out, " %s ", op);
+        emit_expr(g, node->binary.right);
+        mir_buffer_printf(g->out, parens ? ")" : "");
+    }
+}
+
+static CVar *sort_array_argument(CGen *g, ASTNode *call, int index)
+{
+    ASTNode *arg = call->func_call.args[index];
+    if (arg == NULL || arg->type != AST_VARIABLE)
+    {
+        fprintf(stderr, "Error: %s expects an array variable as argument %d\n", call->func_call.func_name, index + 1);
+        exit(1);
+    }
+    CVar *var = find_var(g, arg->string_value);
+    if (var == NULL || !is_array_type(var->type))
+    {
+        fprintf(stderr, "Error: '%s' is not an int[] or float[] array\n", arg->string_value);
+        exit(1);
+    }
+    return var;
+}
+
+// sort/sort_desc/sort_by 调用运行时库 libmlrt，表达式的值为0
+static void emit_sort_call(CGen *g, ASTNode *node)
+{
+    const char *name = node->func_call.func_name;
+    bool keyed = strcmp(name, "sort_by") == 0;
+    int expected = keyed ? 2 : 1;
+    if (node->func_call.arg_count != expected)
+    {
+        fprintf(stderr, "Error: %s function expects exactly %d argument(s)\n", name, expected);
+        exit(1);
+    }
+
+    CVar *arr = sort_array_argument(g, node, 0);
+    if (keyed)
+    {
+        CVar *keys = sort_array_argument(g, node, 1);
+        mir_buffer_printf(g->out, "ml_sort_status(ml_sort_by_key(v_%s, v_%s, ml_same_size(", arr->name, keys->name);
+        emit_array_size(g, arr);
+        mir_buffer_printf(g->out, ", ");
+        emit_array_size(g, keys);
+        mir_buffer_printf(g->out, ", \"%s\", \"%s\"), %d, 0), \"%s\")", arr->name, keys->name,
+                          keys->type == TYPE_FLOAT_ARRAY, arr->name);
+    }
+    else
+    {
+        mir_buffer_printf(g->out, "ml_sort_status(%s(v_%s, ",
+                          arr->type == TYPE_FLOAT_ARRAY ? "ml_sort_float" : "ml_sort_int", arr->name);
+        emit_array_size(g, arr);
+        mir_buffer_printf(g->out, ", %d), \"%s\")", strcmp(name, "sort_desc") == 0, arr->name);
+    }
+}
+
+// print/printf 的一个格式说明符取用的实参及输出方式：'d' 按 int，'f' 按 double，'s' 字符串
+typedef struct
+{
+    int arg;
+    char conversion;
+} PrintArg;
+
+// 按解释器的规则在编译时把格式字符串展开为 C 的格式串（写入 fmt，含引号）：%d/%i 把 float 截断为 int，
+// %f 把 int 转为浮点数，%s 遇到数值时按 %d 或 %f 输出；%% 和未知说明符也会取走一个实参，
+// 实参不足时说明符原样输出。返回用到的实参个数
+static int translate_format(MirBuffer *fmt, const char *format, const int *types, int arg_count, PrintArg *used)
+{
+    int format_len = (int)strlen(format);
+    int arg_index = 0;
+    int used_count = 0;
+
+    mir_buffer_printf(fmt, "\"");
+    for (int i = 0; i < format_len; i++)
+    {
+        if (format[i] != '%' || i + 1 >= format_len)
+        {
+            emit_c_chars(fmt, &format[i], 1, true);
+            continue;
+        }
+
+        i++;
+        if (arg_index >= arg_count)
+        {
+            emit_c_chars(fmt, &format[i - 1], 2, true);
+            continue;
+        }
+
+        int type = types[arg_index];
+        char conversion = 0;
+        switch (format[i])
+        {
+        case 'd':
+        case 'i':
+            conversion = 'd';
+            break;
+        case 'f':
+            conversion = 'f';
+            break;
+        case 's':
+            conversion = type == TYPE_STRING ? 's' : (type == TYPE_INT ? 'd' : 'f');
+            break;
+        default:
+            // %% 输出一个 %，其他未知说明符输出说明符字符
+            emit_c_chars(fmt, &format[i], 1, true);
+            break;
+        }
+
+        if (conversion != 0 && type == TYPE_STRING && conversion != 's')
+        {
+            // 字符串按数值输出时为0
+            mir_buffer_printf(fmt, conversion == 'd' ? "0" : "0.000000");
+        }
+        else if (conversion != 0)
+        {
+            mir_buffer_printf(fmt, "%%%c", conversion);
+            used[used_count].arg = arg_index;
+            used[used_count].conversion = conversion;
+            used_count++;
+        }
+        arg_index++;
+    }
+    mir_buffer_printf(fmt, "\"");
+    return used_count;
+}
+
+static bool is_pure_expr(ASTNode *node)
+{
+    switch (node->type)
+    {
+    case AST_INTEGER:
+    case AST_FLOAT:
+    case AST_STRING:
+    case AST_VARIABLE:
+        return true;
+    case AST_BINARY_OP:
+        return is_pure_expr(node->binary.left) && is_pure_expr(node->binary.right);
+    case AST_ARRAY_ACCESS:
+        return is_pure_expr(node->array_access.index);
+    default:
+        return false;
+    }
+}
+
+// 输出 print/printf：args[0] 为格式字符串。解释器先按顺序求出所有实参再输出，
+// 作为语句时有副作用的实参先存入临时变量，保证求值顺序；格式串用不到的实参也要求值
+static void emit_print(CGen *g, ASTNode **args, int count, bool statement)
+{
+    if (count < 1 || args[0] == NULL || args[0]->type != AST_STRING)
+    {
+        fprintf(stderr, "Error: printf first argument must be a format string\n");
+        exit(1);
+    }
+
+    int arg_count = count - 1;
+    int *types = malloc((arg_count + 1) * sizeof(int));
+    PrintArg *used = malloc((arg_count + 1) * sizeof(PrintArg));
+    bool *consumed = calloc(arg_count + 1, sizeof(bool));
+    if (!types || !used || !consumed)
+    {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        exit(1);
+    }
+    for (int i = 0; i < arg_count; i++)
+    {
+        types[i] = expr_type(g, args[i + 1]);
+    }
+
+    MirBuffer fmt;
+    memset(&fmt, 0, sizeof(fmt));
+    int used_count = translate_format(&fmt, args[0]->string_value, types, arg_count, used);
+    for (int i = 0; i < used_count; i++)
+    {
+        consumed[used[i].arg] = true;
+    }
+
+    int impure_count = 0;
+    bool impure_unused = false;
+    for (int i = 0; i < arg_count; i++)
+    {
+        if (!is_pure_expr(args[i + 1]))
+        {
+            impure_count++;
+            if (!consumed[i])
+                impure_unused = true;
+        }
+    }
+    bool use_temps = statement && (impure_count > 1 || impure_unused);
+
+    int first_temp = g->temp_count;
+    if (use_temps)
+    {
+        mir_buffer_printf(g->out, "{\n");
+        g->indent++;
+        for (int i = 0; i < arg_count; i++)
+        {
+            emit_indent(g);
+            char temp[32];
+            snprintf(temp, sizeof(temp), "t%d", first_temp + i);
+            emit_c_declaration(g->out, types[i], "ml_", temp);
+            mir_buffer_printf(g->out, " = ");
+            emit_expr(g, args[i + 1]);
+            mir_buffer_printf(g->out, ";\n");
+        }
+        g->temp_count += arg_count;
+        emit_indent(g);
+    }
+
+    if (!statement)
+    {
+        mir_buffer_printf(g->out, "(");
+        for (int i = 0; i < arg_count; i++)
+        {
+            if (!consumed[i] && !is_pure_expr(args[i + 1]))
+            {
+                mir_buffer_printf(g->out, "(void)(");
+                emit_expr(g, args[i + 1]);
+                mir_buffer_printf(g->out, "), ");
+            }
+        }
+    }
+
+    mir_buffer_printf(g->out, "printf(%s", fmt.data);
+    for (int i = 0; i < used_count; i++)
+    {
+        int arg = used[i].arg;
+        const char *cast = "";
+        if (used[i].conversion == 'd' && types[arg] == TYPE_FLOAT)
+            cast = "(int)";
+        else if (used[i].conversion == 'f')
+            cast = "(double)";
+
+        mir_buffer_printf(g->out, ", %s", cast);
+        if (use_temps)
+        {
+            mir_buffer_printf(g->out, "ml_t%d", first_temp + arg);
+        }
+        else
+        {
+            mir_buffer_printf(g->out, "(");
+            emit_expr(g, args[arg + 1]);
+            mir_buffer_printf(g->out, ")");
+        }
+    }
+
+    // 解释器中 print 的值为0
+    mir_buffer_printf(g->out, statement ? ");\n" : "), 0)");
+    if (use_temps)
+    {
+        g->indent--;
+        emit_indent(g);
+        mir_buffer_printf(g->out, "}\n");
+    }
+
+    mir_buffer_free(&fmt);
+    free(types);
+    free(used);
+    free(consumed);
+}
+
+static void emit_call(CGen *g, ASTNode *node)
+{
+    const char *name = node->func_call.func_name;
+    // 用户定义的函数优先于同名的内建函数
+    if (is_sort_builtin(name) && find_function(g, name) == NULL)
+    {
+        emit_sort_call(g, node);
+        return;
+    }
+    if (strcmp(name, "printf") == 0)
+    {
+        emit_print(g, node->func_call.args, node->func_call.arg_count, false);
+        return;
+    }
+
+    ASTNode *def = find_function(g, name);
+    if (def == NULL)
+    {
+        fprintf(stderr, "Error: Unknown function '%s'\n", name);
+        exit(1);
+    }
+    if (def->func_def.param_count != node->func_call.arg_count)
+    {
+        fprintf(stderr, "Error: Function '%s' expects %d arguments, got %d\n", name, def->func_def.param_count,
+                node->func_call.arg_count);
+        exit(1);
+    }
+
+    mir_buffer_printf(g->out, "ml_fn_%s(", name);
+    for (int i = 0; i < node->func_call.arg_count; i++)
+    {
+        if (i > 0)
+            mir_buffer_printf(g->out, ", ");
+        emit_expr_as(g, node->func_call.args[i], get_type_from_string(def->func_def.params[i]->decl.var_type));
+    }
+    mir_buffer_printf(g->out, ")");
+}
+
+// parens 为 false 时省略最外层的括号（语句、条件和函数实参中）
+static void emit_expr_parens(CGen *g, ASTNode *node, bool parens)
+{
+    switch (node->type)
+    {
+    case AST_INTEGER:
+        mir_buffer_printf(g->out, "%d", node->int_value);
+        break;
+    case AST_FLOAT:
+        emit_float_literal(g, node->float_value);
+        break;
+    case AST_STRING:
+        emit_string_literal(g, node->string_value);
+        break;
+    case AST_VARIABLE:
+        mir_buffer_printf(g->out, "v_%s", scalar_var(g, node->string_value)->name);
+        break;
+    case AST_ASSIGNMENT:
+    {
+        CVar *var = scalar_var(g, node->binary.left->string_value);
+        mir_buffer_printf(g->out, parens ? "(v_%s = " : "v_%s = ", var->name);
+        emit_expr_as(g, node->binary.right, var->type);
+        mir_buffer_printf(g->out, parens ? ")" : "");
+        break;
+    }
+    case AST_ARRAY_ACCESS:
+        emit_element(g, node);
+        break;
+    case AST_ARRAY_ASSIGNMENT:
+    {
+        ASTNode *access = node->array_assignment.array_access;
+        mir_buffer_printf(g->out, parens ? "(" : "");
+        emit_element(g, access);
+        mir_buffer_printf(g->out, " = ");
+        emit_expr_as(g, node->array_assignment.value, expr_type(g, access));
+        mir_buffer_printf(g->out, parens ? ")" : "");
+        break;
+    }
+    case AST_BINARY_OP:
+        emit_binary(g, node, parens);
+        break;
+    case AST_FUNCTION_CALL:
+        emit_call(g, node);
+        break;
+    default:
+        expr_type(g, node);
+        break;
+    }
+}
+
+static void emit_expr(CGen *g, ASTNode *node)
+{
+    emit_expr_parens(g, node, true);
+}
+
+static void emit_condition(CGen *g, ASTNode *node)
+{
+    if (expr_type(g, node) == TYPE_STRING)
+        unsupported("String condition");
+    emit_expr_parens(g, node, false);
+}
+
+// ---- 语句 ----
+
+// 释放函数内在堆上分配的数组（函数返回前调用）
+static void emit_release_arrays(CGen *g)
+{
+    if (g->function == NULL)
+        return;
+    for (int i = 0; i < g->var_count; i++)
+    {
+        if (is_array_type(g->vars[i].type) && g->vars[i].array_size == 0)
+        {
+            emit_indent(g);
+            mir_buffer_printf(g->out, "free(v_%s);\n", g->vars[i].name);
+        }
+    }
+}
+
+static bool has_heap_arrays(CGen *g)
+{
+    for (int i = 0; i < g->var_count; i++)
+    {
+        if (is_array_type(g->vars[i].type) && g->vars[i].array_size == 0)
+            return true;
+    }
+    return false;
+}
+
+static void emit_array_declaration(CGen *g, ASTNode *node)
+{
+    CVar *var = array_var(g, node->array_decl.var_name);
+    emit_indent(g);
+    if (var->array_size > 0)
+    {
+        // 重复执行声明时与解释器一样重新清零
+        mir_buffer_printf(g->out, "memset(v_%s, 0, sizeof(v_%s));\n", var->name, var->name);
+        return;
+    }
+
+    mir_buffer_printf(g->out, "v_%s_size = ", var->name);
+    if (node->array_decl.size)
+        emit_expr_as(g, node->array_decl.size, TYPE_INT);
+    else
+        mir_buffer_printf(g->out, "%d", CGEN_DEFAULT_ARRAY_SIZE);
+    mir_buffer_printf(g->out, ";\n");
+    emit_indent(g);
+    mir_buffer_printf(g->out, "v_%s = ml_array_alloc(v_%s, v_%s_size, sizeof(%s), \"%s\");\n", var->name, var->name,
+                      var->name, c_type(var->type), var->name);
+}
+
+static void emit_body(CGen *g, ASTNode *node)
+{
+    mir_buffer_printf(g->out, "{\n");
+    g->indent++;
+    emit_statement(g, node);
+    g->indent--;
+    emit_indent(g);
+    mir_buffer_printf(g->out, "}");
+}
+
+static void emit_statement(CGen *g, ASTNode *node)
+{
+    if (!node)
+        return;
+
+    switch (node->type)
+    {
+    case AST_BLOCK:
+        for (int i = 0; i < node->block.count; i++)
+        {
+            emit_statement(g, node->block.statements[i]);
+        }
+        break;
+    case AST_EMPTY:
+    case AST_FUNCTION_DEF:
+        break;
+    case AST_DECLARATION:
+    {
+        CVar *var = scalar_var(g, node->decl.var_name);
+        emit_indent(g);
+        mir_buffer_printf(g->out, "v_%s = %s;\n", var->name, zero_value(var->type));
+        break;
+    }
+    case AST_DECLARATION_INIT:
+    {
+        CVar *var = scalar_var(g, node->decl.var_name);
+        emit_indent(g);
+        mir_buffer_printf(g->out, "v_%s = ", var->name);
+        emit_expr_as(g, node->decl.init_value, var->type);
+        mir_buffer_printf(g->out, ";\n");
+        break;
+    }
+    case AST_ARRAY_DECLARATION:
+        emit_array_declaration(g, node);
+        break;
+    case AST_MAP_DECLARATION:
+        unsupported("map");
+        break;
+    case AST_FORMATTED_PRINT:
+        emit_indent(g);
+        emit_print(g, node->formatted_print.args, node->formatted_print.arg_count, true);
+        break;
+    case AST_IF:
+        emit_indent(g);
+        mir_buffer_printf(g->out, "if (");
+        emit_condition(g, node->if_stmt.cond);
+        mir_buffer_printf(g->out, ")\n");
+        emit_indent(g);
+        emit_body(g, node->if_stmt.then_body);
+        mir_buffer_printf(g->out, "\n");
+        if (node->if_stmt.else_body)
+        {
+            emit_indent(g);
+            mir_buffer_printf(g->out, "else\n");
+            emit_indent(g);
+            emit_body(g, node->if_stmt.else_body);
+            mir_buffer_printf(g->out, "\n");
+        }
+        break;
+    case AST_WHILE:
+        emit_indent(g);
+        mir_buffer_printf(g->out, "while (");
+        emit_condition(g, node->while_loop.cond);
+        mir_buffer_printf(g->out, ")\n");
+        emit_indent(g);
+        emit_body(g, node->while_loop.body);
+        mir_buffer_printf(g->out, "\n");
+        break;
+    case AST_FOR:
+        if (node->for_loop.unroll > 0)
+        {
+            // 源码的展开提示交给 C 编译器（GCC 8 起支持，其他编译器忽略未知的 pragma）
+            emit_indent(g);
+            mir_buffer_printf(g->out, "#pragma GCC unroll %d\n", node->for_loop.unroll);
+        }
+        emit_indent(g);
+        mir_buffer_printf(g->out, "for (");
+        if (node->for_loop.init)
+            emit_expr_parens(g, node->for_loop.init, false);
+        mir_buffer_printf(g->out, "; ");
+        if (node->for_loop.cond)
+            emit_condition(g, node->for_loop.cond);
+        mir_buffer_printf(g->out, "; ");
+        if (node->for_loop.update)
+            emit_expr_parens(g, node->for_loop.update, false);
+        mir_buffer_printf(g->out, ")\n");
+        emit_indent(g);
+        emit_body(g, node->for_loop.body);
+        mir_buffer_printf(g->out, "\n");
+        break;
+    case AST_RETURN:
+    {
+        emit_indent(g);
+        if (g->function == NULL)
+        {
+            // 顶层的 return 只求值，程序继续执行（与解释器一致）
+            emit_expr(g, node->binary.left);
+            mir_buffer_printf(g->out, ";\n");
+            break;
+        }
+        if (!has_heap_arrays(g))
+        {
+            mir_buffer_printf(g->out, "return ");
+            emit_expr_as(g, node->binary.left, get_type_from_string(g->function->func_def.return_type));
+            mir_buffer_printf(g->out, ";\n");
+            break;
+        }
+        // 先求出返回值再释放堆上的数组
+        int type = get_type_from_string(g->function->func_def.return_type);
+        mir_buffer_printf(g->out, "{\n");
+        g->indent++;
+        emit_indent(g);
+        emit_c_declaration(g->out, type, "ml_", "result");
+        mir_buffer_printf(g->out, " = ");
+        emit_expr_as(g, node->binary.left, type);
+        mir_buffer_printf(g->out, ";\n");
+        emit_release_arrays(g);
+        emit_indent(g);
+        mir_buffer_printf(g->out, "return ml_result;\n");
+        g->indent--;
+        emit_indent(g);
+        mir_buffer_printf(g->out, "}\n");
+        break;
+    }
+    case AST_FUNCTION_CALL:
+        emit_indent(g);
+        if (strcmp(node->func_call.func_name, "printf") == 0)
+        {
+            emit_print(g, node->func_call.args, node->func_call.arg_count, true);
+            break;
+        }
+        emit_expr(g, node);
+        mir_buffer_printf(g->out, ";\n");
+        break;
+    default:
+        emit_indent(g);
+        if (node->type != AST_ASSIGNMENT && node->type != AST_ARRAY_ASSIGNMENT)
+        {
+            mir_buffer_printf(g->out, "(void)");
+            emit_expr(g, node);
+        }
+        else
+        {
+            emit_expr_parens(g, node, false);
+        }
+        mir_buffer_printf(g->out, ";\n");
+        break;
+    }
+}
+
+// ---- 函数 ----
+
+static void emit_signature(CGen *g, ASTNode *def)
+{
+    mir_buffer_printf(g->out, g->exported ? "" : "static ");
+    emit_c_declaration(g->out, get_type_from_string(def->func_def.return_type), "ml_fn_", def->func_def.func_name);
+    mir_buffer_printf(g->out, "(");
+    if (def->func_def.param_count == 0)
+        mir_buffer_printf(g->out, "void");
+    for (int i = 0; i < def->func_def.param_count; i++)
+    {
+        ASTNode *param = def->func_def.params[i];
+        mir_buffer_printf(g->out, i > 0 ? ", " : "");
+        emit_c_declaration(g->out, get_type_from_string(param->decl.var_type), "v_", param->decl.var_name);
+    }
+    mir_buffer_printf(g->out, ")");
+}
+
+// 进入函数（顶层代码为 NULL）：收集参数和全部局部变量
+static void begin_scope(CGen *g, ASTNode *def, ASTNode *body)
+{
+    g->function = def;
+    g->var_count = 0;
+    g->temp_count = 0;
+    g->indent = 1;
+    if (def)
+    {
+        for (int i = 0; i < def->func_def.param_count; i++)
+        {
+            ASTNode *param = def->func_def.params[i];
+            declare_var(g, param->decl.var_name, get_type_from_string(param->decl.var_type), 0, true);
+        }
+    }
+    collect_variables(g, body);
+}
+
+static void emit_locals(CGen *g)
+{
+    for (int i = 0; i < g->var_count; i++)
+    {
+        CVar *var = &g->vars[i];
+        if (var->param)
+            continue;
+        emit_indent(g);
+        if (!is_array_type(var->type))
+        {
+            emit_c_declaration(g->out, var->type, "v_", var->name);
+            mir_buffer_printf(g->out, " = %s;\n", zero_value(var->type));
+        }
+        else if (var->array_size > 0)
+        {
+            // 顶层数组是 static，大数组也不占用栈
+            mir_buffer_printf(g->out, "%s%s v_%s[%d];\n", g->function ? "" : "static ", c_type(var->type), var->name,
+                              var->array_size);
+        }
+        else
+        {
+            mir_buffer_printf(g->out, "%s *v_%s = NULL;\n", c_type(var->type), var->name);
+            emit_indent(g);
+            mir_buffer_printf(g->out, "int v_%s_size = 0;\n", var->name);
+        }
+    }
+}
+
+static void emit_function(CGen *g, ASTNode *def)
+{
+    begin_scope(g, def, def->func_def.body);
+    emit_signature(g, def);
+    mir_buffer_printf(g->out, "\n{\n");
+    emit_locals(g);
+    emit_statement(g, def->func_def.body);
+    emit_release_arrays(g);
+    emit_indent(g);
+    mir_buffer_printf(g->out, "return %s;\n}\n\n", zero_value(get_type_from_string(def->func_def.return_type)));
+}
+
+// 生成的程序自带的运行时：下标检查、除法检查和数组分配，错误信息与解释器相同
+static const char *cgen_prelude =
+    "#include <stdio.h>\n"
+    "#include <stdlib.h>\n"
+    "#include <string.h>\n"
+    "\n"
+    "static void ml_fail(const char *message, int index, int size)\n"
+    "{\n"
+    "    fflush(stdout);\n"
+    "    fprintf(stderr, message, index, size);\n"
+    "    exit(1);\n"
+    "}\n"
+    "\n"
+    "static inline int ml_index(int index, int size)\n"
+    "{\n"
+    "    if ((unsigned)index >= (unsigned)size)\n"
+    "        ml_fail(\"Error: Array index out of bounds (index: %d, size: %d)\\n\", index, size);\n"
+    "    return index;\n"
+    "}\n"
+    "\n"
+    "static inline float ml_div(float left, float right)\n"
+    "{\n"
+    "    if (right == 0.0f)\n"
+    "        ml_fail(\"Error: Division by zero\\n\", 0, 0);\n"
+    "    return left / right;\n"
+    "}\n"
+    "\n"
+    "static inline int ml_mod(int left, int right)\n"
+    "{\n"
+    "    if (right == 0)\n"
+    "        ml_fail(\"Error: Division by zero\\n\", 0, 0);\n"
+    "    return right == -1 ? 0 : left % right;\n"
+    "}\n"
+    "\n"
+    "static inline void *ml_array_alloc(void *old, int size, size_t element_size, const char *name)\n"
+    "{\n"
+    "    if (size <= 0)\n"
+    "        ml_fail(\"Error: Array size must be positive\\n\", 0, 0);\n"
+    "    free(old);\n"
+    "    void *data = calloc(size, element_size);\n"
+    "    if (!data)\n"
+    "    {\n"
+    "        fprintf(stderr, \"Error: Memory allocation failed for array %s\\n\", name);\n"
+    "        exit(1);\n"
+    "    }\n"
+    "    return data;\n"
+    "}\n"
+    "\n"
+    "int ml_sort_int(int *data, int n, int descending);\n"
+    "int ml_sort_float(float *data, int n, int descending);\n"
+    "int ml_sort_by_key(void *values, void *keys, int n, int key_is_float, int descending);\n"
+    "\n"
+    "static inline int ml_sort_status(int status, const char *name)\n"
+    "{\n"
+    "    if (status != 0)\n"
+    "    {\n"
+    "        fprintf(stderr, \"Error: Memory allocation failed while sorting '%s'\\n\", name);\n"
+    "        exit(1);\n"
+    "    }\n"
+    "    return 0;\n"
+    "}\n"
+    "\n"
+    "static inline int ml_same_size(int size, int key_size, const char *name, const char *keys)\n"
+    "{\n"
+    "    if (size != key_size)\n"
+    "    {\n"
+    "        fprintf(stderr, \"Error: sort_by arrays '%s' and '%s' differ in size (%d vs %d)\\n\", name, keys, size,\n"
+    "                key_size);\n"
+    "        exit(1);\n"
+    "    }\n"
+    "    return size;\n"
+    "}\n"
+    "\n";
+
+// 先输出全部原型，函数之间可以任意顺序互相调用
+static void emit_functions(CGen *g)
+{
+    for (int i = 0; i < g->function_count; i++)
+    {
+        emit_signature(g, g->functions[i]);
+        mir_buffer_printf(g->out, ";\n");
+    }
+    if (g->function_count > 0)
+        mir_buffer_printf(g->out, "\n");
+
+    for (int i = 0; i < g->function_count; i++)
+    {
+        emit_function(g, g->functions[i]);
+    }
+}
+
+void cgen_generate(ASTNode *root, bool bounds_checks, MirBuffer *out)
+{
+    CGen g;
+    memset(&g, 0, sizeof(g));
+    g.out = out;
+    g.bounds_checks = bounds_checks;
+
+    mir_buffer_printf(out, "/* Generated by the MyLang C backend */\n%s", cgen_prelude);
+    collect_functions(&g, root);
+    emit_functions(&g);
+
+    // 顶层语句
+    begin_scope(&g, NULL, root);
+    mir_buffer_printf(out, "int main(void)\n{\n");
+    emit_locals(&g);
+    emit_statement(&g, root);
+    mir_buffer_printf(out, "    return 0;\n}\n");
+
+    free(g.functions);
+    free(g.vars);
+}
+
+void cgen_generate_functions(ASTNode **defs, int count, MirBuffer *out)
+{
+    CGen g;
+    memset(&g, 0, sizeof(g));
+    g.out = out;
+    g.bounds_checks = true;
+    g.exported = true;
+
+    mir_buffer_printf(out, "/* Generated by the MyLang C backend */\n%s", cgen_prelude);
+    for (int i = 0; i < count; i++)
+    {
+        add_function(&g, defs[i]);
+    }
+    emit_functions(&g);
+    free(g.functions);
+    free(g.vars);
+}
+
+bool cgen_write_file(ASTNode *root, const char *filename, bool bounds_checks)
+{
+    MirBuffer source;
+    memset(&source, 0, sizeof(source));
+    cgen_generate(root, bounds_checks, &source);
+
+    FILE *output = fopen(filename, "w");
+    if (!output)
+    {
+        fprintf(stderr, "Error: Cannot open file %s\n", filename);
+        mir_buffer_free(&source);
+        return false;
+    }
+    bool ok = fwrite(source.data, 1, source.length, output) == source.length;
+    ok = fclose(output) == 0 && ok;
+    if (!ok)
+    {
+        fprintf(stderr, "Error: Failed to write %s\n", filename);
+    }
+    mir_buffer_free(&source);
+    return ok;
+}
+
+// CC 环境变量可以指定其他兼容 gcc 的编译器
+const char *cgen_compiler(void)
+{
+    const char *cc = getenv("CC");
+    return cc == NULL || cc[0] == '\0' ? "gcc" : cc;
+}
+
+bool cgen_compile(const char *c_filename, const char *exe_filename, const char *runtime_lib)
+{
+    // -fwrapv：整数溢出按补码回绕，与解释器和汇编后端一致
+    MirBuffer command;
+    memset(&command, 0, sizeof(command));
+    mir_buffer_printf(&command, "%s -O2 -fwrapv -o \"%s\" \"%s\"", cgen_compiler(), exe_filename, c_filename);
+    if (runtime_lib)
+    {
+#ifdef _WIN32
+        mir_buffer_printf(&command, " \"%s\"", runtime_lib);
+#else
+        mir_buffer_printf(&command, " \"%s\" -pthread", runtime_lib);
+#endif
+    }
+
+    printf("Running: %s\n", command.data);
+    fflush(stdout);
+    int status = system(command.data);
+    mir_buffer_free(&command);
+    if (status != 0)
+    {
+        fprintf(stderr, "Error: %s failed to compile %s\n", cgen_compiler(), c_filename);
+        return false;
+    }
+    return true;
+}
+
+bool cgen_compile_shared(const char *c_filename, const char *so_filename, const char *log_filename)
+{
+    MirBuffer command;
+    memset(&command, 0, sizeof(command));
+    mir_buffer_printf(&command, "%s -shared -fPIC -O2 -fwrapv -o \"%s\" \"%s\" > \"%s\" 2>&1", cgen_compiler(),
+                      so_filename, c_filename, log_filename);
+    int status = system(command.data);
+    mir_buffer_free(&command);
+    return status == 0;
+}
@@ -0,0 +1,29 @@
+#ifndef CGEN_H
+#define CGEN_H
+
+#include "ast.h"
+
+// C 后端（提前编译）：把整个程序翻译为可移植的 C 源码，再由系统的 gcc -O2 生成可执行文件。
+// 声明的类型决定 C 变量的类型；函数为 ml_fn_<函数名>，顶层语句放入 main；
+// int[]/float[] 映射为 C 数组，下标检查可关闭；print 展开为 printf，排序内建函数调用 libmlrt
+
+// 生成的 C 源码追加到 out；程序使用 C 后端不支持的特性时报错退出
+void cgen_generate(ASTNode *root, bool bounds_checks, MirBuffer *out);
+
+// 只生成给定的函数（不含 main），函数导出为 ml_fn_<函数名>，用于编译为共享库；
+// 函数调用的用户函数必须都在 defs 中
+void cgen_generate_functions(ASTNode **defs, int count, MirBuffer *out);
+
+// 生成 C 源码并写入文件；无法写入时返回 false
+bool cgen_write_file(ASTNode *root, const char *filename, bool bounds_checks);
+
+// 用 gcc -O2 把 C 文件编译链接为可执行文件；runtime_lib 为 libmlrt.a 的路径，可为 NULL
+bool cgen_compile(const char *c_filename, const char *exe_filename, const char *runtime_lib);
+
+// 用 gcc -shared -fPIC -O2 编译为共享库，编译器输出写入 log_filename；不输出任何信息，可在后台线程中调用
+bool cgen_compile_shared(const char *c_filename, const char *so_filename, const char *log_filename);
+
+// 使用的 C 编译器：环境变量 CC，默认 gcc
+const char *cgen_compiler(void);
+
+#endif // CGEN_H
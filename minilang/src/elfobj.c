@@ -0,0 +1,325 @@
+#include "elfobj.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 不依赖宿主的 <elf.h>，Windows 上同样可以输出；所有字段按小端写入
+
+#define ELF_HEADER_SIZE 64
+#define ELF_SECTION_HEADER_SIZE 64
+#define ELF_SYMBOL_SIZE 24
+#define ELF_RELA_SIZE 24
+
+#define SHT_PROGBITS 1
+#define SHT_SYMTAB 2
+#define SHT_STRTAB 3
+#define SHT_RELA 4
+
+#define SHF_ALLOC 0x2
+#define SHF_EXECINSTR 0x4
+#define SHF_INFO_LINK 0x40
+
+#define STB_LOCAL 0
+#define STB_GLOBAL 1
+#define STT_NOTYPE 0
+#define STT_FUNC 2
+#define STT_SECTION 3
+#define STT_FILE 4
+#define SHN_UNDEF 0
+#define SHN_ABS 0xfff1
+
+#define R_X86_64_PC32 2
+#define R_X86_64_PLT32 4
+
+// 节的编号
+enum
+{
+    SEC_NULL,
+    SEC_TEXT,
+    SEC_RODATA,
+    SEC_RELA_TEXT,
+    SEC_SYMTAB,
+    SEC_STRTAB,
+    SEC_SHSTRTAB,
+    SEC_NOTE_STACK,
+    SEC_COUNT
+};
+
+// 符号表中固定的前几项：空符号、文件名、.text 和 .rodata 的节符号
+enum
+{
+    SYM_NULL,
+    SYM_FILE,
+    SYM_TEXT,
+    SYM_RODATA,
+    SYM_FIXED_COUNT
+};
+
+typedef struct
+{
+    const char *name;
+    uint32_t type;
+    uint64_t flags;
+    uint64_t offset;
+    uint64_t size;
+    uint32_t link;
+    uint32_t info;
+    uint64_t align;
+    uint64_t entsize;
+} ElfSection;
+
+// 外部符号：按首次引用的顺序编号
+typedef struct
+{
+    const char **names;
+    int count;
+    int capacity;
+} ExternList;
+
+static void put_u8(MirBuffer *out, unsigned value)
+{
+    unsigned char byte = (unsigned char)value;
+    mir_buffer_append(out, &byte, 1);
+}
+
+static void put_u16(MirBuffer *out, unsigned value)
+{
+    put_u8(out, value & 0xff);
+    put_u8(out, (value >> 8) & 0xff);
+}
+
+static void put_u32(MirBuffer *out, uint32_t value)
+{
+    put_u16(out, value & 0xffff);
+    put_u16(out, value >> 16);
+}
+
+static void put_u64(MirBuffer *out, uint64_t value)
+{
+    put_u32(out, (uint32_t)value);
+    put_u32(out, (uint32_t)(value >> 32));
+}
+
+static void align_to(MirBuffer *out, size_t align)
+{
+    while (out->length % align != 0)
+    {
+        put_u8(out, 0);
+    }
+}
+
+// 字符串表：返回名字的偏移（第一个字节是空串）
+static uint32_t add_string(MirBuffer *table, const char *name)
+{
+    if (table->length == 0)
+        put_u8(table, 0);
+    uint32_t offset = (uint32_t)table->length;
+    mir_buffer_append(table, name, strlen(name) + 1);
+    return offset;
+}
+
+static void put_symbol(MirBuffer *out, uint32_t name, int bind, int type, unsigned section, uint64_t value,
+                       uint64_t size)
+{
+    put_u32(out, name);
+    put_u8(out, (bind << 4) | type);
+    put_u8(out, 0);
+    put_u16(out, section);
+    put_u64(out, value);
+    put_u64(out, size);
+}
+
+static int extern_index(ExternList *externs, const char *name)
+{
+    for (int i = 0; i < externs->count; i++)
+    {
+        if (strcmp(externs->names[i], name) == 0)
+            return i;
+    }
+    if (externs->count >= externs->capacity)
+    {
+        externs->capacity = externs->capacity == 0 ? 8 : externs->capacity * 2;
+        externs->names = realloc(externs->names, externs->capacity * sizeof(const char *));
+    }
+    externs->names[externs->count] = name;
+    return externs->count++;
+}
+
+// 函数内标签（.L 开头）不进入符号表，与汇编器一致
+static bool is_local_function(const X86Symbol *symbol)
+{
+    return symbol->is_function && !symbol->global;
+}
+
+bool elf_write_object(const char *filename, const char *source_name, const X86Code *code,
+                      const MirModule *module)
+{
+    MirBuffer strtab, symtab, rela;
+    memset(&strtab, 0, sizeof(strtab));
+    memset(&symtab, 0, sizeof(symtab));
+    memset(&rela, 0, sizeof(rela));
+    ExternList externs = {NULL, 0, 0};
+
+    // 先收集外部符号，重定位需要它们在符号表中的编号
+    for (int i = 0; i < code->reloc_count; i++)
+    {
+        if (mir_rodata_offset(module, code->relocs[i].symbol) < 0)
+            extern_index(&externs, code->relocs[i].symbol);
+    }
+
+    // 符号表：局部符号在前，sh_info 为第一个全局符号的编号
+    put_symbol(&symtab, 0, STB_LOCAL, STT_NOTYPE, SHN_UNDEF, 0, 0);
+    put_symbol(&symtab, add_string(&strtab, source_name), STB_LOCAL, STT_FILE, SHN_ABS, 0, 0);
+    put_symbol(&symtab, 0, STB_LOCAL, STT_SECTION, SEC_TEXT, 0, 0);
+    put_symbol(&symtab, 0, STB_LOCAL, STT_SECTION, SEC_RODATA, 0, 0);
+    int symbol_count = SYM_FIXED_COUNT;
+    for (int i = 0; i < code->symbol_count; i++)
+    {
+        const X86Symbol *symbol = &code->symbols[i];
+        if (!is_local_function(symbol))
+            continue;
+        put_symbol(&symtab, add_string(&strtab, symbol->name), STB_LOCAL, STT_FUNC, SEC_TEXT, symbol->offset,
+                   symbol->size);
+        symbol_count++;
+    }
+    int first_global = symbol_count;
+    for (int i = 0; i < code->symbol_count; i++)
+    {
+        const X86Symbol *symbol = &code->symbols[i];
+        if (!symbol->is_function || !symbol->global)
+            continue;
+        put_symbol(&symtab, add_string(&strtab, symbol->name), STB_GLOBAL, STT_FUNC, SEC_TEXT, symbol->offset,
+                   symbol->size);
+        symbol_count++;
+    }
+    int first_extern = symbol_count;
+    for (int i = 0; i < externs.count; i++)
+    {
+        put_symbol(&symtab, add_string(&strtab, externs.names[i]), STB_GLOBAL, STT_NOTYPE, SHN_UNDEF, 0, 0);
+    }
+
+    // 只读数据按 .rodata 节符号加偏移引用；addend 已含从字段末尾到下一条指令的距离
+    for (int i = 0; i < code->reloc_count; i++)
+    {
+        const X86Reloc *reloc = &code->relocs[i];
+        int data_offset = mir_rodata_offset(module, reloc->symbol);
+        uint64_t symbol_index;
+        uint32_t type;
+        int64_t addend = reloc->addend;
+        if (data_offset >= 0)
+        {
+            symbol_index = SYM_RODATA;
+            type = R_X86_64_PC32;
+            addend += data_offset;
+        }
+        else
+        {
+            symbol_index = first_extern + extern_index(&externs, reloc->symbol);
+            type = reloc->kind == X86_RELOC_CALL ? R_X86_64_PLT32 : R_X86_64_PC32;
+        }
+        put_u64(&rela, reloc->offset);
+        put_u64(&rela, symbol_index << 32 | type);
+        put_u64(&rela, (uint64_t)addend);
+    }
+
+    ElfSection sections[SEC_COUNT];
+    memset(sections, 0, sizeof(sections));
+    sections[SEC_TEXT] = (ElfSection){".text", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 0, code->length, 0, 0, 16, 0};
+    sections[SEC_RODATA] =
+        (ElfSection){".rodata", SHT_PROGBITS, SHF_ALLOC, 0, module->rodata_bytes.length, 0, 0, 8, 0};
+    sections[SEC_RELA_TEXT] = (ElfSection){
+        ".rela.text", SHT_RELA, SHF_INFO_LINK, 0, rela.length, SEC_SYMTAB, SEC_TEXT, 8, ELF_RELA_SIZE};
+    sections[SEC_SYMTAB] = (ElfSection){
+        ".symtab", SHT_SYMTAB, 0, 0, symtab.length, SEC_STRTAB, (uint32_t)first_global, 8, ELF_SYMBOL_SIZE};
+    sections[SEC_STRTAB] = (ElfSection){".strtab", SHT_STRTAB, 0, 0, strtab.length, 0, 0, 1, 0};
+    sections[SEC_SHSTRTAB] = (ElfSection){".shstrtab", SHT_STRTAB, 0, 0, 0, 0, 0, 1, 0};
+    // 空的 .note.GNU-stack：不需要可执行栈
+    sections[SEC_NOTE_STACK] = (ElfSection){".note.GNU-stack", SHT_PROGBITS, 0, 0, 0, 0, 0, 1, 0};
+
+    MirBuffer shstrtab;
+    memset(&shstrtab, 0, sizeof(shstrtab));
+    uint32_t section_names[SEC_COUNT] = {0};
+    for (int i = SEC_TEXT; i < SEC_COUNT; i++)
+    {
+        section_names[i] = add_string(&shstrtab, sections[i].name);
+    }
+    sections[SEC_SHSTRTAB].size = shstrtab.length;
+
+    // 文件内容：ELF 头、各节内容、节头表
+    const MirBuffer *contents[SEC_COUNT] = {NULL, NULL, &module->rodata_bytes, &rela, &symtab, &strtab, &shstrtab,
+                                            NULL};
+    MirBuffer out;
+    memset(&out, 0, sizeof(out));
+    for (int i = 0; i < ELF_HEADER_SIZE; i++)
+    {
+        put_u8(&out, 0);
+    }
+    for (int i = SEC_TEXT; i < SEC_COUNT; i++)
+    {
+        align_to(&out, sections[i].align);
+        sections[i].offset = out.length;
+        if (i == SEC_TEXT)
+            mir_buffer_append(&out, code->bytes, code->length);
+        else if (contents[i] && contents[i]->length > 0)
+            mir_buffer_append(&out, contents[i]->data, contents[i]->length);
+    }
+    align_to(&out, 8);
+    uint64_t section_header_offset = out.length;
+    for (int i = 0; i < SEC_COUNT; i++)
+    {
+        put_u32(&out, section_names[i]);
+        put_u32(&out, sections[i].type);
+        put_u64(&out, sections[i].flags);
+        put_u64(&out, 0); // sh_addr
+        put_u64(&out, i == SEC_NULL ? 0 : sections[i].offset);
+        put_u64(&out, sections[i].size);
+        put_u32(&out, sections[i].link);
+        put_u32(&out, sections[i].info);
+        put_u64(&out, sections[i].align);
+        put_u64(&out, sections[i].entsize);
+    }
+
+    // 回填 ELF 头
+    MirBuffer header;
+    memset(&header, 0, sizeof(header));
+    static const unsigned char ident[16] = {0x7f, 'E', 'L', 'F', 2 /* 64 位 */, 1 /* 小端 */, 1 /* 版本 */};
+    mir_buffer_append(&header, ident, sizeof(ident));
+    put_u16(&header, 1);  // ET_REL
+    put_u16(&header, 62); // EM_X86_64
+    put_u32(&header, 1);  // EV_CURRENT
+    put_u64(&header, 0);  // e_entry
+    put_u64(&header, 0);  // e_phoff
+    put_u64(&header, section_header_offset);
+    put_u32(&header, 0); // e_flags
+    put_u16(&header, ELF_HEADER_SIZE);
+    put_u16(&header, 0); // e_phentsize
+    put_u16(&header, 0); // e_phnum
+    put_u16(&header, ELF_SECTION_HEADER_SIZE);
+    put_u16(&header, SEC_COUNT);
+    put_u16(&header, SEC_SHSTRTAB);
+    memcpy(out.data, header.data, ELF_HEADER_SIZE);
+
+    bool ok = false;
+    FILE *file = fopen(filename, "wb");
+    if (!file)
+    {
+        fprintf(stderr, "Error: Cannot open file %s\n", filename);
+    }
+    else
+    {
+        ok = fwrite(out.data, 1, out.length, file) == out.length;
+        ok = fclose(file) == 0 && ok;
+        if (!ok)
+            fprintf(stderr, "Error: Failed to write %s\n", filename);
+    }
+
+    mir_buffer_free(&header);
+    mir_buffer_free(&out);
+    mir_buffer_free(&shstrtab);
+    mir_buffer_free(&strtab);
+    mir_buffer_free(&symtab);
+    mir_buffer_free(&rela);
+    free(externs.names);
+    return ok;
+}
@@ -0,0 +1,16 @@
+#ifndef ELFOBJ_H
+#define ELFOBJ_H
+
+#include "mir.h"
+#include "x86enc.h"
+
+// ELF64 可重定位目标文件输出（x86-64 System V）：.text 为编码后的函数，.rodata 为模块的只读数据，
+// 对只读数据的引用生成 R_X86_64_PC32，对外部函数（printf、exit、运行时库）的调用生成 R_X86_64_PLT32，
+// 之后只需要系统链接器链接
+
+// code 中的内部引用必须已由 x86_resolve_local 填好；source_name 写入 STT_FILE 符号；
+// 无法写入时返回 false
+bool elf_write_object(const char *filename, const char *source_name, const X86Code *code,
+                      const MirModule *module);
+
+#endif // ELFOBJ_H
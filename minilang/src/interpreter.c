@@ -1,4 +1,7 @@
 #include "interpreter.h"
+#include "jit.h"
+#include "map.h"
+#include "runtime/mlrt.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -49,6 +52,639 @@ void free_print_buffer()
     print_buffer_capacity = 0;
 }
 
+// 排序内建函数：sort(arr)、sort_desc(arr)、sort_by(arr, keys)
+static bool is_sort_builtin(const char *name)
+{
+    return strcmp(name, "sort") == 0 || strcmp(name, "sort_desc") == 0 ||
+           strcmp(name, "sort_by") == 0;
+}
+
+// 取内建函数的数组实参（必须是 int[] 或 float[] 变量）
+static Symbol *builtin_array_argument(ASTNode *call, int index)
+{
+    ASTNode *arg = call->func_call.args[index];
+    if (arg == NULL || arg->type != AST_VARIABLE)
+    {
+        fprintf(stderr, "Error: %s expects an array variable as argument %d\n",
+                call->func_call.func_name, index + 1);
+        exit(1);
+    }
+
+    Symbol *sym = find_symbol(arg->string_value);
+    if (sym == NULL)
+    {
+        fprintf(stderr, "Error: Array '%s' not declared\n", arg->string_value);
+        exit(1);
+    }
+    if (sym->type != TYPE_INT_ARRAY && sym->type != TYPE_FLOAT_ARRAY)
+    {
+        fprintf(stderr, "Error: '%s' is not an int[] or float[] array\n", arg->string_value);
+        exit(1);
+    }
+    return sym;
+}
+
+static void interpret_sort_builtin(ASTNode *node)
+{
+    const char *name = node->func_call.func_name;
+    bool keyed = strcmp(name, "sort_by") == 0;
+    int expected = keyed ? 2 : 1;
+    if (node->func_call.arg_count != expected)
+    {
+        fprintf(stderr, "Error: %s function expects exactly %d argument(s)\n", name, expected);
+        exit(1);
+    }
+
+    Symbol *arr = builtin_array_argument(node, 0);
+    int status;
+    if (keyed)
+    {
+        Symbol *keys = builtin_array_argument(node, 1);
+        if (keys->array_size != arr->array_size)
+        {
+            fprintf(stderr, "Error: sort_by arrays '%s' and '%s' differ in size (%d vs %d)\n",
+                    arr->name, keys->name, arr->array_size, keys->array_size);
+            exit(1);
+        }
+        status = ml_sort_by_key(arr->array_data, keys->array_data, arr->array_size,
+                                keys->type == TYPE_FLOAT_ARRAY, 0);
+    }
+    else
+    {
+        int descending = strcmp(name, "sort_desc") == 0;
+        if (arr->type == TYPE_INT_ARRAY)
+        {
+            status = ml_sort_int(arr->array_data, arr->array_size, descending);
+        }
+        else
+        {
+            status = ml_sort_float(arr->array_data, arr->array_size, descending);
+        }
+    }
+
+    if (status != 0)
+    {
+        fprintf(stderr, "Error: Memory allocation failed while sorting '%s'\n", arr->name);
+        exit(1);
+    }
+    printf("Sorted array %s (%d elements)\n", arr->name, arr->array_size);
+}
+
+// 表达式（函数调用、字符串拼接、字符串内建函数）产生的字符串结果，由 interpret_operand 取走
+static MLString expr_result_string;
+static bool expr_result_is_string = false;
+// 函数体内 return 语句产生的字符串返回值
+static MLString return_string;
+static bool has_return_string = false;
+
+// 正在执行的用户函数，循环回边计入它的热度；顶层代码为 NULL
+static ASTNode *current_function_def = NULL;
+
+static bool interpret_operand(ASTNode *node, int *int_result, float *float_result, bool *is_int,
+                              MLString *string_result);
+
+// 接管 value 的引用
+static void set_expr_result_string(MLString value)
+{
+    ml_string_release(&expr_result_string);
+    expr_result_string = value;
+    expr_result_is_string = true;
+}
+
+// 把操作数的文本形式追加到 dst：字符串原样追加，数值按 %d / %f 格式化
+static void append_operand_text(MLString *dst, bool is_string, const MLString *string_value, int int_value,
+                                float float_value, bool is_int)
+{
+    if (is_string)
+    {
+        ml_string_append(dst, ml_string_data(string_value), string_value->length);
+        return;
+    }
+
+    char buffer[64];
+    int length = is_int ? snprintf(buffer, sizeof(buffer), "%d", int_value)
+                        : snprintf(buffer, sizeof(buffer), "%f", float_value);
+    ml_string_append(dst, buffer, length);
+}
+
+// 求值 node 并把文本追加到 dst
+static void append_node_text(MLString *dst, ASTNode *node)
+{
+    int int_value;
+    float float_value;
+    bool is_int;
+    MLString string_value;
+    bool is_string = interpret_operand(node, &int_value, &float_value, &is_int, &string_value);
+    append_operand_text(dst, is_string, &string_value, int_value, float_value, is_int);
+    ml_string_release(&string_value);
+}
+
+// 键为字符串时 key.string_value 持有一个引用，用完需 release_map_key
+static MapKey interpret_map_key(ASTNode *node)
+{
+    MapKey key;
+    float temp_float;
+    bool temp_is_int;
+    key.is_string = interpret_operand(node, &key.int_value, &temp_float, &temp_is_int, &key.string_value);
+    if (key.is_string)
+        key.int_value = 0;
+    return key;
+}
+
+static void release_map_key(MapKey *key)
+{
+    ml_string_release(&key->string_value);
+}
+
+// 数值结果写入 int/float/is_int
+static void load_map_value(Symbol *sym, const MapValue *value, int *int_result, float *float_result, bool *is_int)
+{
+    if (value == NULL)
+    {
+        *is_int = true;
+        *int_result = 0;
+        *float_result = 0.0f;
+        printf("Map access: %s[...] = 0 (missing key)\n", sym->name);
+        return;
+    }
+
+    *is_int = value->type == TYPE_INT;
+    *int_result = value->int_value;
+    *float_result = value->float_value;
+    printf("Map access: %s[...] found (type: %d)\n", sym->name, value->type);
+}
+
+// 求值一个操作数：结果为字符串（字面量、string 变量、string[] 元素、字符串 map 值、
+// 返回 string 的函数调用）时返回true并在 string_result 中持有一个引用，否则按数值求值
+static bool interpret_operand(ASTNode *node, int *int_result, float *float_result, bool *is_int,
+                              MLString *string_result)
+{
+    *string_result = ml_string_empty();
+    if (node == NULL)
+    {
+        ast_interpret_node(node, int_result, float_result, is_int);
+        return false;
+    }
+
+    *is_int = false;
+    *int_result = 0;
+    *float_result = 0.0f;
+
+    if (node->type == AST_STRING)
+    {
+        *string_result = ml_string_from_cstr(node->string_value);
+        return true;
+    }
+
+    if (node->type == AST_VARIABLE)
+    {
+        Symbol *sym = find_symbol(node->string_value);
+        if (sym && sym->type == TYPE_STRING)
+        {
+            *string_result = ml_string_retain(&sym->string_value);
+            return true;
+        }
+    }
+    else if (node->type == AST_ARRAY_ACCESS)
+    {
+        Symbol *sym = find_symbol(node->array_access.var_name);
+        if (sym && sym->array_data && sym->type == TYPE_MAP)
+        {
+            // 键只求值一次
+            MapKey key = interpret_map_key(node->array_access.index);
+            sym = find_symbol(node->array_access.var_name);
+            MapValue *value = map_find(sym->array_data, &key);
+            release_map_key(&key);
+            if (value && value->type == TYPE_STRING)
+            {
+                *string_result = ml_string_retain(&value->string_value);
+                return true;
+            }
+            load_map_value(sym, value, int_result, float_result, is_int);
+            return false;
+        }
+        if (sym && sym->array_data && sym->type == TYPE_STRING_ARRAY)
+        {
+            int index;
+            float temp_float;
+            bool temp_is_int;
+            ast_interpret_node(node->array_access.index, &index, &temp_float, &temp_is_int);
+            if (index < 0 || index >= sym->array_size)
+            {
+                fprintf(stderr, "Error: Array index out of bounds (index: %d, size: %d)\n", index, sym->array_size);
+                exit(1);
+            }
+            *string_result = ml_string_retain(&((MLString *)sym->array_data)[index]);
+            return true;
+        }
+    }
+    else if (node->type == AST_FUNCTION_CALL || node->type == AST_BINARY_OP)
+    {
+        ml_string_release(&expr_result_string);
+        expr_result_is_string = false;
+        ast_interpret_node(node, int_result, float_result, is_int);
+        if (expr_result_is_string)
+        {
+            *string_result = expr_result_string;
+            expr_result_string = ml_string_empty();
+            expr_result_is_string = false;
+            return true;
+        }
+        return false;
+    }
+
+    ast_interpret_node(node, int_result, float_result, is_int);
+    return false;
+}
+
+// map 读取：键不存在时返回0
+static void interpret_map_access(const char *map_name, ASTNode *index, int *int_result, float *float_result,
+                                 bool *is_int)
+{
+    MapKey key = interpret_map_key(index);
+    // 求键过程中符号表可能扩容，重新查找 map
+    Symbol *sym = find_symbol(map_name);
+    load_map_value(sym, map_find(sym->array_data, &key), int_result, float_result, is_int);
+    release_map_key(&key);
+}
+
+// map 写入：先求值，再插入（插入可能触发扩容）
+static void interpret_map_assignment(const char *map_name, ASTNode *index, ASTNode *value_node,
+                                     int *int_result, float *float_result, bool *is_int)
+{
+    Symbol *sym;
+    int value_int;
+    float value_float;
+    bool value_is_int;
+    // 值可能来自同一个 map，插入前已持有引用
+    MLString string_value;
+    bool value_is_string = interpret_operand(value_node, &value_int, &value_float, &value_is_int, &string_value);
+
+    MapKey key = interpret_map_key(index);
+
+    // 求值过程中符号表可能扩容，重新查找 map
+    sym = find_symbol(map_name);
+    Map *map = sym->array_data;
+    MapValue *slot = map_insert(map, &key);
+    if (value_is_string)
+    {
+        map_set_value(slot, TYPE_STRING, 0, 0.0f, &string_value);
+    }
+    else if (value_is_int)
+    {
+        map_set_value(slot, TYPE_INT, value_int, (float)value_int, NULL);
+    }
+    else
+    {
+        map_set_value(slot, TYPE_FLOAT, (int)value_float, value_float, NULL);
+    }
+    printf("Assigned %s[...] (map size: %d)\n", sym->name, map->count);
+
+    ml_string_release(&string_value);
+    release_map_key(&key);
+
+    *is_int = value_is_int;
+    *int_result = value_int;
+    *float_result = value_float;
+}
+
+// map 内建函数：has(m, k)、remove(m, k)、size(m)、reserve(m, n)、capacity(m)
+static bool is_map_builtin(const char *name)
+{
+    return strcmp(name, "has") == 0 || strcmp(name, "remove") == 0 ||
+           strcmp(name, "size") == 0 || strcmp(name, "reserve") == 0 ||
+           strcmp(name, "capacity") == 0;
+}
+
+static int interpret_map_builtin(ASTNode *node)
+{
+    const char *name = node->func_call.func_name;
+    bool takes_key = strcmp(name, "size") != 0 && strcmp(name, "capacity") != 0;
+    int expected = takes_key ? 2 : 1;
+    if (node->func_call.arg_count != expected)
+    {
+        fprintf(stderr, "Error: %s function expects exactly %d argument(s)\n", name, expected);
+        exit(1);
+    }
+
+    ASTNode *arg = node->func_call.args[0];
+    Symbol *sym = (arg && arg->type == AST_VARIABLE) ? find_symbol(arg->string_value) : NULL;
+    if (sym == NULL || sym->type != TYPE_MAP)
+    {
+        fprintf(stderr, "Error: %s expects a map variable as argument 1\n", name);
+        exit(1);
+    }
+    Map *map = sym->array_data;
+
+    if (strcmp(name, "size") == 0)
+        return map->count;
+    if (strcmp(name, "capacity") == 0)
+        return map->capacity;
+
+    if (strcmp(name, "reserve") == 0)
+    {
+        int count;
+        float temp_float;
+        bool temp_is_int;
+        ast_interpret_node(node->func_call.args[1], &count, &temp_float, &temp_is_int);
+        map_reserve(map, count);
+        printf("Reserved map %s for %d entries (capacity: %d)\n", sym->name, count, map->capacity);
+        return map->capacity;
+    }
+
+    MapKey key = interpret_map_key(node->func_call.args[1]);
+    // 求键过程中符号表可能扩容，重新查找 map
+    map = find_symbol(arg->string_value)->array_data;
+    int result = strcmp(name, "has") == 0 ? map_find(map, &key) != NULL : map_remove(map, &key);
+    release_map_key(&key);
+    return result;
+}
+
+// 用户定义的函数优先于同名的内建函数（如 length、find、size），与编译后端一致
+static bool is_user_function(const char *name)
+{
+    Symbol *sym = find_symbol(name);
+    return sym != NULL && sym->is_function && sym->function_def != NULL;
+}
+
+// 取 string 变量实参（append 原地修改它）
+static Symbol *builtin_string_variable(ASTNode *call, int index)
+{
+    ASTNode *arg = call->func_call.args[index];
+    Symbol *sym = (arg && arg->type == AST_VARIABLE) ? find_symbol(arg->string_value) : NULL;
+    if (sym == NULL || sym->type != TYPE_STRING)
+    {
+        fprintf(stderr, "Error: %s expects a string variable as argument %d\n", call->func_call.func_name, index + 1);
+        exit(1);
+    }
+    return sym;
+}
+
+// 字符串内建函数：builder(capacity)、append(s, ...)、to_string(x)、length(s)
+// 查找与切分：find(s, t[, start])、count(s, t)、starts_with(s, t)、split(parts, s, sep)
+static bool is_string_builtin(const char *name)
+{
+    return strcmp(name, "builder") == 0 || strcmp(name, "append") == 0 ||
+           strcmp(name, "to_string") == 0 || strcmp(name, "length") == 0 ||
+           strcmp(name, "find") == 0 || strcmp(name, "count") == 0 ||
+           strcmp(name, "starts_with") == 0 || strcmp(name, "split") == 0;
+}
+
+// 求值必须为字符串的实参，返回值持有一个引用
+static MLString builtin_string_argument(ASTNode *call, int index)
+{
+    int temp_int;
+    float temp_float;
+    bool temp_is_int;
+    MLString value;
+    if (!interpret_operand(call->func_call.args[index], &temp_int, &temp_float, &temp_is_int, &value))
+    {
+        fprintf(stderr, "Error: %s expects a string as argument %d\n", call->func_call.func_name, index + 1);
+        exit(1);
+    }
+    return value;
+}
+
+static void check_builtin_arg_count(ASTNode *call, int min_count, int max_count)
+{
+    int arg_count = call->func_call.arg_count;
+    if (arg_count < min_count || arg_count > max_count)
+    {
+        if (min_count == max_count)
+            fprintf(stderr, "Error: %s function expects exactly %d argument(s)\n", call->func_call.func_name,
+                    min_count);
+        else
+            fprintf(stderr, "Error: %s function expects %d to %d arguments\n", call->func_call.func_name,
+                    min_count, max_count);
+        exit(1);
+    }
+}
+
+// split(parts, s, sep)：按 sep 切分 s，parts（string[] 变量）被替换为各字段，返回字段数
+// 各字段是指向 s 缓冲区的视图，不复制内容
+static int interpret_split_builtin(ASTNode *node)
+{
+    check_builtin_arg_count(node, 3, 3);
+    ASTNode *target = node->func_call.args[0];
+    if (target == NULL || target->type != AST_VARIABLE)
+    {
+        fprintf(stderr, "Error: split expects a string[] variable as argument 1\n");
+        exit(1);
+    }
+
+    MLString source = builtin_string_argument(node, 1);
+    MLString separator = builtin_string_argument(node, 2);
+    const char *sep = ml_string_data(&separator);
+    if (separator.length == 0)
+    {
+        fprintf(stderr, "Error: split separator must not be empty\n");
+        exit(1);
+    }
+
+    // 求值过程中符号表可能扩容，最后再查找目标数组
+    Symbol *sym = find_symbol(target->string_value);
+    if (sym == NULL || sym->type != TYPE_STRING_ARRAY)
+    {
+        fprintf(stderr, "Error: split expects a string[] variable as argument 1\n");
+        exit(1);
+    }
+
+    int field_count = ml_string_count(&source, sep, separator.length) + 1;
+    MLString *fields = malloc(field_count * sizeof(MLString));
+    if (!fields)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for array %s\n", sym->name);
+        exit(1);
+    }
+
+    int start = 0;
+    for (int i = 0; i < field_count; i++)
+    {
+        int end = i + 1 < field_count ? ml_string_find(&source, sep, separator.length, start) : source.length;
+        fields[i] = ml_string_slice(&source, start, end - start);
+        start = end + separator.length;
+    }
+
+    MLString *old_fields = sym->array_data;
+    for (int i = 0; i < sym->array_size; i++)
+    {
+        ml_string_release(&old_fields[i]);
+    }
+    free(old_fields);
+    sym->array_data = fields;
+    sym->array_size = field_count;
+
+    ml_string_release(&source);
+    ml_string_release(&separator);
+    printf("Split into %s (%d fields)\n", sym->name, field_count);
+    return field_count;
+}
+
+// find / count / starts_with：返回下标、次数或0/1
+static int interpret_search_builtin(ASTNode *node)
+{
+    const char *name = node->func_call.func_name;
+    bool is_find = strcmp(name, "find") == 0;
+    check_builtin_arg_count(node, 2, is_find ? 3 : 2);
+
+    MLString haystack = builtin_string_argument(node, 0);
+    MLString needle = builtin_string_argument(node, 1);
+    const char *needle_data = ml_string_data(&needle);
+
+    int result;
+    if (is_find)
+    {
+        int start = 0;
+        if (node->func_call.arg_count == 3)
+        {
+            float temp_float;
+            bool temp_is_int;
+            ast_interpret_node(node->func_call.args[2], &start, &temp_float, &temp_is_int);
+        }
+        result = ml_string_find(&haystack, needle_data, needle.length, start);
+    }
+    else if (strcmp(name, "count") == 0)
+    {
+        result = ml_string_count(&haystack, needle_data, needle.length);
+    }
+    else
+    {
+        result = ml_string_starts_with(&haystack, needle_data, needle.length);
+    }
+
+    ml_string_release(&haystack);
+    ml_string_release(&needle);
+    printf("Builtin %s returned: %d\n", name, result);
+    return result;
+}
+
+// 返回 string 的内建函数把结果放入 expr_result_string
+static int interpret_string_builtin(ASTNode *node)
+{
+    const char *name = node->func_call.func_name;
+    int arg_count = node->func_call.arg_count;
+
+    if (strcmp(name, "split") == 0)
+        return interpret_split_builtin(node);
+    if (strcmp(name, "find") == 0 || strcmp(name, "count") == 0 || strcmp(name, "starts_with") == 0)
+        return interpret_search_builtin(node);
+
+    if (strcmp(name, "append") == 0)
+    {
+        if (arg_count < 2)
+        {
+            fprintf(stderr, "Error: append function expects at least 2 arguments\n");
+            exit(1);
+        }
+        const char *var_name = builtin_string_variable(node, 0)->name;
+        for (int i = 1; i < arg_count; i++)
+        {
+            int int_value;
+            float float_value;
+            bool is_int;
+            MLString string_value;
+            bool is_string = interpret_operand(node->func_call.args[i], &int_value, &float_value, &is_int,
+                                               &string_value);
+            // 求值过程中符号表可能扩容，重新查找
+            Symbol *sym = find_symbol(var_name);
+            append_operand_text(&sym->string_value, is_string, &string_value, int_value, float_value, is_int);
+            ml_string_release(&string_value);
+        }
+        Symbol *sym = find_symbol(var_name);
+        printf("Appended to %s (length: %d)\n", var_name, sym->string_value.length);
+        return sym->string_value.length;
+    }
+
+    if (arg_count != 1)
+    {
+        fprintf(stderr, "Error: %s function expects exactly 1 argument\n", name);
+        exit(1);
+    }
+
+    if (strcmp(name, "length") == 0)
+    {
+        int temp_int;
+        float temp_float;
+        bool temp_is_int;
+        MLString string_value;
+        if (!interpret_operand(node->func_call.args[0], &temp_int, &temp_float, &temp_is_int, &string_value))
+        {
+            fprintf(stderr, "Error: length expects a string argument\n");
+            exit(1);
+        }
+        int length = string_value.length;
+        ml_string_release(&string_value);
+        return length;
+    }
+
+    if (strcmp(name, "builder") == 0)
+    {
+        // 预留容量的空串：之后的 append 在容量内不再分配
+        int capacity;
+        float temp_float;
+        bool temp_is_int;
+        ast_interpret_node(node->func_call.args[0], &capacity, &temp_float, &temp_is_int);
+        set_expr_result_string(ml_string_with_capacity(capacity));
+        printf("Created string builder (capacity: %d)\n", capacity);
+        return 0;
+    }
+
+    // to_string：字符串原样返回（共享缓冲区），数值转为文本
+    MLString result = ml_string_empty();
+    append_node_text(&result, node->func_call.args[0]);
+    set_expr_result_string(result);
+    return 0;
+}
+
+// s = s + a + b ... 形式的赋值：直接在 s 上追加，s 独占缓冲区时不复制已有内容
+static bool is_append_chain(const char *var_name, ASTNode *expr)
+{
+    if (expr == NULL || expr->type != AST_BINARY_OP || strcmp(expr->binary.op, "+") != 0)
+        return false;
+
+    ASTNode *left = expr->binary.left;
+    if (left->type == AST_VARIABLE && strcmp(left->string_value, var_name) == 0)
+    {
+        Symbol *sym = find_symbol(var_name);
+        return sym != NULL && sym->type == TYPE_STRING;
+    }
+    return is_append_chain(var_name, left);
+}
+
+static void interpret_append_chain(const char *var_name, ASTNode *expr)
+{
+    if (expr->binary.left->type == AST_BINARY_OP)
+    {
+        interpret_append_chain(var_name, expr->binary.left);
+    }
+
+    int int_value;
+    float float_value;
+    bool is_int;
+    MLString string_value;
+    bool is_string = interpret_operand(expr->binary.right, &int_value, &float_value, &is_int, &string_value);
+    Symbol *sym = find_symbol(var_name);
+    append_operand_text(&sym->string_value, is_string, &string_value, int_value, float_value, is_int);
+    ml_string_release(&string_value);
+}
+
+// 与编译后端一致，int 和 float 变量保持声明的类型：float 值存入 int 变量时向零截断，
+// int 值存入 float 变量时转换为浮点数
+static void convert_to_type(int type, int *int_value, float *float_value, bool *is_int)
+{
+    if (type == TYPE_INT && !*is_int)
+    {
+        *int_value = (int)*float_value;
+        *float_value = (float)*int_value;
+        *is_int = true;
+    }
+    else if (type == TYPE_FLOAT && *is_int)
+    {
+        *float_value = (float)*int_value;
+        *is_int = false;
+    }
+}
+
 // 解释AST节点，返回值通过指针参数传出
 void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, bool *is_int)
 {
@@ -90,27 +726,21 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
         int temp_int;
         float temp_float;
         bool temp_is_int;
-
-        ast_interpret_node(node->decl.init_value, &temp_int, &temp_float, &temp_is_int);
+        MLString string_value;
 
         int type;
-        char *string_value = NULL;
-        if (node->decl.init_value->type == AST_STRING)
+        if (interpret_operand(node->decl.init_value, &temp_int, &temp_float, &temp_is_int, &string_value))
         {
             type = TYPE_STRING;
-            string_value = node->decl.init_value->string_value;
-        }
-        else if (temp_is_int)
-        {
-            type = TYPE_INT;
+            set_symbol_string(node->decl.var_name, ml_string_retain(&string_value));
         }
         else
         {
-            type = TYPE_FLOAT;
+            convert_to_type(get_type_from_string(node->decl.var_type), &temp_int, &temp_float, &temp_is_int);
+            type = temp_is_int ? TYPE_INT : TYPE_FLOAT;
+            set_symbol(node->decl.var_name, temp_int, temp_float, NULL, type, false);
         }
 
-        set_symbol(node->decl.var_name, temp_int, temp_float, string_value, type, false);
-
         // 将返回值传递给调用者
         *int_result = temp_int;
         *float_result = temp_float;
@@ -126,8 +756,10 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
         }
         else
         {
-            printf("Variable %s = \"%s\"\n", node->decl.var_name, string_value);
+            printf("Variable %s = \"%.*s\"\n", node->decl.var_name, string_value.length,
+                   ml_string_data(&string_value));
         }
+        ml_string_release(&string_value);
         break;
     }
     case AST_ASSIGNMENT:
@@ -136,27 +768,36 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
         float temp_float;
         bool temp_is_int;
 
-        ast_interpret_node(node->binary.right, &temp_int, &temp_float, &temp_is_int);
+        MLString string_value;
         char *var_name = node->binary.left->string_value;
 
-        int type;
-        char *string_value = NULL;
-        if (node->binary.right->type == AST_STRING)
+        if (is_append_chain(var_name, node->binary.right))
         {
-            type = TYPE_STRING;
-            string_value = node->binary.right->string_value;
+            interpret_append_chain(var_name, node->binary.right);
+            Symbol *sym = find_symbol(var_name);
+            printf("Appended to %s (length: %d)\n", var_name, sym->string_value.length);
+            *is_int = false;
+            *int_result = 0;
+            *float_result = 0.0f;
+            break;
         }
-        else if (temp_is_int)
+
+        // 字符串赋值只增加引用计数，不复制内容
+        int type;
+        if (interpret_operand(node->binary.right, &temp_int, &temp_float, &temp_is_int, &string_value))
         {
-            type = TYPE_INT;
+            type = TYPE_STRING;
+            set_symbol_string(var_name, ml_string_retain(&string_value));
         }
         else
         {
-            type = TYPE_FLOAT;
+            Symbol *sym = find_symbol(var_name);
+            if (sym != NULL)
+                convert_to_type(sym->type, &temp_int, &temp_float, &temp_is_int);
+            type = temp_is_int ? TYPE_INT : TYPE_FLOAT;
+            set_symbol(var_name, temp_int, temp_float, NULL, type, false);
         }
 
-        set_symbol(var_name, temp_int, temp_float, string_value, type, false);
-
         if (type == TYPE_INT)
         {
             printf("Assigned %s = %d\n", var_name, temp_int);
@@ -167,8 +808,9 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
         }
         else
         {
-            printf("Assigned %s = \"%s\"\n", var_name, string_value);
+            printf("Assigned %s = \"%.*s\"\n", var_name, string_value.length, ml_string_data(&string_value));
         }
+        ml_string_release(&string_value);
 
         *int_result = temp_int;
         *float_result = temp_float;
@@ -277,7 +919,8 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
         int *int_args = NULL;
         float *float_args = NULL;
         bool *int_flags = NULL;
-        char **string_args = NULL;
+        MLString *string_args = NULL;
+        bool *string_flags = NULL;
 
         if (node->formatted_print.arg_count > 1)
         {
@@ -285,23 +928,13 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
             int_args = malloc(actual_arg_count * sizeof(int));
             float_args = malloc(actual_arg_count * sizeof(float));
             int_flags = malloc(actual_arg_count * sizeof(bool));
-            string_args = malloc(actual_arg_count * sizeof(char *));
+            string_args = calloc(actual_arg_count, sizeof(MLString));
+            string_flags = calloc(actual_arg_count, sizeof(bool));
 
             for (int i = 1; i < node->formatted_print.arg_count; i++)
             {
-                if (node->formatted_print.args[i]->type == AST_STRING)
-                {
-                    int_flags[i - 1] = false;
-                    int_args[i - 1] = 0;
-                    float_args[i - 1] = 0.0f;
-                    string_args[i - 1] = strdup(node->formatted_print.args[i]->string_value);
-                }
-                else
-                {
-                    ast_interpret_node(node->formatted_print.args[i],
-                                       &int_args[i - 1], &float_args[i - 1], &int_flags[i - 1]);
-                    string_args[i - 1] = NULL;
-                }
+                string_flags[i - 1] = interpret_operand(node->formatted_print.args[i], &int_args[i - 1],
+                                                        &float_args[i - 1], &int_flags[i - 1], &string_args[i - 1]);
             }
         }
 
@@ -346,9 +979,9 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
                     }
                     case 's':
                     { // 字符串格式
-                        if (string_args[arg_index])
+                        if (string_flags[arg_index])
                         {
-                            strcat(output, string_args[arg_index]);
+                            strncat(output, ml_string_data(&string_args[arg_index]), string_args[arg_index].length);
                         }
                         else
                         {
@@ -398,10 +1031,10 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
         {
             for (int i = 0; i < (node->formatted_print.arg_count - 1); i++)
             {
-                if (string_args[i])
-                    free(string_args[i]);
+                ml_string_release(&string_args[i]);
             }
             free(string_args);
+            free(string_flags);
         }
 
         // 立即输出结果
@@ -414,6 +1047,33 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
         break;
     }
 
+    case AST_MAP_DECLARATION:
+    {
+        int capacity = 0;
+        if (node->map_decl.capacity)
+        {
+            float temp_float;
+            bool temp_is_int;
+            ast_interpret_node(node->map_decl.capacity, &capacity, &temp_float, &temp_is_int);
+        }
+
+        set_symbol(node->map_decl.var_name, 0, 0.0f, NULL, TYPE_MAP, false);
+        Symbol *sym = find_symbol(node->map_decl.var_name);
+        if (sym->array_data != NULL)
+        {
+            map_free(sym->array_data);
+        }
+        sym->array_data = map_new(capacity);
+        sym->array_size = 0;
+        sym->is_initialized = true;
+
+        printf("Declared map %s (capacity: %d)\n", node->map_decl.var_name,
+               ((Map *)sym->array_data)->capacity);
+        *is_int = true;
+        *int_result = 0;
+        *float_result = 0.0f;
+        break;
+    }
     case AST_ARRAY_DECLARATION:
     {
         int size = 0;
@@ -431,8 +1091,8 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
             }
         }
 
-        // 假设所有数组都是int类型（在实际实现中应该在语法分析时记录类型）
-        int type = TYPE_INT_ARRAY;
+        // 元素类型在语法分析时记录
+        int type = get_type_from_string(node->array_decl.var_type);
         void *array_data = NULL;
 
         if (size > 0)
@@ -446,7 +1106,7 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
                 array_data = calloc(size, sizeof(float));
                 break;
             case TYPE_STRING_ARRAY:
-                array_data = calloc(size, sizeof(char *));
+                array_data = calloc(size, sizeof(MLString)); // 全零即空串
                 break;
             default:
                 fprintf(stderr, "Error: Unknown array type\n");
@@ -492,6 +1152,13 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
             exit(1);
         }
 
+        if (sym->type == TYPE_MAP)
+        {
+            interpret_map_access(node->array_access.var_name, node->array_access.index, int_result, float_result,
+                                 is_int);
+            break;
+        }
+
         int index;
         float temp_float;
         bool temp_is_int;
@@ -527,16 +1194,12 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
             *is_int = false;
             *int_result = 0;
             *float_result = 0.0f;
-            if (((char **)sym->array_data)[index] != NULL)
-            {
-                printf("Array access: %s[%d] = \"%s\"\n", node->array_access.var_name, index,
-                       ((char **)sym->array_data)[index]);
-            }
-            else
-            {
-                printf("Array access: %s[%d] = NULL\n", node->array_access.var_name, index);
-            }
+        {
+            MLString *element = &((MLString *)sym->array_data)[index];
+            printf("Array access: %s[%d] = \"%.*s\"\n", node->array_access.var_name, index, element->length,
+                   ml_string_data(element));
             break;
+        }
         default:
             fprintf(stderr, "Error: '%s' is not an array\n", node->array_access.var_name);
             exit(1);
@@ -571,6 +1234,13 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
             exit(1);
         }
 
+        if (sym->type == TYPE_MAP)
+        {
+            interpret_map_assignment(var_name, node->array_assignment.array_access->array_access.index,
+                                     node->array_assignment.value, int_result, float_result, is_int);
+            break;
+        }
+
         int index;
         float temp_float;
         bool temp_is_int;
@@ -591,7 +1261,11 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
         int value_int;
         float value_float;
         bool value_is_int;
-        ast_interpret_node(node->array_assignment.value, &value_int, &value_float, &value_is_int);
+        MLString value_string;
+        bool value_is_string = interpret_operand(node->array_assignment.value, &value_int, &value_float,
+                                                 &value_is_int, &value_string);
+        // 求值过程中符号表可能扩容，重新查找数组
+        sym = find_symbol(var_name);
 
         switch (sym->type)
         {
@@ -619,15 +1293,12 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
             break;
         case TYPE_STRING_ARRAY:
         {
-            char **str_array = (char **)sym->array_data;
-            if (str_array[index] != NULL)
-            {
-                free(str_array[index]);
-            }
+            MLString *str_array = sym->array_data;
+            ml_string_release(&str_array[index]);
 
-            if (node->array_assignment.value->type == AST_STRING)
+            if (value_is_string)
             {
-                str_array[index] = strdup(node->array_assignment.value->string_value);
+                str_array[index] = ml_string_retain(&value_string);
             }
             else
             {
@@ -640,15 +1311,11 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
                 {
                     snprintf(buffer, sizeof(buffer), "%f", value_float);
                 }
-                str_array[index] = strdup(buffer);
+                str_array[index] = ml_string_from_cstr(buffer);
             }
 
-            if (str_array[index] == NULL)
-            {
-                fprintf(stderr, "Error: Memory allocation failed for string assignment\n");
-                exit(1);
-            }
-            printf("Assigned %s[%d] = \"%s\"\n", var_name, index, str_array[index]);
+            printf("Assigned %s[%d] = \"%.*s\"\n", var_name, index, str_array[index].length,
+                   ml_string_data(&str_array[index]));
             break;
         }
         default:
@@ -656,6 +1323,7 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
             exit(1);
         }
 
+        ml_string_release(&value_string);
         *is_int = value_is_int;
         *int_result = value_int;
         *float_result = value_float;
@@ -663,8 +1331,37 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
     }
     case AST_BINARY_OP:
     {
-        ast_interpret_node(node->binary.left, &left_int, &left_float, &left_is_int);
-        ast_interpret_node(node->binary.right, &right_int, &right_float, &right_is_int);
+        MLString left_string, right_string;
+        bool left_is_string = interpret_operand(node->binary.left, &left_int, &left_float, &left_is_int,
+                                                &left_string);
+        bool right_is_string = interpret_operand(node->binary.right, &right_int, &right_float, &right_is_int,
+                                                 &right_string);
+
+        // 字符串拼接：左操作数是独占的临时串（如 a + b + c 的中间结果）时原地追加
+        if ((left_is_string || right_is_string) && strcmp(node->binary.op, "+") == 0)
+        {
+            MLString result = ml_string_empty();
+            if (left_is_string)
+            {
+                result = left_string;
+                left_string = ml_string_empty();
+            }
+            else
+            {
+                append_operand_text(&result, false, NULL, left_int, left_float, left_is_int);
+            }
+            append_operand_text(&result, right_is_string, &right_string, right_int, right_float, right_is_int);
+            ml_string_release(&right_string);
+
+            printf("String concatenation: length %d\n", result.length);
+            set_expr_result_string(result);
+            *is_int = false;
+            *int_result = 0;
+            *float_result = 0.0f;
+            break;
+        }
+        ml_string_release(&left_string);
+        ml_string_release(&right_string);
 
         *is_int = left_is_int && right_is_int;
 
@@ -725,6 +1422,23 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
             *int_result = (int)*float_result;
             printf("Binary operation: %f / %f = %f\n", left_float, right_float, *float_result);
         }
+        else if (strcmp(node->binary.op, "%") == 0)
+        {
+            // 与 C 后端一致：只接受整数，向零截断；x % -1 为0（避免 INT_MIN % -1 溢出）
+            if (!*is_int)
+            {
+                fprintf(stderr, "Error: Operator %% needs integer operands\n");
+                exit(1);
+            }
+            if (right_int == 0)
+            {
+                fprintf(stderr, "Error: Division by zero\n");
+                exit(1);
+            }
+            *int_result = right_int == -1 ? 0 : left_int % right_int;
+            *float_result = (float)*int_result;
+            printf("Binary operation: %d %% %d = %d\n", left_int, right_int, *int_result);
+        }
         else if (strcmp(node->binary.op, "<") == 0)
         {
             *is_int = true;
@@ -852,6 +1566,15 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
                 break;
 
             ast_interpret_node(node->while_loop.body, int_result, float_result, is_int);
+            jit_count_backedge(node, current_function_def);
+            // 热循环的剩余迭代由本地代码执行
+            if (jit_try_osr(node))
+            {
+                *is_int = true;
+                *int_result = 0;
+                *float_result = 0.0f;
+                break;
+            }
         }
         break;
     }
@@ -870,6 +1593,9 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
             ast_interpret_node(node->for_loop.body, int_result, float_result, is_int);
 
             ast_interpret_node(node->for_loop.update, int_result, float_result, is_int);
+            jit_count_backedge(node, current_function_def);
+            if (jit_try_osr(node))
+                break;
         }
 
         *is_int = true;
@@ -994,16 +1720,18 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
                         }
                         case 's':
                         { // 字符串格式
-                            if (node->func_call.args[arg_index]->type == AST_STRING)
+                            int temp_int;
+                            float temp_float;
+                            bool temp_is_int;
+                            MLString temp_string;
+                            if (interpret_operand(node->func_call.args[arg_index], &temp_int, &temp_float,
+                                                  &temp_is_int, &temp_string))
                             {
-                                strcat(output, node->func_call.args[arg_index]->string_value);
+                                strncat(output, ml_string_data(&temp_string), temp_string.length);
+                                ml_string_release(&temp_string);
                             }
                             else
                             {
-                                int temp_int;
-                                float temp_float;
-                                bool temp_is_int;
-                                ast_interpret_node(node->func_call.args[arg_index], &temp_int, &temp_float, &temp_is_int);
                                 char temp_str[32];
                                 if (temp_is_int)
                                 {
@@ -1047,6 +1775,27 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
             *int_result = 0;
             *float_result = 0.0f;
         }
+        else if (is_string_builtin(node->func_call.func_name) && !is_user_function(node->func_call.func_name))
+        {
+            *int_result = interpret_string_builtin(node);
+            *float_result = (float)*int_result;
+            *is_int = true;
+        }
+        else if (is_map_builtin(node->func_call.func_name) && !is_user_function(node->func_call.func_name))
+        {
+            *int_result = interpret_map_builtin(node);
+            *float_result = (float)*int_result;
+            *is_int = true;
+            printf("Builtin %s returned: %d\n", node->func_call.func_name, *int_result);
+        }
+        else if (is_sort_builtin(node->func_call.func_name) && !is_user_function(node->func_call.func_name))
+        {
+            interpret_sort_builtin(node);
+
+            *is_int = true;
+            *int_result = 0;
+            *float_result = 0.0f;
+        }
         else
         {
 
@@ -1098,8 +1847,12 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
             float *arg_values_float = malloc(node->func_call.arg_count * sizeof(float));
             bool
                 *arg_is_int = malloc(node->func_call.arg_count * sizeof(bool));
+            // 字符串实参按引用传递
+            MLString *arg_strings = calloc(node->func_call.arg_count, sizeof(MLString));
+            bool *arg_is_string = calloc(node->func_call.arg_count, sizeof(bool));
 
-            if (arg_values_int == NULL || arg_values_float == NULL || arg_is_int == NULL)
+            if (arg_values_int == NULL || arg_values_float == NULL || arg_is_int == NULL ||
+                (node->func_call.arg_count > 0 && (arg_strings == NULL || arg_is_string == NULL)))
             {
                 fprintf(stderr, "Error: Memory allocation failed for function arguments\n");
                 exit(1);
@@ -1112,8 +1865,31 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
                     fprintf(stderr, "Error: NULL argument in function call\n");
                     exit(1);
                 }
-                ast_interpret_node(node->func_call.args[i], &arg_values_int[i],
-                                   &arg_values_float[i], &arg_is_int[i]);
+                arg_is_string[i] = interpret_operand(node->func_call.args[i], &arg_values_int[i],
+                                                     &arg_values_float[i], &arg_is_int[i], &arg_strings[i]);
+            }
+
+            // 实参都是整数时，足够热的函数直接执行 JIT 生成的本地代码
+            bool int_arguments = true;
+            for (int i = 0; i < node->func_call.arg_count; i++)
+            {
+                if (arg_is_string[i] || !arg_is_int[i])
+                    int_arguments = false;
+            }
+            int native_result;
+            if (int_arguments && jit_try_call(func_def, arg_values_int, node->func_call.arg_count, &native_result))
+            {
+                free(arg_values_int);
+                free(arg_values_float);
+                free(arg_is_int);
+                free(arg_strings);
+                free(arg_is_string);
+
+                *int_result = native_result;
+                *float_result = (float)native_result;
+                *is_int = true;
+                printf("Function %s returned: %d\n", node->func_call.func_name, native_result);
+                break;
             }
 
             // 保存当前符号表状态
@@ -1176,7 +1952,13 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
 
                 int param_type = get_type_from_string(param_type_str);
 
-                if (arg_is_int[i])
+                if (arg_is_string[i])
+                {
+                    // 引用转移给形参
+                    set_symbol_string(param_name, arg_strings[i]);
+                    arg_strings[i] = ml_string_empty();
+                }
+                else if (arg_is_int[i])
                 {
                     set_symbol(param_name, arg_values_int[i], 0.0f, NULL, param_type, false);
                 }
@@ -1190,8 +1972,27 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
             int func_result_int;
             float func_result_float;
             bool func_result_is_int;
+            bool returns_string = func_sym->type == TYPE_STRING;
+
+            // 外层函数尚未取走的字符串返回值先保存起来
+            MLString outer_return_string = return_string;
+            bool outer_has_return_string = has_return_string;
+            return_string = ml_string_empty();
+            has_return_string = false;
 
+            ASTNode *caller_def = current_function_def;
+            current_function_def = func_def;
             ast_interpret_node(func_def->func_def.body, &func_result_int, &func_result_float, &func_result_is_int);
+            current_function_def = caller_def;
+
+            MLString result_string = return_string;
+            bool result_is_string = has_return_string && returns_string;
+            if (!result_is_string)
+            {
+                ml_string_release(&result_string);
+            }
+            return_string = outer_return_string;
+            has_return_string = outer_has_return_string;
 
             // 将返回值传递给调用者
             *int_result = func_result_int;
@@ -1208,9 +2009,16 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
             free(arg_values_int);
             free(arg_values_float);
             free(arg_is_int);
+            free(arg_strings);
+            free(arg_is_string);
 
             printf("Function %s returned: ", node->func_call.func_name);
-            if (*is_int)
+            if (result_is_string)
+            {
+                printf("\"%.*s\"\n", result_string.length, ml_string_data(&result_string));
+                set_expr_result_string(result_string);
+            }
+            else if (*is_int)
             {
                 printf("%d\n", *int_result);
             }
@@ -1223,7 +2031,15 @@ void ast_interpret_node(ASTNode *node, int *int_result, float *float_result, boo
     }
     case AST_RETURN:
     {
-        ast_interpret_node(node->binary.left, int_result, float_result, is_int);
+        MLString string_value;
+        if (interpret_operand(node->binary.left, int_result, float_result, is_int, &string_value))
+        {
+            ml_string_release(&return_string);
+            return_string = string_value;
+            has_return_string = true;
+            printf("Return \"%.*s\"\n", string_value.length, ml_string_data(&string_value));
+            break;
+        }
         printf("Return ");
         if (*is_int)
         {
@@ -1282,7 +2098,8 @@ void ast_interpret(ASTNode *root)
             printf("%s = %f\n", symbol_table[i].name, symbol_table[i].float_value);
             break;
         case TYPE_STRING:
-            printf("%s = \"%s\"\n", symbol_table[i].name, symbol_table[i].string_value);
+            printf("%s = \"%.*s\"\n", symbol_table[i].name, symbol_table[i].string_value.length,
+                   ml_string_data(&symbol_table[i].string_value));
             break;
         case TYPE_INT_ARRAY:
             printf("%s = int[%d]\n", symbol_table[i].name, symbol_table[i].array_size);
@@ -1293,6 +2110,9 @@ void ast_interpret(ASTNode *root)
         case TYPE_STRING_ARRAY:
             printf("%s = string[%d]\n", symbol_table[i].name, symbol_table[i].array_size);
             break;
+        case TYPE_MAP:
+            printf("%s = map[%d]\n", symbol_table[i].name, ((Map *)symbol_table[i].array_data)->count);
+            break;
         }
     }
 
@@ -1324,6 +2144,9 @@ void ast_interpret(ASTNode *root)
     }
     print_buffer_size = 0;
     print_buffer_capacity = 0;
+
+    ml_string_release(&expr_result_string);
+    expr_result_is_string = false;
 }
 void interpret_assembly_instruction(const char *instruction)
 {
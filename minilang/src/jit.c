@@ -0,0 +1,1148 @@
+#include "jit.h"
+#include "cgen.h"
+#include "symbol.h"
+#include "x86enc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+typedef enum
+{
+    JIT_COLD,      // 解释执行，累计热度
+    JIT_COMPILING, // C 后端正在后台编译，编译完成前继续解释执行
+    JIT_COMPILED,  // 已晋升为本地代码
+    JIT_REJECTED,  // 不符合条件或编译失败，留在解释器
+} JitState;
+
+typedef struct JitCJob JitCJob;
+
+typedef struct
+{
+    ASTNode *def;
+    int calls;     // 解释执行的调用次数
+    int backedges; // 解释执行时函数内循环的回边次数
+    JitState state;
+    void *code;
+    JitCJob *job; // JIT_COMPILING 时所属的后台编译任务
+} JitEntry;
+
+// C 后端缓存文件名中的版本号；生成的 C 代码或编译选项改变时递增，使旧缓存失效
+#define JIT_C_CACHE_VERSION "mylang-jit-c-1"
+
+#ifndef _WIN32
+// 后台编译任务：编译计划生成的 C 源码由 gcc -shared -O2 在线程中编译为共享库，
+// 结果以源码哈希命名保存在缓存目录，之后的运行直接加载
+struct JitCJob
+{
+    ASTNode **defs; // 编译计划，defs[0] 为入口函数
+    int count;
+    char *source;
+    char *stem; // <缓存目录>/ml_<哈希>，共享库为 stem.so
+    pthread_t thread;
+    pthread_mutex_t lock;
+    bool done; // 线程已结束，受 lock 保护
+    bool ok;
+    bool joined;
+    void *handle; // dlopen 句柄
+};
+#endif
+
+typedef enum
+{
+    JIT_BACKEND_X86, // 进程内 x86-64 编码器
+    JIT_BACKEND_C,   // 生成 C 源码交给 gcc，结果按哈希缓存
+} JitBackend;
+
+// 循环回边计数；热循环经栈上替换（OSR）进入本地代码
+typedef struct
+{
+    ASTNode *loop;
+    ASTNode *function_def;
+    int backedges;
+    bool hot;
+    JitState state;
+    void *code;
+    OsrLayout layout; // 循环用到的符号表变量，名字归 AST 所有
+    int osr_entries;
+} JitLoop;
+
+// 一次编译分配的可执行内存
+typedef struct
+{
+    void *memory;
+    size_t size;
+} JitBlock;
+
+static bool jit_enabled = true;
+static int jit_threshold = JIT_DEFAULT_THRESHOLD;
+
+static JitEntry *entries = NULL;
+static int entry_count = 0;
+static int entry_capacity = 0;
+
+static JitLoop *loops = NULL;
+static int loop_count = 0;
+static int loop_capacity = 0;
+
+static JitBlock *blocks = NULL;
+static int block_count = 0;
+static int block_capacity = 0;
+
+static JitBackend jit_backend = JIT_BACKEND_X86;
+static const char *jit_cache_dir = NULL;
+
+#ifndef _WIN32
+static JitCJob **jobs = NULL;
+static int job_count = 0;
+static int job_capacity = 0;
+#endif
+
+void jit_set_enabled(bool enabled)
+{
+    jit_enabled = enabled;
+}
+
+void jit_set_threshold(int threshold)
+{
+    jit_threshold = threshold > 0 ? threshold : 1;
+}
+
+bool jit_set_backend(const char *name)
+{
+    if (strcmp(name, "x86") == 0)
+    {
+        jit_backend = JIT_BACKEND_X86;
+        return true;
+    }
+#ifndef _WIN32
+    if (strcmp(name, "c") == 0)
+    {
+        jit_backend = JIT_BACKEND_C;
+        return true;
+    }
+#endif
+    return false;
+}
+
+void jit_set_cache_dir(const char *dir)
+{
+    jit_cache_dir = dir;
+}
+
+static JitEntry *find_entry(ASTNode *def)
+{
+    for (int i = 0; i < entry_count; i++)
+    {
+        if (entries[i].def == def)
+            return &entries[i];
+    }
+    if (entry_count >= entry_capacity)
+    {
+        entry_capacity = entry_capacity == 0 ? 8 : entry_capacity * 2;
+        entries = realloc(entries, entry_capacity * sizeof(JitEntry));
+        if (!entries)
+        {
+            fprintf(stderr, "Error: Memory allocation failed for JIT entries\n");
+            exit(1);
+        }
+    }
+    JitEntry *entry = &entries[entry_count++];
+    entry->def = def;
+    entry->calls = 0;
+    entry->backedges = 0;
+    entry->state = JIT_COLD;
+    entry->code = NULL;
+    entry->job = NULL;
+    return entry;
+}
+
+// 编译计划：入口函数及其（直接或间接）调用的用户函数，一起编码后内部调用不经过解释器
+typedef struct
+{
+    ASTNode **defs;
+    int count;
+    int capacity;
+    const char *reason; // 不符合条件的原因
+} JitPlan;
+
+// 已声明的标量变量（含参数）；OSR 循环中还有符号表中的 int[] 数组
+typedef struct
+{
+    const char **names;
+    int count;
+    int capacity;
+    const char **arrays;
+    int array_count;
+    bool redeclare; // OSR 循环体中的声明重新初始化符号表中已有的变量
+} JitScope;
+
+static bool reject(JitPlan *plan, const char *reason)
+{
+    if (plan->reason == NULL)
+        plan->reason = reason;
+    return false;
+}
+
+static bool scope_contains(const JitScope *scope, const char *name)
+{
+    for (int i = 0; i < scope->count; i++)
+    {
+        if (strcmp(scope->names[i], name) == 0)
+            return true;
+    }
+    return false;
+}
+
+static void scope_add(JitScope *scope, const char *name)
+{
+    if (scope->count >= scope->capacity)
+    {
+        scope->capacity = scope->capacity == 0 ? 8 : scope->capacity * 2;
+        scope->names = realloc(scope->names, scope->capacity * sizeof(const char *));
+    }
+    scope->names[scope->count++] = name;
+}
+
+static bool scope_contains_array(const JitScope *scope, const char *name)
+{
+    for (int i = 0; i < scope->array_count; i++)
+    {
+        if (strcmp(scope->arrays[i], name) == 0)
+            return true;
+    }
+    return false;
+}
+
+static bool check_function(JitPlan *plan, ASTNode *def);
+
+// 只支持结果为整数、与解释器语义一致的运算（/ 在解释器中是浮点除法）
+static bool is_native_operator(const char *op)
+{
+    static const char *ops[] = {"+", "-", "*", "<", "<=", ">", ">=", "==", "!="};
+    for (size_t i = 0; i < sizeof(ops) / sizeof(ops[0]); i++)
+    {
+        if (strcmp(op, ops[i]) == 0)
+            return true;
+    }
+    return false;
+}
+
+static bool check_expression(JitPlan *plan, JitScope *scope, ASTNode *node)
+{
+    if (node == NULL)
+        return reject(plan, "missing expression");
+
+    switch (node->type)
+    {
+    case AST_INTEGER:
+        return true;
+    case AST_VARIABLE:
+        return scope_contains(scope, node->string_value) || reject(plan, "non-local or undeclared variable");
+    case AST_ARRAY_ACCESS:
+        if (!scope_contains_array(scope, node->array_access.var_name))
+            return reject(plan, "array is not an int[] of the loop");
+        return check_expression(plan, scope, node->array_access.index);
+    case AST_BINARY_OP:
+        if (!is_native_operator(node->binary.op))
+            return reject(plan, "unsupported operator");
+        return check_expression(plan, scope, node->binary.left) && check_expression(plan, scope, node->binary.right);
+    case AST_FUNCTION_CALL:
+    {
+        Symbol *callee = find_symbol(node->func_call.func_name);
+        if (strcmp(node->func_call.func_name, "print") == 0 || strcmp(node->func_call.func_name, "printf") == 0 ||
+            callee == NULL || !callee->is_function || callee->function_def == NULL)
+            return reject(plan, "call to a builtin or unknown function");
+        if (callee->function_def->func_def.param_count != node->func_call.arg_count)
+            return reject(plan, "argument count mismatch");
+        for (int i = 0; i < node->func_call.arg_count; i++)
+        {
+            if (!check_expression(plan, scope, node->func_call.args[i]))
+                return false;
+        }
+        return check_function(plan, callee->function_def);
+    }
+    default:
+        return reject(plan, "unsupported expression");
+    }
+}
+
+static bool check_statement(JitPlan *plan, JitScope *scope, ASTNode *node)
+{
+    if (node == NULL)
+        return true;
+
+    switch (node->type)
+    {
+    case AST_EMPTY:
+        return true;
+    case AST_DECLARATION:
+    case AST_DECLARATION_INIT:
+        if (scope_contains(scope, node->decl.var_name) && !scope->redeclare)
+            return reject(plan, "variable declared twice");
+        if (node->type == AST_DECLARATION_INIT && !check_expression(plan, scope, node->decl.init_value))
+            return false;
+        if (!scope_contains(scope, node->decl.var_name))
+            scope_add(scope, node->decl.var_name);
+        return true;
+    case AST_ASSIGNMENT:
+        if (node->binary.left->type != AST_VARIABLE || !scope_contains(scope, node->binary.left->string_value))
+            return reject(plan, "assignment to a non-local variable");
+        return check_expression(plan, scope, node->binary.right);
+    case AST_ARRAY_ASSIGNMENT:
+        return check_expression(plan, scope, node->array_assignment.value) &&
+               check_expression(plan, scope, node->array_assignment.array_access);
+    case AST_IF:
+        return check_expression(plan, scope, node->if_stmt.cond) &&
+               check_statement(plan, scope, node->if_stmt.then_body) &&
+               check_statement(plan, scope, node->if_stmt.else_body);
+    case AST_WHILE:
+        return check_expression(plan, scope, node->while_loop.cond) &&
+               check_statement(plan, scope, node->while_loop.body);
+    case AST_FOR:
+        return check_statement(plan, scope, node->for_loop.init) &&
+               check_expression(plan, scope, node->for_loop.cond) &&
+               check_statement(plan, scope, node->for_loop.update) &&
+               check_statement(plan, scope, node->for_loop.body);
+    case AST_BLOCK:
+        for (int i = 0; i < node->block.count; i++)
+        {
+            if (!check_statement(plan, scope, node->block.statements[i]))
+                return false;
+        }
+        return true;
+    case AST_RETURN:
+        // 解释器中 return 不会提前结束函数，只有位于函数末尾的 return 与本地代码语义一致
+        return reject(plan, "return before the end of the function");
+    default:
+        return check_expression(plan, scope, node);
+    }
+}
+
+// 参数和返回值都是 int、函数体以 return 结束
+static bool check_function(JitPlan *plan, ASTNode *def)
+{
+    for (int i = 0; i < plan->count; i++)
+    {
+        if (plan->defs[i] == def)
+            return true;
+    }
+    if (plan->count >= plan->capacity)
+    {
+        plan->capacity = plan->capacity == 0 ? 4 : plan->capacity * 2;
+        plan->defs = realloc(plan->defs, plan->capacity * sizeof(ASTNode *));
+    }
+    plan->defs[plan->count++] = def;
+
+    if (def->func_def.return_type == NULL || strcmp(def->func_def.return_type, "int") != 0)
+        return reject(plan, "return type is not int");
+    if (def->func_def.param_count > JIT_MAX_ARGS)
+        return reject(plan, "too many parameters");
+
+    JitScope scope = {NULL, 0, 0, NULL, 0, false};
+    bool ok = true;
+    for (int i = 0; ok && i < def->func_def.param_count; i++)
+    {
+        ASTNode *param = def->func_def.params[i];
+        if (param->type != AST_PARAM_DECLARATION || param->decl.var_type == NULL ||
+            strcmp(param->decl.var_type, "int") != 0)
+            ok = reject(plan, "parameter is not int");
+        else
+            scope_add(&scope, param->decl.var_name);
+    }
+
+    ASTNode *body = def->func_def.body;
+    if (ok && (body == NULL || body->type != AST_BLOCK || body->block.count == 0))
+        ok = reject(plan, "empty function body");
+    if (ok)
+    {
+        ASTNode *last = body->block.statements[body->block.count - 1];
+        if (last->type != AST_RETURN || last->binary.left == NULL)
+            ok = reject(plan, "function does not end with return");
+        for (int i = 0; ok && i < body->block.count - 1; i++)
+        {
+            ok = check_statement(plan, &scope, body->block.statements[i]);
+        }
+        ok = ok && check_expression(plan, &scope, last->binary.left);
+    }
+    free(scope.names);
+    return ok;
+}
+
+// 复制到新分配的内存后改为只读可执行
+static void *alloc_executable(const unsigned char *bytes, size_t size)
+{
+#ifdef _WIN32
+    void *memory = VirtualAlloc(NULL, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (memory == NULL)
+        return NULL;
+    memcpy(memory, bytes, size);
+    DWORD old_protect;
+    if (!VirtualProtect(memory, size, PAGE_EXECUTE_READ, &old_protect))
+    {
+        VirtualFree(memory, 0, MEM_RELEASE);
+        return NULL;
+    }
+    FlushInstructionCache(GetCurrentProcess(), memory, size);
+#else
+    void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+        return NULL;
+    memcpy(memory, bytes, size);
+    if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0)
+    {
+        munmap(memory, size);
+        return NULL;
+    }
+#endif
+
+    if (block_count >= block_capacity)
+    {
+        block_capacity = block_capacity == 0 ? 4 : block_capacity * 2;
+        blocks = realloc(blocks, block_capacity * sizeof(JitBlock));
+    }
+    blocks[block_count].memory = memory;
+    blocks[block_count].size = size;
+    block_count++;
+    return memory;
+}
+
+// 按宿主平台的调用约定生成 MIR 并编码（loop 非 NULL 时再加上 OSR 循环函数）；
+// 成功时返回可执行内存，x86 代码留在 code 中供查找符号
+static void *compile_plan(JitPlan *plan, ASTNode *loop, const OsrLayout *layout, X86Code *code)
+{
+    const TargetInfo *saved_target = mir_target;
+#ifdef _WIN32
+    mir_set_target("win64");
+#else
+    mir_set_target("linux");
+#endif
+
+    MirModule module;
+    mir_module_init(&module);
+    int fn_count = plan->count + (loop ? 1 : 0);
+    MirFunction **fns = malloc(fn_count * sizeof(MirFunction *));
+    if (loop)
+        ast_lower_loop(loop, layout, plan->defs, plan->count, &module, fns);
+    else
+        ast_lower_functions(plan->defs, plan->count, &module, fns);
+
+    bool ok = true;
+    for (int i = 0; i < fn_count; i++)
+    {
+        if (ok && !x86_encode_function(code, fns[i]))
+            ok = reject(plan, "instruction cannot be encoded");
+        mir_function_free(fns[i]);
+    }
+    free(fns);
+    mir_module_free(&module);
+    mir_target = saved_target;
+
+    if (!ok)
+        return NULL;
+    x86_resolve_local(code);
+    if (code->reloc_count > 0)
+    {
+        reject(plan, "reference to an external symbol");
+        return NULL;
+    }
+    void *memory = alloc_executable(code->bytes, code->length);
+    if (memory == NULL)
+        reject(plan, "cannot allocate executable memory");
+    return memory;
+}
+
+static void compile_function(ASTNode *def)
+{
+    JitPlan plan = {NULL, 0, 0, NULL};
+    X86Code code;
+    x86_code_init(&code);
+
+    void *memory = NULL;
+    if (check_function(&plan, def))
+        memory = compile_plan(&plan, NULL, NULL, &code);
+
+    if (memory == NULL)
+    {
+        printf("Tier: %s stays in the interpreter (%s)\n", def->func_def.func_name, plan.reason);
+        find_entry(def)->state = JIT_REJECTED;
+    }
+    else
+    {
+        JitEntry *hot = find_entry(def);
+        printf("Tier: %s promoted to native code (calls: %d, back-edges: %d, %d function(s), %d bytes)\n",
+               def->func_def.func_name, hot->calls, hot->backedges, plan.count, code.length);
+        // 一起编译的被调函数也直接使用本地代码
+        for (int i = 0; i < plan.count; i++)
+        {
+            char symbol[256];
+            snprintf(symbol, sizeof(symbol), "ml_fn_%s", plan.defs[i]->func_def.func_name);
+            const X86Symbol *entry_symbol = x86_find_symbol(&code, symbol);
+            JitEntry *entry = find_entry(plan.defs[i]);
+            if (entry->state == JIT_COMPILED || entry_symbol == NULL)
+                continue;
+            if (plan.defs[i] != def)
+                printf("Tier: %s promoted to native code with its caller %s\n", plan.defs[i]->func_def.func_name,
+                       def->func_def.func_name);
+            entry->state = JIT_COMPILED;
+            entry->code = (unsigned char *)memory + entry_symbol->offset;
+        }
+    }
+
+    x86_code_free(&code);
+    free(plan.defs);
+}
+
+#ifndef _WIN32
+// FNV-1a 64 位哈希：源码、编译器和缓存版本相同的编译结果可以直接复用
+static uint64_t hash_text(uint64_t hash, const char *text)
+{
+    for (const unsigned char *p = (const unsigned char *)text; *p; p++)
+    {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static const char *cache_dir(void)
+{
+    if (jit_cache_dir)
+        return jit_cache_dir;
+    const char *dir = getenv("MYLANG_JIT_CACHE");
+    return dir && dir[0] ? dir : JIT_DEFAULT_CACHE_DIR;
+}
+
+static char *job_path(const JitCJob *job, const char *suffix)
+{
+    size_t size = strlen(job->stem) + strlen(suffix) + 32;
+    char *path = malloc(size);
+    snprintf(path, size, "%s%s", job->stem, suffix);
+    return path;
+}
+
+static char *job_temp_path(const JitCJob *job, const char *suffix)
+{
+    size_t size = strlen(job->stem) + strlen(suffix) + 32;
+    char *path = malloc(size);
+    snprintf(path, size, "%s.%ld%s", job->stem, (long)getpid(), suffix);
+    return path;
+}
+
+// 后台线程：只读写自己的文件，不访问解释器状态
+static void *compile_job(void *arg)
+{
+    JitCJob *job = arg;
+    // 先写入带进程号的临时文件，编译成功后再改名，多个进程共用缓存目录时不会加载到写了一半的共享库
+    char *c_path = job_temp_path(job, ".c");
+    char *temp_so = job_temp_path(job, ".so");
+    char *log_path = job_path(job, ".log");
+    char *so_path = job_path(job, ".so");
+
+    bool ok = false;
+    FILE *file = fopen(c_path, "w");
+    if (file)
+    {
+        ok = fputs(job->source, file) >= 0;
+        ok = fclose(file) == 0 && ok;
+    }
+    ok = ok && cgen_compile_shared(c_path, temp_so, log_path);
+    ok = ok && rename(temp_so, so_path) == 0;
+    remove(c_path);
+    if (ok)
+        remove(log_path);
+    else
+        remove(temp_so);
+
+    free(c_path);
+    free(temp_so);
+    free(log_path);
+    free(so_path);
+
+    pthread_mutex_lock(&job->lock);
+    job->ok = ok;
+    job->done = true;
+    pthread_mutex_unlock(&job->lock);
+    return NULL;
+}
+
+static bool job_done(JitCJob *job)
+{
+    pthread_mutex_lock(&job->lock);
+    bool done = job->done;
+    pthread_mutex_unlock(&job->lock);
+    return done;
+}
+
+// 加载共享库，把计划中仍在等待这次编译的函数切换到本地代码
+static void load_job(JitCJob *job, const char *origin)
+{
+    ASTNode *def = job->defs[0];
+    char *so_path = job_path(job, ".so");
+    job->handle = dlopen(so_path, RTLD_NOW | RTLD_LOCAL);
+    if (job->handle == NULL)
+        printf("Tier: %s stays in the interpreter (cannot load %s: %s)\n", def->func_def.func_name, so_path,
+               dlerror());
+    else
+        printf("Tier: %s promoted to native code (calls: %d, back-edges: %d, %d function(s), %s -O2, %s %s)\n",
+               def->func_def.func_name, find_entry(def)->calls, find_entry(def)->backedges, job->count,
+               cgen_compiler(), origin, so_path);
+
+    for (int i = 0; i < job->count; i++)
+    {
+        JitEntry *entry = find_entry(job->defs[i]);
+        if (entry->job != job)
+            continue;
+        entry->job = NULL;
+        char symbol[256];
+        snprintf(symbol, sizeof(symbol), "ml_fn_%s", job->defs[i]->func_def.func_name);
+        void *code = job->handle ? dlsym(job->handle, symbol) : NULL;
+        if (code == NULL)
+        {
+            entry->state = JIT_REJECTED;
+            continue;
+        }
+        if (job->defs[i] != def)
+            printf("Tier: %s promoted to native code with its caller %s\n", job->defs[i]->func_def.func_name,
+                   def->func_def.func_name);
+        entry->state = JIT_COMPILED;
+        entry->code = code;
+    }
+    free(so_path);
+}
+
+static void finish_job(JitCJob *job)
+{
+    if (job->joined)
+        return;
+    pthread_join(job->thread, NULL);
+    job->joined = true;
+    if (job->ok)
+    {
+        load_job(job, "compiled in the background to");
+        return;
+    }
+
+    char *log_path = job_path(job, ".log");
+    printf("Tier: %s stays in the interpreter (%s failed, see %s)\n", job->defs[0]->func_def.func_name,
+           cgen_compiler(), log_path);
+    free(log_path);
+    for (int i = 0; i < job->count; i++)
+    {
+        JitEntry *entry = find_entry(job->defs[i]);
+        if (entry->job == job)
+        {
+            entry->job = NULL;
+            entry->state = JIT_REJECTED;
+        }
+    }
+}
+
+static JitCJob *new_job(JitPlan *plan)
+{
+    JitCJob *job = calloc(1, sizeof(JitCJob));
+    job->defs = plan->defs;
+    job->count = plan->count;
+    plan->defs = NULL;
+
+    MirBuffer source;
+    memset(&source, 0, sizeof(source));
+    cgen_generate_functions(job->defs, job->count, &source);
+    job->source = source.data;
+
+    uint64_t hash = hash_text(14695981039346656037ULL, JIT_C_CACHE_VERSION);
+    hash = hash_text(hash, cgen_compiler());
+    hash = hash_text(hash, job->source);
+    const char *dir = cache_dir();
+    size_t size = strlen(dir) + 32;
+    job->stem = malloc(size);
+    snprintf(job->stem, size, "%s/ml_%016llx", dir, (unsigned long long)hash);
+    pthread_mutex_init(&job->lock, NULL);
+
+    if (job_count >= job_capacity)
+    {
+        job_capacity = job_capacity == 0 ? 4 : job_capacity * 2;
+        jobs = realloc(jobs, job_capacity * sizeof(JitCJob *));
+    }
+    jobs[job_count++] = job;
+    return job;
+}
+
+// C 后端：命中缓存时直接加载，否则启动后台编译，编译期间函数继续解释执行
+static void compile_function_c(ASTNode *def)
+{
+    JitPlan plan = {NULL, 0, 0, NULL};
+    if (!check_function(&plan, def))
+    {
+        printf("Tier: %s stays in the interpreter (%s)\n", def->func_def.func_name, plan.reason);
+        find_entry(def)->state = JIT_REJECTED;
+        free(plan.defs);
+        return;
+    }
+
+    JitCJob *job = new_job(&plan);
+    for (int i = 0; i < job->count; i++)
+    {
+        JitEntry *entry = find_entry(job->defs[i]);
+        if (entry->state == JIT_COLD)
+        {
+            entry->state = JIT_COMPILING;
+            entry->job = job;
+        }
+    }
+
+    char *so_path = job_path(job, ".so");
+    bool cached = access(so_path, R_OK) == 0;
+    free(so_path);
+    if (cached)
+    {
+        job->done = true;
+        job->ok = true;
+        job->joined = true;
+        load_job(job, "loaded from the C cache");
+        return;
+    }
+
+    mkdir(cache_dir(), 0755);
+    if (pthread_create(&job->thread, NULL, compile_job, job) != 0)
+    {
+        job->joined = true;
+        printf("Tier: %s stays in the interpreter (cannot start the compiler thread)\n", def->func_def.func_name);
+        for (int i = 0; i < job->count; i++)
+        {
+            JitEntry *entry = find_entry(job->defs[i]);
+            if (entry->job == job)
+            {
+                entry->job = NULL;
+                entry->state = JIT_REJECTED;
+            }
+        }
+        return;
+    }
+    printf("Tier: %s compiling in the background (%s -O2, %d function(s))\n", def->func_def.func_name,
+           cgen_compiler(), job->count);
+}
+
+// 退出前等待仍在编译的任务，让结果写入缓存供下次运行使用
+static void free_jobs(void)
+{
+    for (int i = 0; i < job_count; i++)
+    {
+        JitCJob *job = jobs[i];
+        if (!job->joined)
+        {
+            pthread_join(job->thread, NULL);
+            job->joined = true;
+            if (job->ok)
+                printf("Tier: background compile of %s finished after the program ended (cached for the next run)\n",
+                       job->defs[0]->func_def.func_name);
+        }
+        if (job->handle)
+            dlclose(job->handle);
+        pthread_mutex_destroy(&job->lock);
+        free(job->defs);
+        free(job->source);
+        free(job->stem);
+        free(job);
+    }
+    free(jobs);
+    jobs = NULL;
+    job_count = 0;
+    job_capacity = 0;
+}
+#endif
+
+static int call_native(void *code, const int *a, int arg_count)
+{
+    switch (arg_count)
+    {
+    case 0:
+        return ((int (*)(void))code)();
+    case 1:
+        return ((int (*)(int))code)(a[0]);
+    case 2:
+        return ((int (*)(int, int))code)(a[0], a[1]);
+    case 3:
+        return ((int (*)(int, int, int))code)(a[0], a[1], a[2]);
+    case 4:
+        return ((int (*)(int, int, int, int))code)(a[0], a[1], a[2], a[3]);
+    case 5:
+        return ((int (*)(int, int, int, int, int))code)(a[0], a[1], a[2], a[3], a[4]);
+    case 6:
+        return ((int (*)(int, int, int, int, int, int))code)(a[0], a[1], a[2], a[3], a[4], a[5]);
+    case 7:
+        return ((int (*)(int, int, int, int, int, int, int))code)(a[0], a[1], a[2], a[3], a[4], a[5], a[6]);
+    default:
+        return ((int (*)(int, int, int, int, int, int, int, int))code)(a[0], a[1], a[2], a[3], a[4], a[5], a[6],
+                                                                          a[7]);
+    }
+}
+
+bool jit_try_call(ASTNode *def, const int *args, int arg_count, int *result)
+{
+    if (!jit_enabled || arg_count > JIT_MAX_ARGS)
+        return false;
+
+    JitEntry *entry = find_entry(def);
+    if (entry->state == JIT_COLD)
+    {
+        // 热度：调用次数加上按比例折算的循环回边
+        entry->calls++;
+        if (entry->calls + entry->backedges / JIT_BACKEDGE_SCALE < jit_threshold)
+            return false;
+#ifndef _WIN32
+        if (jit_backend == JIT_BACKEND_C)
+            compile_function_c(def);
+        else
+#endif
+            compile_function(def);
+        // 编译时可能新增表项，重新查找
+        entry = find_entry(def);
+    }
+#ifndef _WIN32
+    else if (entry->state == JIT_COMPILING)
+    {
+        // 后台编译完成后的第一次调用加载共享库
+        if (job_done(entry->job))
+            finish_job(entry->job);
+        entry = find_entry(def);
+        if (entry->state == JIT_COMPILING)
+            entry->calls++;
+    }
+#endif
+    if (entry->state != JIT_COMPILED)
+        return false;
+
+    *result = call_native(entry->code, args, arg_count);
+    return true;
+}
+
+static JitLoop *find_loop(ASTNode *loop, ASTNode *function_def)
+{
+    // 同一个循环连续计数，先检查最近新增的表项
+    for (int i = loop_count - 1; i >= 0; i--)
+    {
+        if (loops[i].loop == loop)
+            return &loops[i];
+    }
+    if (loop_count >= loop_capacity)
+    {
+        loop_capacity = loop_capacity == 0 ? 8 : loop_capacity * 2;
+        loops = realloc(loops, loop_capacity * sizeof(JitLoop));
+        if (!loops)
+        {
+            fprintf(stderr, "Error: Memory allocation failed for loop counters\n");
+            exit(1);
+        }
+    }
+    JitLoop *entry = &loops[loop_count++];
+    memset(entry, 0, sizeof(*entry));
+    entry->loop = loop;
+    entry->function_def = function_def;
+    entry->state = JIT_COLD;
+    return entry;
+}
+
+void jit_count_backedge(ASTNode *loop, ASTNode *function_def)
+{
+    if (!jit_enabled)
+        return;
+
+    JitLoop *counter = find_loop(loop, function_def);
+    counter->backedges++;
+    if (!counter->hot && counter->backedges >= jit_threshold * JIT_BACKEDGE_SCALE)
+    {
+        counter->hot = true;
+        printf("Tier: loop at line %d in %s is hot (%d back-edges)\n", loop->line_no,
+               function_def ? function_def->func_def.func_name : "top level", counter->backedges);
+    }
+
+    // 函数内的热循环使函数在下一次调用时晋升
+    if (function_def != NULL)
+    {
+        JitEntry *entry = find_entry(function_def);
+        if (entry->state == JIT_COLD)
+            entry->backedges++;
+    }
+}
+
+static void add_name(const char ***names, int *count, const char *name)
+{
+    for (int i = 0; i < *count; i++)
+    {
+        if (strcmp((*names)[i], name) == 0)
+            return;
+    }
+    *names = realloc(*names, (*count + 1) * sizeof(const char *));
+    (*names)[(*count)++] = name;
+}
+
+// 收集循环中出现的变量名（不进入被调函数的函数体）
+static void collect_loop_names(ASTNode *node, OsrLayout *layout, const char ***names, int *count)
+{
+    if (node == NULL)
+        return;
+
+    switch (node->type)
+    {
+    case AST_VARIABLE:
+        add_name(names, count, node->string_value);
+        break;
+    case AST_DECLARATION:
+    case AST_DECLARATION_INIT:
+        add_name(names, count, node->decl.var_name);
+        collect_loop_names(node->decl.init_value, layout, names, count);
+        break;
+    case AST_ARRAY_ACCESS:
+        add_name(&layout->arrays, &layout->array_count, node->array_access.var_name);
+        collect_loop_names(node->array_access.index, layout, names, count);
+        break;
+    case AST_ARRAY_ASSIGNMENT:
+        collect_loop_names(node->array_assignment.array_access, layout, names, count);
+        collect_loop_names(node->array_assignment.value, layout, names, count);
+        break;
+    case AST_BINARY_OP:
+    case AST_ASSIGNMENT:
+        collect_loop_names(node->binary.left, layout, names, count);
+        collect_loop_names(node->binary.right, layout, names, count);
+        break;
+    case AST_IF:
+        collect_loop_names(node->if_stmt.cond, layout, names, count);
+        collect_loop_names(node->if_stmt.then_body, layout, names, count);
+        collect_loop_names(node->if_stmt.else_body, layout, names, count);
+        break;
+    case AST_WHILE:
+        collect_loop_names(node->while_loop.cond, layout, names, count);
+        collect_loop_names(node->while_loop.body, layout, names, count);
+        break;
+    case AST_FOR:
+        collect_loop_names(node->for_loop.init, layout, names, count);
+        collect_loop_names(node->for_loop.cond, layout, names, count);
+        collect_loop_names(node->for_loop.update, layout, names, count);
+        collect_loop_names(node->for_loop.body, layout, names, count);
+        break;
+    case AST_BLOCK:
+        for (int i = 0; i < node->block.count; i++)
+        {
+            collect_loop_names(node->block.statements[i], layout, names, count);
+        }
+        break;
+    case AST_FUNCTION_CALL:
+        for (int i = 0; i < node->func_call.arg_count; i++)
+        {
+            collect_loop_names(node->func_call.args[i], layout, names, count);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+// 循环用到的变量必须都已在符号表中，标量为 int、数组为 int[]
+static bool build_loop_layout(JitPlan *plan, JitLoop *counter)
+{
+    OsrLayout *layout = &counter->layout;
+    const char **names = NULL;
+    int count = 0;
+    collect_loop_names(counter->loop, layout, &names, &count);
+
+    bool ok = true;
+    for (int i = 0; ok && i < count; i++)
+    {
+        Symbol *sym = find_symbol(names[i]);
+        if (sym == NULL || sym->is_function || sym->type != TYPE_INT)
+            ok = reject(plan, "loop variable is not an int");
+        else
+            add_name(&layout->scalars, &layout->scalar_count, names[i]);
+    }
+    free(names);
+
+    int *sizes = calloc(layout->array_count + 1, sizeof(int));
+    for (int i = 0; ok && i < layout->array_count; i++)
+    {
+        Symbol *sym = find_symbol(layout->arrays[i]);
+        if (sym == NULL || sym->type != TYPE_INT_ARRAY || sym->array_data == NULL)
+            ok = reject(plan, "loop array is not an int[]");
+        else
+            sizes[i] = sym->array_size;
+    }
+    layout->array_sizes = sizes;
+    return ok;
+}
+
+static void compile_loop(JitLoop *counter)
+{
+    JitPlan plan = {NULL, 0, 0, NULL};
+    X86Code code;
+    x86_code_init(&code);
+
+    void *memory = NULL;
+    if (build_loop_layout(&plan, counter))
+    {
+        ASTNode *loop = counter->loop;
+        JitScope scope = {NULL, 0, 0, counter->layout.arrays, counter->layout.array_count, true};
+        for (int i = 0; i < counter->layout.scalar_count; i++)
+        {
+            scope_add(&scope, counter->layout.scalars[i]);
+        }
+        bool ok = loop->type == AST_FOR
+                      ? check_expression(&plan, &scope, loop->for_loop.cond) &&
+                            check_statement(&plan, &scope, loop->for_loop.body) &&
+                            check_statement(&plan, &scope, loop->for_loop.update)
+                      : check_expression(&plan, &scope, loop->while_loop.cond) &&
+                            check_statement(&plan, &scope, loop->while_loop.body);
+        free(scope.names);
+        if (ok)
+            memory = compile_plan(&plan, loop, &counter->layout, &code);
+    }
+
+    if (memory == NULL)
+    {
+        printf("Tier: loop at line %d stays in the interpreter (%s)\n", counter->loop->line_no, plan.reason);
+        counter->state = JIT_REJECTED;
+    }
+    else
+    {
+        const X86Symbol *entry_symbol = x86_find_symbol(&code, "ml_osr_loop");
+        counter->state = JIT_COMPILED;
+        counter->code = (unsigned char *)memory + entry_symbol->offset;
+        printf("Tier: loop at line %d compiled for on-stack replacement (%d variable(s), %d array(s), %d bytes)\n",
+               counter->loop->line_no, counter->layout.scalar_count, counter->layout.array_count, code.length);
+    }
+
+    x86_code_free(&code);
+    free(plan.defs);
+}
+
+bool jit_try_osr(ASTNode *loop)
+{
+    if (!jit_enabled)
+        return false;
+
+    JitLoop *counter = find_loop(loop, NULL);
+    if (!counter->hot || counter->state == JIT_REJECTED)
+        return false;
+    if (counter->state == JIT_COLD)
+    {
+        compile_loop(counter);
+        if (counter->state != JIT_COMPILED)
+            return false;
+    }
+
+    // 变量的类型或数组大小与编译时不同（如数组重新声明）时本次留在解释器
+    OsrLayout *layout = &counter->layout;
+    int *state = malloc((layout->scalar_count + 3) * sizeof(int));
+    int **arrays = malloc((layout->array_count + 1) * sizeof(int *));
+    bool ok = true;
+    for (int i = 0; ok && i < layout->scalar_count; i++)
+    {
+        Symbol *sym = find_symbol(layout->scalars[i]);
+        ok = sym != NULL && !sym->is_function && sym->type == TYPE_INT;
+        if (ok)
+            state[i] = sym->int_value;
+    }
+    for (int i = 0; ok && i < layout->array_count; i++)
+    {
+        Symbol *sym = find_symbol(layout->arrays[i]);
+        ok = sym != NULL && sym->type == TYPE_INT_ARRAY && sym->array_data != NULL &&
+             sym->array_size == layout->array_sizes[i];
+        if (ok)
+            arrays[i] = sym->array_data;
+    }
+
+    if (ok)
+    {
+        counter->osr_entries++;
+        printf("Tier: loop at line %d continues in native code (on-stack replacement)\n", loop->line_no);
+        state[layout->scalar_count] = 0;
+        ((int (*)(int *, int **))counter->code)(state, arrays);
+
+        for (int i = 0; i < layout->scalar_count; i++)
+        {
+            set_symbol(layout->scalars[i], state[i], (float)state[i], NULL, TYPE_INT, false);
+        }
+        if (state[layout->scalar_count] != 0)
+        {
+            fprintf(stderr, "Error: Array index out of bounds (index: %d, size: %d)\n", state[layout->scalar_count + 1],
+                    state[layout->scalar_count + 2]);
+            exit(1);
+        }
+    }
+    free(state);
+    free(arrays);
+    return ok;
+}
+
+static const char *tier_name(JitState state)
+{
+    switch (state)
+    {
+    case JIT_COMPILING:
+        return "interpreter (compiling)";
+    case JIT_COMPILED:
+        return "native";
+    case JIT_REJECTED:
+        return "interpreter (rejected)";
+    default:
+        return "interpreter";
+    }
+}
+
+void jit_shutdown(void)
+{
+    if (entry_count > 0 || loop_count > 0)
+    {
+        printf("\n=== Execution Tiers ===\n");
+        for (int i = 0; i < entry_count; i++)
+        {
+            printf("function %s: %s (interpreted calls: %d, back-edges: %d)\n", entries[i].def->func_def.func_name,
+                   tier_name(entries[i].state), entries[i].calls, entries[i].backedges);
+        }
+        for (int i = 0; i < loop_count; i++)
+        {
+            if (loops[i].hot)
+                printf("loop at line %d: %s (interpreted back-edges: %d, OSR entries: %d)\n",
+                       loops[i].loop->line_no, tier_name(loops[i].state), loops[i].backedges,
+                       loops[i].osr_entries);
+        }
+    }
+
+#ifndef _WIN32
+    free_jobs();
+#endif
+    for (int i = 0; i < block_count; i++)
+    {
+#ifdef _WIN32
+        VirtualFree(blocks[i].memory, 0, MEM_RELEASE);
+#else
+        munmap(blocks[i].memory, blocks[i].size);
+#endif
+    }
+    free(blocks);
+    blocks = NULL;
+    block_count = 0;
+    block_capacity = 0;
+    free(entries);
+    entries = NULL;
+    entry_count = 0;
+    entry_capacity = 0;
+    for (int i = 0; i < loop_count; i++)
+    {
+        free(loops[i].layout.scalars);
+        free(loops[i].layout.arrays);
+        free((int *)loops[i].layout.array_sizes);
+    }
+    free(loops);
+    loops = NULL;
+    loop_count = 0;
+    loop_capacity = 0;
+}
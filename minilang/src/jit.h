@@ -0,0 +1,46 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include "ast.h"
+
+// 分层执行：所有代码先在解释器（第0层）中执行并累计热度，
+// 足够热的整数函数经 MIR 编码为 x86-64 机器码（第1层），写入可执行内存后通过函数指针直接调用；
+// 不符合条件的函数继续解释执行。
+// 也可以选择 C 后端：热函数生成 C 源码，在后台线程中由 gcc -shared -O2 编译为共享库，
+// 编译完成后用 dlopen 加载；共享库按源码哈希缓存在磁盘上，再次运行时直接加载
+
+// 默认晋升阈值：函数调用次数，可用 -tier-threshold 修改
+#define JIT_DEFAULT_THRESHOLD 10
+
+// 循环回边按 1/JIT_BACKEDGE_SCALE 次调用计入所在函数的热度；
+// 回边达到 阈值 * JIT_BACKEDGE_SCALE 的循环视为热循环
+#define JIT_BACKEDGE_SCALE 10
+
+// 本地调用最多支持的参数个数
+#define JIT_MAX_ARGS 8
+
+// C 后端共享库的默认缓存目录，环境变量 MYLANG_JIT_CACHE 或 -jit-cache 可以修改
+#define JIT_DEFAULT_CACHE_DIR ".mylang_cache"
+
+void jit_set_enabled(bool enabled);
+void jit_set_threshold(int threshold);
+
+// 函数的编译后端："x86"（默认，进程内编码）或 "c"（gcc，仅非 Windows 平台）；名字无效时返回 false
+bool jit_set_backend(const char *name);
+void jit_set_cache_dir(const char *dir);
+
+// 调用用户函数前尝试执行本地代码；函数尚未变热、不符合条件或编译失败时返回 false，
+// 由解释器照常执行
+bool jit_try_call(ASTNode *def, const int *args, int arg_count, int *result);
+
+// 解释器每执行完一次循环体调用一次；function_def 为循环所在的函数，顶层代码为 NULL
+void jit_count_backedge(ASTNode *loop, ASTNode *function_def);
+
+// 热循环的栈上替换：解释器每次回边后调用，把符号表中的变量交给本地代码执行剩余的迭代，
+// 结果写回符号表；循环已由本地代码执行完时返回 true
+bool jit_try_osr(ASTNode *loop);
+
+// 输出各函数和热循环的计数并释放全部可执行内存
+void jit_shutdown(void);
+
+#endif // JIT_H
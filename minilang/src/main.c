@@ -1,7 +1,9 @@
 #include "ast.h"
+#include "cgen.h"
 #include "interpreter.h"
+#include "jit.h"
 #include "symbol.h"
-#include "../build/parser.tab.h"
+#include "parser.tab.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -16,11 +18,92 @@ extern char *yytext;
 // 添加函数声明
 void ast_write_to_file(ASTNode *node, const char *filename);
 
+// 输出文件名：把输入文件的扩展名换成 suffix（suffix 为空串时去掉扩展名）；从标准输入读取时用 fallback
+static char *output_filename(const char *input_file, const char *suffix, const char *fallback)
+{
+    if (!input_file)
+        return strdup(fallback);
+
+    const char *basename = strrchr(input_file, '/');
+    if (!basename)
+        basename = strrchr(input_file, '\\');
+    basename = basename ? basename + 1 : input_file;
+    const char *dot = strrchr(basename, '.');
+    size_t stem_len = dot ? (size_t)(dot - input_file) : strlen(input_file);
+    if (!dot && suffix[0] == '\0')
+        suffix = ".out"; // 不能覆盖没有扩展名的源文件
+
+    char *filename = malloc(stem_len + strlen(suffix) + 1);
+    memcpy(filename, input_file, stem_len);
+    strcpy(filename + stem_len, suffix);
+    return filename;
+}
+
+// 本地程序链接的运行时库（libmlrt.a 或 libmlrt_start.a）与编译器在同一目录；找不到时返回 NULL
+static char *runtime_library_path(const char *argv0, const char *name)
+{
+    const char *slash = strrchr(argv0, '/');
+    const char *backslash = strrchr(argv0, '\\');
+    if (backslash && (!slash || backslash > slash))
+        slash = backslash;
+    size_t dir_len = slash ? (size_t)(slash - argv0 + 1) : 0;
+
+    char *path = malloc(dir_len + strlen(name) + 1);
+    memcpy(path, argv0, dir_len);
+    strcpy(path + dir_len, name);
+    if (access(path, R_OK) != 0)
+    {
+        free(path);
+        return NULL;
+    }
+    return path;
+}
+
+// 汇编和目标文件输出的输出、数组分配和运行时错误都调用运行时库，链接时需要 libmlrt.a
+static void print_link_hint(const char *argv0, const char *filename)
+{
+    char *runtime_lib = runtime_library_path(argv0, "libmlrt.a");
+    printf("Link with: gcc %s %s\n", filename, runtime_lib ? runtime_lib : "libmlrt.a");
+    free(runtime_lib);
+}
+
+// -static-start：只链接独立运行时 libmlrt_start.a（自带 _start，直接用系统调用），不链接 C 库和动态链接器
+static bool link_static_start(const char *argv0, const char *filename, const char *exe_filename)
+{
+    char *runtime_lib = runtime_library_path(argv0, "libmlrt_start.a");
+    if (!runtime_lib)
+    {
+        fprintf(stderr, "Error: libmlrt_start.a not found next to the compiler (run make runtime)\n");
+        return false;
+    }
+    MirBuffer command;
+    memset(&command, 0, sizeof(command));
+    mir_buffer_printf(&command, "%s -static -nostdlib -o \"%s\" \"%s\" \"%s\" -lgcc", cgen_compiler(), exe_filename,
+                      filename, runtime_lib);
+    printf("Running: %s\n", command.data);
+    fflush(stdout);
+    int status = system(command.data);
+    mir_buffer_free(&command);
+    free(runtime_lib);
+    if (status != 0)
+    {
+        fprintf(stderr, "Error: %s failed to link %s\n", cgen_compiler(), filename);
+        return false;
+    }
+    printf("Executable generated: %s\n", exe_filename);
+    return true;
+}
+
 int main(int argc, char *argv[])
 {
     printf("=== MyLang Compiler ===\n");
 
     bool generate_asm = false;
+    bool generate_object = false;
+    bool emit_c = false;
+    bool native = false;
+    bool bounds_checks = true;
+    bool static_start = false;
     char *input_file = NULL;
 
     // 解析命令行参数
@@ -30,12 +113,102 @@ int main(int argc, char *argv[])
         {
             generate_asm = true;
         }
+        else if (strcmp(argv[i], "-c") == 0)
+        {
+            // 直接输出 ELF 目标文件，不经过汇编器
+            generate_object = true;
+        }
+        else if (strcmp(argv[i], "-emit-c") == 0)
+        {
+            // 只生成 C 源码
+            emit_c = true;
+        }
+        else if (strcmp(argv[i], "-native") == 0)
+        {
+            // 生成 C 源码并用 gcc -O2 编译为可执行文件
+            native = true;
+        }
+        else if (strcmp(argv[i], "-no-bounds-check") == 0)
+        {
+            // C 后端不生成数组下标检查
+            bounds_checks = false;
+        }
+        else if (strcmp(argv[i], "-static-start") == 0)
+        {
+            // -S/-c 之后只链接独立运行时，生成静态可执行文件
+            static_start = true;
+        }
+        else if (strcmp(argv[i], "-no-vectorize") == 0)
+        {
+            // 汇编后端不向量化数组循环
+            ast_set_vectorize(false);
+        }
+        else if (strcmp(argv[i], "-no-unroll") == 0)
+        {
+            // 汇编后端不展开循环（包括源码中 unroll(N) 提示的循环）
+            ast_set_unroll(false);
+        }
+        else if (strcmp(argv[i], "-unroll") == 0 && i + 1 < argc)
+        {
+            // 没有源码提示的循环按这个倍数部分展开
+            int factor = atoi(argv[++i]);
+            if (factor < 1 || factor > UNROLL_MAX_FACTOR)
+            {
+                fprintf(stderr, "Error: Unroll factor must be between 1 and %d\n", UNROLL_MAX_FACTOR);
+                return 1;
+            }
+            ast_set_unroll_factor(factor);
+        }
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            // 并行生成函数的线程数
+            ast_set_jobs(atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "-nojit") == 0)
+        {
+            // 关闭 JIT，所有函数都解释执行
+            jit_set_enabled(false);
+        }
+        else if (strcmp(argv[i], "-tier-threshold") == 0 && i + 1 < argc)
+        {
+            // 函数调用多少次后晋升为本地代码
+            jit_set_threshold(atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "-jit-backend") == 0 && i + 1 < argc)
+        {
+            // 热函数的编译后端：x86 或 c
+            if (!jit_set_backend(argv[++i]))
+            {
+                fprintf(stderr, "Error: Unknown JIT backend '%s' (expected x86 or c)\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-jit-cache") == 0 && i + 1 < argc)
+        {
+            // C 后端共享库的缓存目录
+            jit_set_cache_dir(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-target") == 0 && i + 1 < argc)
+        {
+            // 汇编输出的目标平台：win64 或 linux
+            if (!ast_set_target(argv[++i]))
+            {
+                fprintf(stderr, "Error: Unknown target '%s' (expected win64 or linux)\n", argv[i]);
+                return 1;
+            }
+        }
         else if (!input_file)
         {
             input_file = argv[i];
         }
     }
 
+    if (static_start && (!(generate_asm || generate_object) || strcmp(ast_target_name(), "linux") != 0))
+    {
+        fprintf(stderr, "Error: -static-start requires -S or -c with the linux target\n");
+        return 1;
+    }
+
     if (input_file)
     {
         printf("Parsing file: %s\n", input_file);
@@ -100,7 +273,7 @@ int main(int argc, char *argv[])
                     asm_filename = strdup("output.s"); // 默认输出文件名
                 }
 
-                printf("\n=== Generating Assembly ===\n");
+                printf("\n=== Generating Assembly (%s) ===\n", ast_target_name());
                 printf("Attempting to create file: %s\n", asm_filename);
 
                 FILE *asm_file = fopen(asm_filename, "w");
@@ -109,6 +282,20 @@ int main(int argc, char *argv[])
                     ast_write_to_file(program_root, asm_filename);
                     fclose(asm_file);
                     printf("Assembly file generated: %s\n", asm_filename);
+                    mir_peephole_report(stdout);
+                    printf("Vectorized loops: %d\n", ast_vectorized_loops());
+                    printf("Unrolled loops: %d\n", ast_unrolled_loops());
+                    if (!static_start)
+                    {
+                        print_link_hint(argv[0], asm_filename);
+                    }
+                    else
+                    {
+                        char *exe_filename = output_filename(input_file, "", "output");
+                        if (!link_static_start(argv[0], asm_filename, exe_filename))
+                            result = 1;
+                        free(exe_filename);
+                    }
                 }
                 else
                 {
@@ -119,10 +306,75 @@ int main(int argc, char *argv[])
                 free(asm_filename);
             }
 
+            else if (generate_object)
+            {
+                char *object_filename = output_filename(input_file, ".o", "output.o");
+                printf("\n=== Generating Object File (%s) ===\n", ast_target_name());
+                if (ast_write_object(program_root, object_filename))
+                {
+                    printf("Object file generated: %s\n", object_filename);
+                    mir_peephole_report(stdout);
+                    printf("Vectorized loops: %d\n", ast_vectorized_loops());
+                    printf("Unrolled loops: %d\n", ast_unrolled_loops());
+                    if (!static_start)
+                    {
+                        print_link_hint(argv[0], object_filename);
+                    }
+                    else
+                    {
+                        char *exe_filename = output_filename(input_file, "", "output");
+                        if (!link_static_start(argv[0], object_filename, exe_filename))
+                            result = 1;
+                        free(exe_filename);
+                    }
+                }
+                else
+                {
+                    result = 1;
+                }
+                free(object_filename);
+            }
+
+            else if (emit_c || native)
+            {
+                char *c_filename = output_filename(input_file, ".c", "output.c");
+                printf("\n=== Generating C ===\n");
+                if (!cgen_write_file(program_root, c_filename, bounds_checks))
+                {
+                    result = 1;
+                }
+                else
+                {
+                    printf("C file generated: %s\n", c_filename);
+                    if (native)
+                    {
+#ifdef _WIN32
+                        char *exe_filename = output_filename(input_file, ".exe", "output.exe");
+#else
+                        char *exe_filename = output_filename(input_file, "", "output");
+#endif
+                        char *runtime_lib = runtime_library_path(argv[0], "libmlrt.a");
+                        printf("\n=== Compiling with gcc -O2 ===\n");
+                        if (cgen_compile(c_filename, exe_filename, runtime_lib))
+                        {
+                            printf("Executable generated: %s\n", exe_filename);
+                        }
+                        else
+                        {
+                            result = 1;
+                        }
+                        free(runtime_lib);
+                        free(exe_filename);
+                    }
+                }
+                free(c_filename);
+            }
+
             else
             {
                 printf("\n=== Program Execution ===\n");
                 ast_interpret(program_root);
+                jit_shutdown();
             }
 
             // 清理资源
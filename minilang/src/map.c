@@ -0,0 +1,261 @@
+#include "map.h"
+#include "symbol.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAP_MIN_CAPACITY 8
+
+// 装载因子上限 7/8
+static bool map_over_load(int count, int capacity)
+{
+    return (long)count * 8 > (long)capacity * 7;
+}
+
+// 32位混合函数（murmur3 fmix32）
+static uint32_t mix32(uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+// 最高位置1，保证有效哈希值非0（0表示空槽）
+static uint32_t hash_key(const MapKey *key)
+{
+    uint32_t h;
+    if (key->is_string)
+    {
+        h = 2166136261u; // FNV-1a
+        const unsigned char *p = (const unsigned char *)ml_string_data(&key->string_value);
+        for (int i = 0; i < key->string_value.length; i++)
+        {
+            h ^= p[i];
+            h *= 16777619u;
+        }
+        h = mix32(h);
+    }
+    else
+    {
+        h = mix32((uint32_t)key->int_value);
+    }
+    return h | 0x80000000u;
+}
+
+static bool entry_matches(const MapEntry *entry, uint32_t hash, const MapKey *key)
+{
+    if (entry->hash != hash || entry->key_is_string != key->is_string)
+        return false;
+    if (key->is_string)
+        return ml_string_equals(&entry->string_key, &key->string_value);
+    return entry->int_key == key->int_value;
+}
+
+// 槽位距离理想位置的探测长度
+static int probe_distance(const Map *map, uint32_t hash, int slot)
+{
+    int mask = map->capacity - 1;
+    return (slot - (int)(hash & (uint32_t)mask) + map->capacity) & mask;
+}
+
+// 按 Robin Hood 规则放入条目（接管条目持有的内存），返回条目最终所在槽位
+static MapEntry *map_place(Map *map, MapEntry entry)
+{
+    int mask = map->capacity - 1;
+    int slot = (int)(entry.hash & (uint32_t)mask);
+    int dist = 0;
+    MapEntry *placed = NULL;
+
+    for (;;)
+    {
+        MapEntry *cur = &map->entries[slot];
+        if (cur->hash == 0)
+        {
+            *cur = entry;
+            map->count++;
+            return placed ? placed : cur;
+        }
+
+        // 劫富济贫：探测距离更短的条目让出槽位
+        int cur_dist = probe_distance(map, cur->hash, slot);
+        if (cur_dist < dist)
+        {
+            MapEntry displaced = *cur;
+            *cur = entry;
+            entry = displaced;
+            if (!placed)
+                placed = cur;
+            dist = cur_dist;
+        }
+
+        slot = (slot + 1) & mask;
+        dist++;
+    }
+}
+
+static void map_resize(Map *map, int capacity)
+{
+    MapEntry *old_entries = map->entries;
+    int old_capacity = map->capacity;
+
+    map->entries = calloc(capacity, sizeof(MapEntry));
+    if (!map->entries)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for map\n");
+        exit(1);
+    }
+    map->capacity = capacity;
+    map->count = 0;
+
+    for (int i = 0; i < old_capacity; i++)
+    {
+        if (old_entries[i].hash != 0)
+        {
+            map_place(map, old_entries[i]);
+        }
+    }
+    free(old_entries);
+}
+
+static int capacity_for(int count)
+{
+    int capacity = MAP_MIN_CAPACITY;
+    while (map_over_load(count, capacity))
+    {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+Map *map_new(int capacity_hint)
+{
+    Map *map = malloc(sizeof(Map));
+    if (!map)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for map\n");
+        exit(1);
+    }
+    map->entries = NULL;
+    map->capacity = 0;
+    map->count = 0;
+    map_resize(map, capacity_for(capacity_hint > 0 ? capacity_hint : 0));
+    return map;
+}
+
+static void free_value(MapValue *value)
+{
+    ml_string_release(&value->string_value);
+}
+
+void map_free(Map *map)
+{
+    if (!map)
+        return;
+    for (int i = 0; i < map->capacity; i++)
+    {
+        if (map->entries[i].hash != 0)
+        {
+            ml_string_release(&map->entries[i].string_key);
+            free_value(&map->entries[i].value);
+        }
+    }
+    free(map->entries);
+    free(map);
+}
+
+void map_reserve(Map *map, int count)
+{
+    int capacity = capacity_for(count);
+    if (capacity > map->capacity)
+    {
+        map_resize(map, capacity);
+    }
+}
+
+static int map_find_slot(Map *map, const MapKey *key)
+{
+    if (map->count == 0)
+        return -1;
+
+    uint32_t hash = hash_key(key);
+    int mask = map->capacity - 1;
+    int slot = (int)(hash & (uint32_t)mask);
+    for (int dist = 0;; dist++)
+    {
+        MapEntry *cur = &map->entries[slot];
+        // 遇到空槽或更“富”的条目即可断定键不存在
+        if (cur->hash == 0 || probe_distance(map, cur->hash, slot) < dist)
+            return -1;
+        if (entry_matches(cur, hash, key))
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+}
+
+MapValue *map_find(Map *map, const MapKey *key)
+{
+    int slot = map_find_slot(map, key);
+    return slot < 0 ? NULL : &map->entries[slot].value;
+}
+
+MapValue *map_insert(Map *map, const MapKey *key)
+{
+    MapValue *existing = map_find(map, key);
+    if (existing)
+        return existing;
+
+    if (map_over_load(map->count + 1, map->capacity))
+    {
+        map_resize(map, map->capacity * 2);
+    }
+
+    MapEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.hash = hash_key(key);
+    entry.key_is_string = key->is_string;
+    entry.int_key = key->int_value;
+    entry.value.type = TYPE_INT;
+    if (key->is_string)
+    {
+        entry.string_key = ml_string_retain(&key->string_value);
+    }
+    return &map_place(map, entry)->value;
+}
+
+bool map_remove(Map *map, const MapKey *key)
+{
+    int slot = map_find_slot(map, key);
+    if (slot < 0)
+        return false;
+
+    ml_string_release(&map->entries[slot].string_key);
+    free_value(&map->entries[slot].value);
+
+    // 后移删除：把后续条目前移一格，无需墓碑
+    int mask = map->capacity - 1;
+    int next = (slot + 1) & mask;
+    while (map->entries[next].hash != 0 &&
+           probe_distance(map, map->entries[next].hash, next) > 0)
+    {
+        map->entries[slot] = map->entries[next];
+        slot = next;
+        next = (next + 1) & mask;
+    }
+    memset(&map->entries[slot], 0, sizeof(MapEntry));
+    map->count--;
+    return true;
+}
+
+void map_set_value(MapValue *slot, int type, int int_value, float float_value, const MLString *string_value)
+{
+    // 先取引用再释放，允许 string_value 指向槽位原有的字符串
+    MLString copy = string_value ? ml_string_retain(string_value) : ml_string_empty();
+    free_value(slot);
+    slot->type = type;
+    slot->int_value = int_value;
+    slot->float_value = float_value;
+    slot->string_value = copy;
+}
@@ -0,0 +1,50 @@
+#ifndef MAP_H
+#define MAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "mlstring.h"
+
+// map 的键：int 或 string（查找时借用调用者的字符串，插入时增加引用计数）
+typedef struct
+{
+    bool is_string;
+    int int_value;
+    MLString string_value;
+} MapKey;
+
+// map 的值，type 取 TYPE_INT / TYPE_FLOAT / TYPE_STRING
+typedef struct
+{
+    int type;
+    int int_value;
+    float float_value;
+    MLString string_value;
+} MapValue;
+
+// Robin Hood 开放寻址槽位，hash 为0表示空槽
+typedef struct
+{
+    uint32_t hash;
+    bool key_is_string;
+    int int_key;
+    MLString string_key;
+    MapValue value;
+} MapEntry;
+
+typedef struct
+{
+    MapEntry *entries;
+    int capacity; // 槽位数，总是2的幂
+    int count;
+} Map;
+
+Map *map_new(int capacity_hint);
+void map_free(Map *map);
+void map_reserve(Map *map, int count);
+MapValue *map_find(Map *map, const MapKey *key);
+MapValue *map_insert(Map *map, const MapKey *key);
+bool map_remove(Map *map, const MapKey *key);
+void map_set_value(MapValue *slot, int type, int int_value, float float_value, const MLString *string_value);
+
+#endif // MAP_H
@@ -0,0 +1,787 @@
+#include "mir.h"
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const MirReg win64_arg_regs[] = {REG_RCX, REG_RDX, REG_R8, REG_R9};
+static const MirReg sysv_arg_regs[] = {REG_RDI, REG_RSI, REG_RDX, REG_RCX, REG_R8, REG_R9};
+
+// %eax/%ecx/%edx 留给运算本身（结果、右操作数、除法）
+static const MirReg win64_saved_regs[] = {REG_RBX, REG_RSI, REG_RDI, REG_R12, REG_R13, REG_R14, REG_R15};
+static const MirReg sysv_saved_regs[] = {REG_RBX, REG_R12, REG_R13, REG_R14, REG_R15};
+static const MirReg win64_temp_regs[] = {REG_R8, REG_R9, REG_R10, REG_R11};
+static const MirReg sysv_temp_regs[] = {REG_R8, REG_R9, REG_R10, REG_R11, REG_RSI, REG_RDI};
+
+static const TargetInfo targets[] = {
+    {"win64", true, win64_arg_regs, 4, 4, 32, ".section .rdata,\"dr\"", "", win64_saved_regs, 7, win64_temp_regs, 4},
+    {"linux", false, sysv_arg_regs, 6, 8, 0, ".section .rodata", "@PLT", sysv_saved_regs, 5, sysv_temp_regs, 6},
+};
+
+#ifdef _WIN32
+const TargetInfo *mir_target = &targets[0];
+#else
+const TargetInfo *mir_target = &targets[1];
+#endif
+
+bool mir_set_target(const char *name)
+{
+    if (strcmp(name, "sysv") == 0)
+        name = "linux";
+    for (size_t i = 0; i < sizeof(targets) / sizeof(targets[0]); i++)
+    {
+        if (strcmp(targets[i].name, name) == 0)
+        {
+            mir_target = &targets[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+void mir_buffer_printf(MirBuffer *buffer, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    va_list copy;
+    va_copy(copy, args);
+    int needed = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+
+    if (buffer->length + needed + 1 > buffer->capacity)
+    {
+        size_t capacity = buffer->capacity == 0 ? 4096 : buffer->capacity;
+        while (buffer->length + needed + 1 > capacity)
+        {
+            capacity *= 2;
+        }
+        buffer->data = realloc(buffer->data, capacity);
+        if (!buffer->data)
+        {
+            fprintf(stderr, "Error: Memory allocation failed for assembly output\n");
+            exit(1);
+        }
+        buffer->capacity = capacity;
+    }
+    vsnprintf(buffer->data + buffer->length, needed + 1, format, args);
+    buffer->length += needed;
+    va_end(args);
+}
+
+void mir_buffer_append(MirBuffer *buffer, const void *data, size_t size)
+{
+    if (buffer->length + size + 1 > buffer->capacity)
+    {
+        size_t capacity = buffer->capacity == 0 ? 4096 : buffer->capacity;
+        while (buffer->length + size + 1 > capacity)
+        {
+            capacity *= 2;
+        }
+        buffer->data = realloc(buffer->data, capacity);
+        if (!buffer->data)
+        {
+            fprintf(stderr, "Error: Memory allocation failed for assembly output\n");
+            exit(1);
+        }
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->length, data, size);
+    buffer->length += size;
+    buffer->data[buffer->length] = '\0';
+}
+
+void mir_buffer_free(MirBuffer *buffer)
+{
+    free(buffer->data);
+    memset(buffer, 0, sizeof(*buffer));
+}
+
+void mir_module_init(MirModule *module)
+{
+    memset(module, 0, sizeof(*module));
+}
+
+void mir_module_free(MirModule *module)
+{
+    mir_buffer_free(&module->text);
+    mir_buffer_free(&module->rodata);
+    mir_buffer_free(&module->rodata_bytes);
+    free(module->labels);
+    free(module->pool);
+    for (int i = 0; i < module->string_count; i++)
+    {
+        free(module->strings[i]);
+    }
+    free(module->strings);
+    memset(module, 0, sizeof(*module));
+}
+
+// 格式化并保存一个符号名，返回的字符串在模块释放前有效
+const char *mir_intern(MirModule *module, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    va_list copy;
+    va_copy(copy, args);
+    int needed = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+    char *str = malloc(needed + 1);
+    vsnprintf(str, needed + 1, format, args);
+    va_end(args);
+
+    if (module->string_count >= module->string_capacity)
+    {
+        module->string_capacity = module->string_capacity == 0 ? 64 : module->string_capacity * 2;
+        module->strings = realloc(module->strings, module->string_capacity * sizeof(char *));
+    }
+    module->strings[module->string_count++] = str;
+    return str;
+}
+
+// 代码和只读数据一次写出
+bool mir_module_write(MirModule *module, FILE *output)
+{
+    if (module->text.length > 0 && fwrite(module->text.data, 1, module->text.length, output) != module->text.length)
+        return false;
+    if (module->rodata.length > 0 &&
+        fwrite(module->rodata.data, 1, module->rodata.length, output) != module->rodata.length)
+        return false;
+    return true;
+}
+
+// 二进制内容补齐到 align 字节，汇编文本同时输出 .p2align
+static void align_rodata(MirModule *module, int align)
+{
+    static const unsigned char zeros[8] = {0};
+    size_t padding = (align - module->rodata_bytes.length % align) % align;
+    if (padding > 0)
+    {
+        mir_buffer_append(&module->rodata_bytes, zeros, padding);
+        mir_buffer_printf(&module->rodata, "\t.p2align\t%d\n", align == 8 ? 3 : align == 4 ? 2 : 1);
+    }
+}
+
+static void push_data_label(MirModule *module, const char *label, int offset, int size, MirDataKind kind, bool alias)
+{
+    if (module->label_count >= module->label_capacity)
+    {
+        module->label_capacity = module->label_capacity == 0 ? 16 : module->label_capacity * 2;
+        module->labels = realloc(module->labels, module->label_capacity * sizeof(MirDataLabel));
+    }
+    MirDataLabel *entry = &module->labels[module->label_count++];
+    entry->name = label;
+    entry->offset = offset;
+    entry->size = size;
+    entry->kind = kind;
+    entry->alias = alias;
+}
+
+// FNV-1a
+static unsigned pool_hash(MirDataKind kind, const void *data, int size)
+{
+    unsigned hash = 2166136261u ^ (unsigned)kind;
+    const unsigned char *bytes = data;
+    for (int i = 0; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static bool pool_matches(const MirModule *module, int index, MirDataKind kind, const void *data, int size)
+{
+    const MirDataLabel *entry = &module->labels[index];
+    return entry->kind == kind && entry->size == size &&
+           memcmp(module->rodata_bytes.data + entry->offset, data, size) == 0;
+}
+
+// 内容相同的常量在 labels 中的下标，没有时返回 -1
+static int pool_find(const MirModule *module, MirDataKind kind, const void *data, int size)
+{
+    if (module->pool_capacity == 0)
+        return -1;
+    unsigned mask = module->pool_capacity - 1;
+    for (unsigned slot = pool_hash(kind, data, size) & mask; module->pool[slot] != 0; slot = (slot + 1) & mask)
+    {
+        int index = module->pool[slot] - 1;
+        if (pool_matches(module, index, kind, data, size))
+            return index;
+    }
+    return -1;
+}
+
+static void pool_insert(MirModule *module, int index)
+{
+    const MirDataLabel *entry = &module->labels[index];
+    unsigned mask = module->pool_capacity - 1;
+    unsigned slot = pool_hash(entry->kind, module->rodata_bytes.data + entry->offset, entry->size) & mask;
+    while (module->pool[slot] != 0)
+    {
+        slot = (slot + 1) & mask;
+    }
+    module->pool[slot] = index + 1;
+    module->pool_count++;
+}
+
+// 最后一个标签的数据写完后登记到常量池；装载因子超过一半时扩容重建
+static void pool_add_last(MirModule *module)
+{
+    int index = module->label_count - 1;
+    MirDataLabel *entry = &module->labels[index];
+    entry->size = (int)module->rodata_bytes.length - entry->offset;
+    if (pool_find(module, entry->kind, module->rodata_bytes.data + entry->offset, entry->size) >= 0)
+        return; // 调用者没有先查找，保留最早的一份作为池中的代表
+
+    if ((module->pool_count + 1) * 2 > module->pool_capacity)
+    {
+        free(module->pool);
+        module->pool_capacity = module->pool_capacity == 0 ? 64 : module->pool_capacity * 2;
+        module->pool = calloc(module->pool_capacity, sizeof(int));
+        module->pool_count = 0;
+        for (int i = 0; i < index; i++)
+        {
+            const MirDataLabel *old = &module->labels[i];
+            if (!old->alias && pool_find(module, old->kind, module->rodata_bytes.data + old->offset, old->size) < 0)
+                pool_insert(module, i);
+        }
+    }
+    pool_insert(module, index);
+}
+
+// 对齐二进制内容并记录标签；标签名由调用者保证在模块释放前有效
+static void add_data_label(MirModule *module, const char *label, int align, MirDataKind kind)
+{
+    align_rodata(module, align);
+    push_data_label(module, label, (int)module->rodata_bytes.length, 0, kind, false);
+    mir_buffer_printf(&module->rodata, "%s:\n", label);
+}
+
+// 标签指向已有常量：汇编文本用 .set 定义同值符号，目标文件中直接记录同一偏移
+static void add_data_alias(MirModule *module, const char *label, int target)
+{
+    MirDataLabel entry = module->labels[target]; // push 可能移动 labels
+    push_data_label(module, label, entry.offset, entry.size, entry.kind, true);
+    mir_buffer_printf(&module->rodata, "\t.set\t%s, %s\n", label, entry.name);
+}
+
+void mir_module_append(MirModule *dst, MirModule *src)
+{
+    if (src->text.length > 0)
+        mir_buffer_append(&dst->text, src->text.data, src->text.length);
+
+    // 只读数据按标签重新加入 dst：内容已在 dst 中的成为别名，其余重新对齐后复制
+    for (int i = 0; i < src->label_count; i++)
+    {
+        const MirDataLabel *entry = &src->labels[i];
+        const char *data = src->rodata_bytes.data + entry->offset;
+        int existing = pool_find(dst, entry->kind, data, entry->size);
+        if (existing >= 0)
+        {
+            add_data_alias(dst, entry->name, existing);
+        }
+        else if (entry->kind == MIR_DATA_FLOAT)
+        {
+            float value;
+            memcpy(&value, data, sizeof(value));
+            mir_rodata_float(dst, entry->name, value);
+        }
+        else
+        {
+            mir_rodata_string(dst, entry->name, data);
+        }
+    }
+
+    for (int i = 0; i < src->string_count; i++)
+    {
+        if (dst->string_count >= dst->string_capacity)
+        {
+            dst->string_capacity = dst->string_capacity == 0 ? 64 : dst->string_capacity * 2;
+            dst->strings = realloc(dst->strings, dst->string_capacity * sizeof(char *));
+        }
+        dst->strings[dst->string_count++] = src->strings[i];
+    }
+    src->string_count = 0;
+    mir_module_free(src);
+}
+
+void mir_rodata_string(MirModule *module, const char *label, const char *str)
+{
+    add_data_label(module, label, 1, MIR_DATA_STRING);
+    MirBuffer *out = &module->rodata;
+    mir_buffer_printf(out, "\t.ascii\t\"");
+    for (const unsigned char *p = (const unsigned char *)str; *p; p++)
+    {
+        if (*p == '\\' || *p == '"')
+            mir_buffer_printf(out, "\\%c", *p);
+        else if (isprint(*p))
+            mir_buffer_printf(out, "%c", *p);
+        else
+            mir_buffer_printf(out, "\\%03o", *p);
+    }
+    mir_buffer_printf(out, "\\0\"\n");
+    mir_buffer_append(&module->rodata_bytes, str, strlen(str) + 1);
+    pool_add_last(module);
+}
+
+void mir_rodata_float(MirModule *module, const char *label, float value)
+{
+    // 按位模式输出，汇编文本与目标文件中的值完全一致
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    add_data_label(module, label, 4, MIR_DATA_FLOAT);
+    mir_buffer_printf(&module->rodata, "\t.long\t0x%08x\n", bits);
+    unsigned char bytes[4] = {bits & 0xff, (bits >> 8) & 0xff, (bits >> 16) & 0xff, bits >> 24};
+    mir_buffer_append(&module->rodata_bytes, bytes, sizeof(bytes));
+    pool_add_last(module);
+}
+
+const char *mir_rodata_find_string(const MirModule *module, const char *str)
+{
+    int index = pool_find(module, MIR_DATA_STRING, str, (int)strlen(str) + 1);
+    return index >= 0 ? module->labels[index].name : NULL;
+}
+
+const char *mir_rodata_find_float(const MirModule *module, float value)
+{
+    // 浮点常量在只读数据中按小端字节保存
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    unsigned char bytes[4] = {bits & 0xff, (bits >> 8) & 0xff, (bits >> 16) & 0xff, bits >> 24};
+    int index = pool_find(module, MIR_DATA_FLOAT, bytes, sizeof(bytes));
+    return index >= 0 ? module->labels[index].name : NULL;
+}
+
+int mir_rodata_offset(const MirModule *module, const char *label)
+{
+    for (int i = 0; i < module->label_count; i++)
+    {
+        if (strcmp(module->labels[i].name, label) == 0)
+            return module->labels[i].offset;
+    }
+    return -1;
+}
+
+MirFunction *mir_function_new(const char *name, bool global)
+{
+    MirFunction *fn = calloc(1, sizeof(MirFunction));
+    if (!fn)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for function code\n");
+        exit(1);
+    }
+    fn->name = name;
+    fn->global = global;
+    return fn;
+}
+
+void mir_function_free(MirFunction *fn)
+{
+    if (!fn)
+        return;
+    free(fn->code);
+    free(fn);
+}
+
+MirOperand mir_reg(MirReg reg, int size)
+{
+    MirOperand op = {MOP_REG, size, reg, -1, 0, 0, NULL};
+    return op;
+}
+
+MirOperand mir_xmm(int reg)
+{
+    MirOperand op = {MOP_XMM, 16, reg, -1, 0, 0, NULL};
+    return op;
+}
+
+MirOperand mir_vreg(int vreg)
+{
+    MirOperand op = {MOP_VREG, 4, vreg, -1, 0, 0, NULL};
+    return op;
+}
+
+MirOperand mir_imm(long value)
+{
+    MirOperand op = {MOP_IMM, 4, -1, -1, 0, value, NULL};
+    return op;
+}
+
+MirOperand mir_mem(MirReg base, long disp)
+{
+    MirOperand op = {MOP_MEM, 4, base, -1, 0, disp, NULL};
+    return op;
+}
+
+MirOperand mir_mem_index(MirReg base, long disp, MirReg index, int scale)
+{
+    MirOperand op = {MOP_MEM, 4, base, index, scale, disp, NULL};
+    return op;
+}
+
+MirOperand mir_rip(const char *symbol)
+{
+    MirOperand op = {MOP_RIP, 8, -1, -1, 0, 0, symbol};
+    return op;
+}
+
+MirOperand mir_arg_slot(long offset)
+{
+    MirOperand op = {MOP_ARG, 4, REG_RBP, -1, 0, offset, NULL};
+    return op;
+}
+
+MirOperand mir_label(const char *symbol)
+{
+    MirOperand op = {MOP_LABEL, 8, -1, -1, 0, 0, symbol};
+    return op;
+}
+
+static const MirOperand no_operand = {MOP_NONE, 0, -1, -1, 0, 0, NULL};
+
+MirInstr *mir_emit(MirFunction *fn, MirOpcode op, int size, int nops, MirOperand a, MirOperand b)
+{
+    if (fn->count >= fn->capacity)
+    {
+        fn->capacity = fn->capacity == 0 ? 64 : fn->capacity * 2;
+        fn->code = realloc(fn->code, fn->capacity * sizeof(MirInstr));
+        if (!fn->code)
+        {
+            fprintf(stderr, "Error: Memory allocation failed for function code\n");
+            exit(1);
+        }
+    }
+    MirInstr *instr = &fn->code[fn->count++];
+    instr->op = op;
+    instr->size = size;
+    instr->cond = COND_E;
+    instr->nops = nops;
+    instr->ops[0] = a;
+    instr->ops[1] = b;
+    return instr;
+}
+
+void mir_emit0(MirFunction *fn, MirOpcode op)
+{
+    mir_emit(fn, op, 4, 0, no_operand, no_operand);
+}
+
+void mir_emit1(MirFunction *fn, MirOpcode op, int size, MirOperand a)
+{
+    mir_emit(fn, op, size, 1, a, no_operand);
+}
+
+void mir_emit2(MirFunction *fn, MirOpcode op, int size, MirOperand src, MirOperand dst)
+{
+    mir_emit(fn, op, size, 2, src, dst);
+}
+
+void mir_emit_jcc(MirFunction *fn, MirCond cond, const char *label)
+{
+    mir_emit(fn, MIR_JCC, 8, 1, mir_label(label), no_operand)->cond = cond;
+}
+
+void mir_emit_setcc(MirFunction *fn, MirCond cond, MirReg reg)
+{
+    mir_emit(fn, MIR_SETCC, 1, 1, mir_reg(reg, 1), no_operand)->cond = cond;
+}
+
+void mir_emit_label(MirFunction *fn, const char *label)
+{
+    mir_emit(fn, MIR_LABEL, 8, 1, mir_label(label), no_operand);
+}
+
+bool mir_operand_equals(const MirOperand *a, const MirOperand *b)
+{
+    if (a->kind != b->kind)
+        return false;
+    switch (a->kind)
+    {
+    case MOP_NONE:
+        return true;
+    case MOP_REG:
+    case MOP_VREG:
+    case MOP_XMM:
+        return a->reg == b->reg;
+    case MOP_IMM:
+    case MOP_ARG:
+        return a->value == b->value;
+    case MOP_MEM:
+        return a->reg == b->reg && a->index == b->index && a->value == b->value &&
+               (a->index < 0 || a->scale == b->scale);
+    case MOP_RIP:
+    case MOP_LABEL:
+        return strcmp(a->symbol, b->symbol) == 0;
+    }
+    return false;
+}
+
+static const char *const reg_names64[] = {"%rax", "%rcx", "%rdx", "%rbx", "%rsp", "%rbp", "%rsi", "%rdi",
+                                          "%r8",  "%r9",  "%r10", "%r11", "%r12", "%r13", "%r14", "%r15"};
+static const char *const reg_names32[] = {"%eax", "%ecx", "%edx", "%ebx", "%esp", "%ebp", "%esi", "%edi",
+                                          "%r8d", "%r9d", "%r10d", "%r11d", "%r12d", "%r13d", "%r14d", "%r15d"};
+static const char *const reg_names8[] = {"%al",  "%cl",  "%dl",   "%bl",   "%spl",  "%bpl",  "%sil",  "%dil",
+                                         "%r8b", "%r9b", "%r10b", "%r11b", "%r12b", "%r13b", "%r14b", "%r15b"};
+
+static const char *reg_name(int reg, int size)
+{
+    if (size == 8)
+        return reg_names64[reg];
+    if (size == 1)
+        return reg_names8[reg];
+    return reg_names32[reg];
+}
+
+static void print_operand(MirBuffer *out, const MirFunction *fn, const MirOperand *op)
+{
+    switch (op->kind)
+    {
+    case MOP_REG:
+        mir_buffer_printf(out, "%s", reg_name(op->reg, op->size));
+        break;
+    case MOP_IMM:
+        mir_buffer_printf(out, "$%ld", op->value);
+        break;
+    case MOP_MEM:
+        if (op->index >= 0)
+            mir_buffer_printf(out, "%ld(%s,%s,%d)", op->value, reg_names64[op->reg], reg_names64[op->index],
+                              op->scale);
+        else
+            mir_buffer_printf(out, "%ld(%s)", op->value, reg_names64[op->reg]);
+        break;
+    case MOP_ARG:
+        // 保存的 %rbp、被调者保存寄存器和返回地址之上
+        mir_buffer_printf(out, "%ld(%%rbp)", 16 + 8L * fn->saved_regs + op->value);
+        break;
+    case MOP_RIP:
+        mir_buffer_printf(out, "%s(%%rip)", op->symbol);
+        break;
+    case MOP_LABEL:
+        mir_buffer_printf(out, "%s", op->symbol);
+        break;
+    case MOP_XMM:
+        mir_buffer_printf(out, "%%xmm%d", op->reg);
+        break;
+    case MOP_VREG:
+        fprintf(stderr, "Error: Virtual register v%d reached the assembly emitter\n", op->reg);
+        exit(1);
+    case MOP_NONE:
+        break;
+    }
+}
+
+static const char *const cond_names[] = {"e", "ne", "l", "le", "g", "ge", "b", "ae", "a", "be", "p", "np"};
+
+static const char *opcode_name(MirOpcode op)
+{
+    switch (op)
+    {
+    case MIR_MOV:
+        return "mov";
+    case MIR_MOVZB:
+        return "movzb";
+    case MIR_LEA:
+        return "lea";
+    case MIR_ADD:
+        return "add";
+    case MIR_SUB:
+        return "sub";
+    case MIR_IMUL:
+    case MIR_IMUL_WIDE:
+        return "imul";
+    case MIR_IDIV:
+        return "idiv";
+    case MIR_SAR:
+        return "sar";
+    case MIR_SHR:
+        return "shr";
+    case MIR_CMP:
+        return "cmp";
+    case MIR_TEST:
+        return "test";
+    case MIR_XOR:
+        return "xor";
+    case MIR_AND:
+        return "and";
+    case MIR_DEC:
+        return "dec";
+    case MIR_PUSH:
+        return "push";
+    case MIR_POP:
+        return "pop";
+    default:
+        return "nop";
+    }
+}
+
+// SSE 指令的助记符不带 l/q 后缀（movd/movq 由 size 区分）
+static const char *sse_name(const MirInstr *instr)
+{
+    switch (instr->op)
+    {
+    case MIR_MOVD:
+        return instr->size == 8 ? "movq" : "movd";
+    case MIR_MOVSS:
+        return "movss";
+    case MIR_ADDSS:
+        return "addss";
+    case MIR_SUBSS:
+        return "subss";
+    case MIR_MULSS:
+        return "mulss";
+    case MIR_DIVSS:
+        return "divss";
+    case MIR_UCOMISS:
+        return "ucomiss";
+    case MIR_CVTSI2SS:
+        return "cvtsi2ssl";
+    case MIR_CVTTSS2SI:
+        return "cvttss2si";
+    case MIR_CVTSS2SD:
+        return "cvtss2sd";
+    case MIR_MOVUPS:
+        return "movups";
+    case MIR_PADDD:
+        return "paddd";
+    case MIR_PSUBD:
+        return "psubd";
+    case MIR_ADDPS:
+        return "addps";
+    case MIR_SUBPS:
+        return "subps";
+    case MIR_MULPS:
+        return "mulps";
+    case MIR_DIVPS:
+        return "divps";
+    case MIR_PUNPCKLDQ:
+        return "punpckldq";
+    case MIR_PUNPCKLQDQ:
+        return "punpcklqdq";
+    default:
+        return NULL;
+    }
+}
+
+static void emit_prologue(MirBuffer *out, const MirFunction *fn)
+{
+    const TargetInfo *target = mir_target;
+    if (fn->global)
+        mir_buffer_printf(out, "\t.globl\t%s\n", fn->name);
+    if (target->windows)
+    {
+        mir_buffer_printf(out, "\t.def\t%s;\t.scl\t2;\t.type\t32;\t.endef\n", fn->name);
+        mir_buffer_printf(out, "\t.seh_proc\t%s\n", fn->name);
+    }
+    else
+    {
+        mir_buffer_printf(out, "\t.type\t%s, @function\n", fn->name);
+    }
+    mir_buffer_printf(out, "%s:\n", fn->name);
+    mir_buffer_printf(out, "\tpushq\t%%rbp\n");
+    if (target->windows)
+        mir_buffer_printf(out, "\t.seh_pushreg\t%%rbp\n");
+    for (int i = 0; i < fn->saved_regs; i++)
+    {
+        mir_buffer_printf(out, "\tpushq\t%s\n", reg_names64[target->saved_regs[i]]);
+        if (target->windows)
+            mir_buffer_printf(out, "\t.seh_pushreg\t%s\n", reg_names64[target->saved_regs[i]]);
+    }
+    mir_buffer_printf(out, "\tmovq\t%%rsp, %%rbp\n");
+    if (target->windows)
+        mir_buffer_printf(out, "\t.seh_setframe\t%%rbp, 0\n");
+
+    // 保存寄存器个数为奇数时补8字节，保持 %rsp 16字节对齐
+    int frame_size = fn->frame_size + (fn->saved_regs % 2 != 0 ? 8 : 0);
+    if (frame_size > 0)
+    {
+        mir_buffer_printf(out, "\tsubq\t$%d, %%rsp\n", frame_size);
+        if (target->windows)
+            mir_buffer_printf(out, "\t.seh_stackalloc\t%d\n", frame_size);
+    }
+    if (target->windows)
+        mir_buffer_printf(out, "\t.seh_endprologue\n");
+}
+
+static void emit_epilogue(MirBuffer *out, const MirFunction *fn)
+{
+    if (fn->saved_regs == 0)
+    {
+        mir_buffer_printf(out, "\tleave\n");
+    }
+    else
+    {
+        mir_buffer_printf(out, "\tmovq\t%%rbp, %%rsp\n");
+        for (int i = fn->saved_regs - 1; i >= 0; i--)
+        {
+            mir_buffer_printf(out, "\tpopq\t%s\n", reg_names64[mir_target->saved_regs[i]]);
+        }
+        mir_buffer_printf(out, "\tpopq\t%%rbp\n");
+    }
+    mir_buffer_printf(out, "\tret\n");
+}
+
+static void emit_instr(MirBuffer *out, const MirFunction *fn, const MirInstr *instr)
+{
+    switch (instr->op)
+    {
+    case MIR_LABEL:
+        mir_buffer_printf(out, "%s:\n", instr->ops[0].symbol);
+        return;
+    case MIR_RET:
+        emit_epilogue(out, fn);
+        return;
+    case MIR_NOP:
+        mir_buffer_printf(out, "\tnop\n");
+        return;
+    case MIR_CDQ:
+        mir_buffer_printf(out, "\tcltd\n");
+        return;
+    case MIR_REP_STOSQ:
+        mir_buffer_printf(out, "\trep stosq\n");
+        return;
+    case MIR_JMP:
+        mir_buffer_printf(out, "\tjmp\t%s\n", instr->ops[0].symbol);
+        return;
+    case MIR_JCC:
+        mir_buffer_printf(out, "\tj%s\t%s\n", cond_names[instr->cond], instr->ops[0].symbol);
+        return;
+    case MIR_CALL:
+        mir_buffer_printf(out, "\tcall\t%s\n", instr->ops[0].symbol);
+        return;
+    case MIR_SETCC:
+        mir_buffer_printf(out, "\tset%s\t", cond_names[instr->cond]);
+        break;
+    case MIR_MOVZB:
+        mir_buffer_printf(out, "\tmovzb%c\t", instr->size == 8 ? 'q' : 'l');
+        break;
+    default:
+        if (sse_name(instr))
+            mir_buffer_printf(out, "\t%s\t", sse_name(instr));
+        else
+            mir_buffer_printf(out, "\t%s%c\t", opcode_name(instr->op), instr->size == 8 ? 'q' : 'l');
+        break;
+    }
+
+    for (int i = 0; i < instr->nops; i++)
+    {
+        if (i > 0)
+            mir_buffer_printf(out, ", ");
+        print_operand(out, fn, &instr->ops[i]);
+    }
+    mir_buffer_printf(out, "\n");
+}
+
+void mir_emit_function(MirModule *module, const MirFunction *fn)
+{
+    MirBuffer *out = &module->text;
+    mir_buffer_printf(out, "\n");
+    emit_prologue(out, fn);
+    for (int i = 0; i < fn->count; i++)
+    {
+        emit_instr(out, fn, &fn->code[i]);
+    }
+    if (mir_target->windows)
+        mir_buffer_printf(out, "\t.seh_endproc\n");
+    else
+        mir_buffer_printf(out, "\t.size\t%s, .-%s\n", fn->name, fn->name);
+}
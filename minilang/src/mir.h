@@ -0,0 +1,263 @@
+#ifndef MIR_H
+#define MIR_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stddef.h>
+
+// 机器中间表示（MIR）：指令选择生成指令序列，寄存器分配改写虚拟寄存器，最后统一输出为 AT&T 汇编
+
+// 物理寄存器，编号与 x86-64 指令编码一致
+typedef enum
+{
+    REG_RAX,
+    REG_RCX,
+    REG_RDX,
+    REG_RBX,
+    REG_RSP,
+    REG_RBP,
+    REG_RSI,
+    REG_RDI,
+    REG_R8,
+    REG_R9,
+    REG_R10,
+    REG_R11,
+    REG_R12,
+    REG_R13,
+    REG_R14,
+    REG_R15,
+    REG_COUNT
+} MirReg;
+
+typedef enum
+{
+    MOP_NONE,
+    MOP_REG,   // 物理寄存器
+    MOP_VREG,  // 虚拟寄存器（标量局部变量），寄存器分配后改写为 MOP_REG 或 MOP_MEM
+    MOP_IMM,   // 立即数
+    MOP_MEM,   // disp(base, index, scale)
+    MOP_RIP,   // symbol(%rip)
+    MOP_ARG,   // 调用者栈上的实参，value 为相对返回地址之上的偏移，输出时加上保存寄存器的空间
+    MOP_LABEL, // 跳转或调用目标
+    MOP_XMM,   // SSE 寄存器 %xmm0-%xmm15，编号在 reg 中
+} MirOperandKind;
+
+typedef struct
+{
+    MirOperandKind kind;
+    int size;           // 寄存器宽度：1、4 或 8
+    int reg;            // MOP_REG/MOP_MEM 的（基址）寄存器，MOP_VREG 的编号
+    int index;          // MOP_MEM 的变址寄存器，-1 表示没有
+    int scale;
+    long value;         // 立即数或位移
+    const char *symbol; // MOP_RIP/MOP_LABEL，字符串归所在模块所有
+} MirOperand;
+
+typedef enum
+{
+    MIR_MOV,
+    MIR_MOVZB, // movzbl：字节零扩展
+    MIR_LEA,
+    MIR_ADD,
+    MIR_SUB,
+    MIR_IMUL,
+    MIR_IMUL_WIDE, // 单操作数 imull：%edx:%eax = %eax × 源操作数（有符号）
+    MIR_IDIV,
+    MIR_SAR, // 算术右移，源操作数是立即数移位次数
+    MIR_SHR, // 逻辑右移
+    MIR_CDQ, // cltd：%eax 符号扩展到 %edx
+    MIR_CMP,
+    MIR_TEST,
+    MIR_XOR,
+    MIR_AND,
+    MIR_DEC,
+    // SSE 标量浮点：size 4 为 float，MIR_MOVD 的 size 8 为 movq（64位传送）
+    MIR_MOVD,      // 通用寄存器/内存与 %xmm 之间按位传送
+    MIR_MOVSS,     // %xmm 与内存/%xmm 之间传送 float
+    MIR_ADDSS,
+    MIR_SUBSS,
+    MIR_MULSS,
+    MIR_DIVSS,
+    MIR_UCOMISS,   // 比较，结果在 CF/ZF/PF 中，用 COND_A/AE/B/BE/E/NE 判断，无序时 PF=1
+    MIR_CVTSI2SS,  // int → float
+    MIR_CVTTSS2SI, // float → int（向零截断）
+    MIR_CVTSS2SD,  // float → double（可变参数函数的浮点实参）
+    // SSE2 打包运算（4 × 32 位，size 16），用于向量化的数组循环
+    MIR_MOVUPS,     // %xmm 与内存之间不对齐传送 16 字节
+    MIR_PADDD,      // 4 × int
+    MIR_PSUBD,
+    MIR_ADDPS,      // 4 × float
+    MIR_SUBPS,
+    MIR_MULPS,
+    MIR_DIVPS,
+    MIR_PUNPCKLDQ,  // 交错低位元素；与 MIR_PUNPCKLQDQ 一起把最低元素广播到4个位置
+    MIR_PUNPCKLQDQ,
+    MIR_REP_STOSQ, // 把 %rax 写入 %rdi 开始的 %rcx 个8字节
+    MIR_SETCC,
+    MIR_JMP,
+    MIR_JCC,
+    MIR_CALL,
+    MIR_PUSH,
+    MIR_POP,
+    MIR_LABEL,
+    MIR_RET, // 伪指令：输出时展开为函数尾声
+    MIR_NOP,
+} MirOpcode;
+
+typedef enum
+{
+    COND_E,
+    COND_NE,
+    COND_L,
+    COND_LE,
+    COND_G,
+    COND_GE,
+    COND_B,
+    COND_AE,
+    COND_A, // 无符号（浮点比较）大于
+    COND_BE,
+    COND_P,  // PF=1：浮点比较无序（有 NaN）
+    COND_NP,
+} MirCond;
+
+// 操作数按 AT&T 顺序存放：ops[0] 是源，ops[1] 是目的；单操作数指令只用 ops[0]
+typedef struct
+{
+    MirOpcode op;
+    int size; // 操作数宽度：4 → l，8 → q
+    MirCond cond;
+    int nops;
+    MirOperand ops[2];
+} MirInstr;
+
+typedef struct
+{
+    const char *name;
+    bool global;
+    MirInstr *code;
+    int count;
+    int capacity;
+    int vreg_count;
+    int frame_size; // 栈帧字节数（数组和溢出的变量），寄存器分配后确定
+    int saved_regs; // 使用的被调者保存寄存器个数，见 TargetInfo.saved_regs
+} MirFunction;
+
+// 代码生成目标：Windows x64（COFF + SEH）或 Linux x86-64（ELF + System V）
+typedef struct
+{
+    const char *name;
+    bool windows;
+    const MirReg *arg_regs; // 整数参数寄存器
+    int arg_reg_count;
+    int float_arg_reg_count; // 浮点参数使用的 %xmm0.. 个数；Win64 的浮点参数按位置占用 %xmm<i>
+    int shadow_space;          // 调用者为被调函数预留的影子空间
+    const char *rodata;        // 只读数据段
+    const char *extern_suffix; // 调用外部函数时的符号后缀
+    const MirReg *saved_regs;  // 被调者保存寄存器，存放局部变量
+    int saved_reg_count;
+    const MirReg *temp_regs; // 调用者保存寄存器，存放表达式中间结果
+    int temp_reg_count;
+} TargetInfo;
+
+extern const TargetInfo *mir_target;
+bool mir_set_target(const char *name);
+
+// 输出缓冲区：汇编文本先写入内存，最后一次性写入文件
+typedef struct
+{
+    char *data;
+    size_t length;
+    size_t capacity;
+} MirBuffer;
+
+void mir_buffer_printf(MirBuffer *buffer, const char *format, ...);
+// 追加二进制内容（可以含 0 字节）
+void mir_buffer_append(MirBuffer *buffer, const void *data, size_t size);
+void mir_buffer_free(MirBuffer *buffer);
+
+// 只读数据中的标签及其偏移；内容相同的常量共用一份数据，后来的标签成为别名
+typedef enum
+{
+    MIR_DATA_STRING,
+    MIR_DATA_FLOAT,
+} MirDataKind;
+
+typedef struct
+{
+    const char *name;
+    int offset;
+    int size;
+    MirDataKind kind;
+    bool alias;
+} MirDataLabel;
+
+// 一个汇编文件：函数代码、只读数据和符号字符串池；
+// 只读数据同时保存汇编文本和二进制内容，后者供直接输出目标文件
+typedef struct
+{
+    MirBuffer text;
+    MirBuffer rodata;
+    MirBuffer rodata_bytes;
+    MirDataLabel *labels;
+    int label_count;
+    int label_capacity;
+    int *pool;         // 常量池：按内容散列的开放寻址表，元素为 labels 下标加一，0 表示空位
+    int pool_count;
+    int pool_capacity; // 2 的幂
+    char **strings;
+    int string_count;
+    int string_capacity;
+} MirModule;
+
+void mir_module_init(MirModule *module);
+void mir_module_free(MirModule *module);
+const char *mir_intern(MirModule *module, const char *format, ...);
+bool mir_module_write(MirModule *module, FILE *output);
+// 把 src 的代码、只读数据和符号名依次追加到 dst 后释放 src；src 的符号名转移给 dst，原来的指针仍然有效。
+// src 中与 dst 已有常量内容相同的标签成为别名，不再复制数据
+void mir_module_append(MirModule *dst, MirModule *src);
+
+// 向只读数据添加带标签的字符串（含结尾的 0）或 32 位浮点数
+void mir_rodata_string(MirModule *module, const char *label, const char *str);
+void mir_rodata_float(MirModule *module, const char *label, float value);
+// 在常量池中查找内容相同的字符串或浮点数（按位比较），返回其标签，没有时返回 NULL
+const char *mir_rodata_find_string(const MirModule *module, const char *str);
+const char *mir_rodata_find_float(const MirModule *module, float value);
+// 标签在只读数据中的偏移，不存在时返回 -1
+int mir_rodata_offset(const MirModule *module, const char *label);
+
+MirFunction *mir_function_new(const char *name, bool global);
+void mir_function_free(MirFunction *fn);
+
+MirOperand mir_reg(MirReg reg, int size);
+MirOperand mir_vreg(int vreg);
+MirOperand mir_imm(long value);
+MirOperand mir_mem(MirReg base, long disp);
+MirOperand mir_mem_index(MirReg base, long disp, MirReg index, int scale);
+MirOperand mir_rip(const char *symbol);
+MirOperand mir_arg_slot(long offset);
+MirOperand mir_label(const char *symbol);
+MirOperand mir_xmm(int reg);
+
+MirInstr *mir_emit(MirFunction *fn, MirOpcode op, int size, int nops, MirOperand a, MirOperand b);
+void mir_emit0(MirFunction *fn, MirOpcode op);
+void mir_emit1(MirFunction *fn, MirOpcode op, int size, MirOperand a);
+void mir_emit2(MirFunction *fn, MirOpcode op, int size, MirOperand src, MirOperand dst);
+void mir_emit_jcc(MirFunction *fn, MirCond cond, const char *label);
+void mir_emit_setcc(MirFunction *fn, MirCond cond, MirReg reg);
+void mir_emit_label(MirFunction *fn, const char *label);
+
+bool mir_operand_equals(const MirOperand *a, const MirOperand *b);
+
+// 线性扫描寄存器分配：把虚拟寄存器改写为被调者保存寄存器或栈槽，并确定栈帧大小
+void mir_allocate_registers(MirFunction *fn);
+
+// 窥孔优化（peephole.c）：返回本次改写次数，各规则的累计次数由 mir_peephole_report 输出
+int mir_peephole(MirFunction *fn);
+void mir_peephole_reset_stats(void);
+void mir_peephole_report(FILE *output);
+
+// 输出函数（序言、指令、尾声）到模块的代码缓冲区
+void mir_emit_function(MirModule *module, const MirFunction *fn);
+
+#endif // MIR_H
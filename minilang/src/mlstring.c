@@ -0,0 +1,232 @@
+#include "mlstring.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#define ML_STRING_SSE2 1
+#endif
+
+MLString ml_string_empty(void)
+{
+    MLString str;
+    memset(&str, 0, sizeof(str));
+    return str;
+}
+
+static MLStringBuffer *alloc_buffer(int capacity)
+{
+    MLStringBuffer *buffer = malloc(sizeof(MLStringBuffer) + (size_t)capacity + 1);
+    if (!buffer)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for string\n");
+        exit(1);
+    }
+    buffer->refcount = 1;
+    buffer->capacity = capacity;
+    return buffer;
+}
+
+MLString ml_string_from_data(const char *data, int length)
+{
+    MLString str = ml_string_empty();
+    str.length = length;
+
+    if (length <= ML_STRING_INLINE_MAX)
+    {
+        memcpy(str.inline_data, data, length);
+        str.inline_data[length] = '\0';
+        return str;
+    }
+
+    MLStringBuffer *buffer = alloc_buffer(length);
+    memcpy(buffer->data, data, length);
+    buffer->data[length] = '\0';
+
+    str.is_heap = true;
+    str.heap.buffer = buffer;
+    str.heap.data = buffer->data;
+    return str;
+}
+
+// 预留容量的空串，供逐段追加使用
+MLString ml_string_with_capacity(int capacity)
+{
+    MLString str = ml_string_empty();
+    if (capacity <= ML_STRING_INLINE_MAX)
+        return str;
+
+    MLStringBuffer *buffer = alloc_buffer(capacity);
+    buffer->data[0] = '\0';
+    str.is_heap = true;
+    str.heap.buffer = buffer;
+    str.heap.data = buffer->data;
+    return str;
+}
+
+MLString ml_string_from_cstr(const char *str)
+{
+    return str ? ml_string_from_data(str, (int)strlen(str)) : ml_string_empty();
+}
+
+MLString ml_string_retain(const MLString *str)
+{
+    MLString copy = *str;
+    if (copy.is_heap)
+    {
+        copy.heap.buffer->refcount++;
+    }
+    return copy;
+}
+
+void ml_string_release(MLString *str)
+{
+    if (str->is_heap && --str->heap.buffer->refcount == 0)
+    {
+        free(str->heap.buffer);
+    }
+    memset(str, 0, sizeof(*str));
+}
+
+// 返回的指针在 str 本身（内联串）或其缓冲区（堆串）存活期间有效
+const char *ml_string_data(const MLString *str)
+{
+    return str->is_heap ? str->heap.data : str->inline_data;
+}
+
+bool ml_string_equals(const MLString *a, const MLString *b)
+{
+    if (a->length != b->length)
+        return false;
+    if (a->is_heap && b->is_heap && a->heap.data == b->heap.data)
+        return true;
+    return memcmp(ml_string_data(a), ml_string_data(b), a->length) == 0;
+}
+
+void ml_string_append(MLString *str, const char *data, int length)
+{
+    if (length <= 0)
+        return;
+
+    int new_length = str->length + length;
+    if (!str->is_heap && new_length <= ML_STRING_INLINE_MAX)
+    {
+        memcpy(str->inline_data + str->length, data, length);
+        str->inline_data[new_length] = '\0';
+        str->length = new_length;
+        return;
+    }
+
+    // 独占整个缓冲区（非共享、非视图）且容量足够时原地追加
+    if (str->is_heap && str->heap.buffer->refcount == 1 && str->heap.data == str->heap.buffer->data &&
+        new_length <= str->heap.buffer->capacity)
+    {
+        char *dst = str->heap.buffer->data;
+        memmove(dst + str->length, data, length);
+        dst[new_length] = '\0';
+        str->length = new_length;
+        return;
+    }
+
+    int capacity = str->is_heap ? str->heap.buffer->capacity : ML_STRING_INLINE_MAX;
+    if (capacity < 16)
+        capacity = 16;
+    while (capacity < new_length)
+    {
+        capacity *= 2;
+    }
+
+    // data 可能指向 str 自身，先复制再释放旧值
+    MLStringBuffer *buffer = alloc_buffer(capacity);
+    memcpy(buffer->data, ml_string_data(str), str->length);
+    memcpy(buffer->data + str->length, data, length);
+    buffer->data[new_length] = '\0';
+
+    ml_string_release(str);
+    str->length = new_length;
+    str->is_heap = true;
+    str->heap.buffer = buffer;
+    str->heap.data = buffer->data;
+}
+
+MLString ml_string_slice(const MLString *str, int start, int length)
+{
+    if (!str->is_heap)
+        return ml_string_from_data(str->inline_data + start, length);
+
+    MLString view = ml_string_retain(str);
+    view.length = length;
+    view.heap.data = str->heap.data + start;
+    return view;
+}
+
+static bool tail_matches(const char *candidate, const char *needle, int needle_length)
+{
+    // 首尾字节已比较过
+    return needle_length <= 2 || memcmp(candidate + 1, needle + 1, needle_length - 2) == 0;
+}
+
+// 同时比较候选位置的首字节和尾字节，两者都命中的位置才做完整比较
+static int find_bytes(const char *haystack, int length, const char *needle, int needle_length)
+{
+    if (needle_length == 0)
+        return 0;
+
+    int last = length - needle_length; // 最后一个候选起点
+    int i = 0;
+#ifdef ML_STRING_SSE2
+    __m128i first_byte = _mm_set1_epi8(needle[0]);
+    __m128i last_byte = _mm_set1_epi8(needle[needle_length - 1]);
+    for (; i + 15 <= last; i += 16)
+    {
+        __m128i block_first = _mm_loadu_si128((const __m128i *)(haystack + i));
+        __m128i block_last = _mm_loadu_si128((const __m128i *)(haystack + i + needle_length - 1));
+        unsigned mask = (unsigned)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(block_first, first_byte), _mm_cmpeq_epi8(block_last, last_byte)));
+        while (mask != 0)
+        {
+            int offset = __builtin_ctz(mask);
+            if (tail_matches(haystack + i + offset, needle, needle_length))
+                return i + offset;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i <= last; i++)
+    {
+        if (haystack[i] == needle[0] && haystack[i + needle_length - 1] == needle[needle_length - 1] &&
+            tail_matches(haystack + i, needle, needle_length))
+            return i;
+    }
+    return -1;
+}
+
+int ml_string_find(const MLString *str, const char *needle, int needle_length, int start)
+{
+    if (start < 0)
+        start = 0;
+    if (start > str->length)
+        return -1;
+
+    int index = find_bytes(ml_string_data(str) + start, str->length - start, needle, needle_length);
+    return index < 0 ? -1 : start + index;
+}
+
+int ml_string_count(const MLString *str, const char *needle, int needle_length)
+{
+    int count = 0;
+    if (needle_length == 0)
+        return 0;
+    for (int pos = ml_string_find(str, needle, needle_length, 0); pos >= 0;
+         pos = ml_string_find(str, needle, needle_length, pos + needle_length))
+    {
+        count++;
+    }
+    return count;
+}
+
+bool ml_string_starts_with(const MLString *str, const char *prefix, int prefix_length)
+{
+    return prefix_length <= str->length && memcmp(ml_string_data(str), prefix, prefix_length) == 0;
+}
@@ -0,0 +1,54 @@
+#ifndef MLSTRING_H
+#define MLSTRING_H
+
+#include <stdbool.h>
+
+// 不超过该长度的字符串直接内联存放，不分配堆内存
+#define ML_STRING_INLINE_MAX 15
+
+// 长字符串的共享堆缓冲区，引用计数归零时释放
+typedef struct
+{
+    int refcount;
+    int capacity; // data 可容纳的字节数（不含结尾'\0'）
+    char data[];
+} MLStringBuffer;
+
+// 不可变字符串值：按值传递，复制只需增加引用计数；全零即为空串
+typedef struct
+{
+    int length;
+    bool is_heap;
+    union
+    {
+        char inline_data[ML_STRING_INLINE_MAX + 1];
+        struct
+        {
+            MLStringBuffer *buffer;
+            const char *data; // 指向 buffer->data 内部
+        } heap;
+    };
+} MLString;
+
+MLString ml_string_empty(void);
+MLString ml_string_from_cstr(const char *str);
+MLString ml_string_from_data(const char *data, int length);
+MLString ml_string_with_capacity(int capacity);
+MLString ml_string_retain(const MLString *str);
+void ml_string_release(MLString *str);
+const char *ml_string_data(const MLString *str);
+bool ml_string_equals(const MLString *a, const MLString *b);
+
+// 子串 [start, start + length)：源为堆串时返回共享同一缓冲区的视图（不复制）
+MLString ml_string_slice(const MLString *str, int start, int length);
+
+// 从 start 开始查找 needle，返回下标，找不到返回-1（SSE2 可用时按16字节块扫描）
+int ml_string_find(const MLString *str, const char *needle, int needle_length, int start);
+// 不重叠出现次数，needle 为空时返回0
+int ml_string_count(const MLString *str, const char *needle, int needle_length);
+bool ml_string_starts_with(const MLString *str, const char *prefix, int prefix_length);
+
+// 追加内容：str 独占且容量足够时原地追加，否则按2倍增长复制到新缓冲区（写时复制）
+void ml_string_append(MLString *str, const char *data, int length);
+
+#endif // MLSTRING_H
@@ -23,14 +23,14 @@ ASTNode *program_root;
 %token <int_val> INTEGER
 %token <float_val> FLOAT
 %token <string> IDENTIFIER STRING
-%token IF ELSE WHILE FOR INT RETURN PRINT FUNCTION
-%token INT_ARRAY FLOAT_ARRAY STRING_ARRAY
+%token IF ELSE WHILE FOR UNROLL INT RETURN PRINT FUNCTION
+%token INT_ARRAY FLOAT_ARRAY STRING_ARRAY MAP
 %token EQ NE LE GE AND OR
 %token IFX '[' ']'
 
 %type <ast> program stmt_list stmt expr decl block if_stmt while_stmt for_stmt
 %type <ast> logical_expr equality_expr rel_expr add_expr mul_expr primary expr_list
-%type <ast> array_decl array_access function_def param_list param
+%type <ast> array_decl map_decl array_access function_def param_list param
 %type <string> type_specifier
 
 %%
@@ -61,6 +61,7 @@ stmt_list: stmt {
 stmt: expr ';' { $$ = $1; }
 | decl ';' { $$ = $1; }
 | array_decl ';' { $$ = $1; }
+| map_decl ';' { $$ = $1; }
 | if_stmt { $$ = $1; }
 | while_stmt { $$ = $1; }
 | for_stmt { $$ = $1; }
@@ -185,20 +186,25 @@ type_specifier: INT { $$ = strdup("int"); }
 | STRING_ARRAY { $$ = strdup("string[]"); }
 ;
 
-decl: INT IDENTIFIER { $$ = ast_new_declaration($2, yylineno); }
-| INT IDENTIFIER '=' expr { $$ = ast_new_declaration_init($2, $4, yylineno); }
-| FLOAT IDENTIFIER { $$ = ast_new_declaration($2, yylineno); }
-| FLOAT IDENTIFIER '=' expr { $$ = ast_new_declaration_init($2, $4, yylineno); }
-| STRING IDENTIFIER { $$ = ast_new_declaration($2, yylineno); }
-| STRING IDENTIFIER '=' expr { $$ = ast_new_declaration_init($2, $4, yylineno); }
+decl: INT IDENTIFIER { $$ = ast_new_declaration($2, "int", yylineno); }
+| INT IDENTIFIER '=' expr { $$ = ast_new_declaration_init($2, "int", $4, yylineno); }
+| FLOAT IDENTIFIER { $$ = ast_new_declaration($2, "float", yylineno); }
+| FLOAT IDENTIFIER '=' expr { $$ = ast_new_declaration_init($2, "float", $4, yylineno); }
+| STRING IDENTIFIER { $$ = ast_new_declaration($2, "string", yylineno); }
+| STRING IDENTIFIER '=' expr { $$ = ast_new_declaration_init($2, "string", $4, yylineno); }
 ;
 
-array_decl: INT_ARRAY IDENTIFIER { $$ = ast_new_array_declaration($2, NULL, yylineno); }
-| INT_ARRAY IDENTIFIER '[' expr ']' { $$ = ast_new_array_declaration($2, $4, yylineno); }
-| FLOAT_ARRAY IDENTIFIER { $$ = ast_new_array_declaration($2, NULL, yylineno); }
-| FLOAT_ARRAY IDENTIFIER '[' expr ']' { $$ = ast_new_array_declaration($2, $4, yylineno); }
-| STRING_ARRAY IDENTIFIER { $$ = ast_new_array_declaration($2, NULL, yylineno); }
-| STRING_ARRAY IDENTIFIER '[' expr ']' { $$ = ast_new_array_declaration($2, $4, yylineno); }
+array_decl: INT_ARRAY IDENTIFIER { $$ = ast_new_array_declaration($2, "int[]", NULL, yylineno); }
+| INT_ARRAY IDENTIFIER '[' expr ']' { $$ = ast_new_array_declaration($2, "int[]", $4, yylineno); }
+| FLOAT_ARRAY IDENTIFIER { $$ = ast_new_array_declaration($2, "float[]", NULL, yylineno); }
+| FLOAT_ARRAY IDENTIFIER '[' expr ']' { $$ = ast_new_array_declaration($2, "float[]", $4, yylineno); }
+| STRING_ARRAY IDENTIFIER { $$ = ast_new_array_declaration($2, "string[]", NULL, yylineno); }
+| STRING_ARRAY IDENTIFIER '[' expr ']' { $$ = ast_new_array_declaration($2, "string[]", $4, yylineno); }
+;
+
+// map m; 或 map m[容量提示];
+map_decl: MAP IDENTIFIER { $$ = ast_new_map_declaration($2, NULL, yylineno); }
+| MAP IDENTIFIER '[' expr ']' { $$ = ast_new_map_declaration($2, $4, yylineno); }
 ;
 
 block: '{' stmt_list '}' { $$ = $2; }
@@ -224,6 +230,10 @@ while_stmt: WHILE '(' expr ')' stmt {
 for_stmt: FOR '(' expr ';' expr ';' expr ')' stmt { 
     $$ = ast_new_for($3, $5, $7, $9, yylineno); 
 }
+// unroll(N) for (...)：提示编译器把循环展开 N 倍，unroll(1) 表示不展开
+| UNROLL '(' INTEGER ')' for_stmt {
+    $$ = ast_set_unroll_hint($5, $3, yylineno);
+}
 ;
 
 expr: IDENTIFIER '=' expr { 
@@ -0,0 +1,280 @@
+#include "mir.h"
+#include <string.h>
+
+// 窥孔优化：在寄存器分配之后、输出之前按规则表反复改写指令序列，直到没有规则再生效
+
+static void remove_instrs(MirFunction *fn, int index, int count)
+{
+    memmove(&fn->code[index], &fn->code[index + count], (fn->count - index - count) * sizeof(MirInstr));
+    fn->count -= count;
+}
+
+static bool is_op(const MirFunction *fn, int index, MirOpcode op)
+{
+    return index < fn->count && fn->code[index].op == op;
+}
+
+static bool is_reg(const MirOperand *op, MirReg reg)
+{
+    return op->kind == MOP_REG && op->reg == (int)reg;
+}
+
+static MirCond invert_cond(MirCond cond)
+{
+    switch (cond)
+    {
+    case COND_E:
+        return COND_NE;
+    case COND_NE:
+        return COND_E;
+    case COND_L:
+        return COND_GE;
+    case COND_GE:
+        return COND_L;
+    case COND_LE:
+        return COND_G;
+    case COND_G:
+        return COND_LE;
+    case COND_B:
+        return COND_AE;
+    case COND_AE:
+        return COND_B;
+    case COND_A:
+        return COND_BE;
+    case COND_BE:
+        return COND_A;
+    case COND_P:
+        return COND_NP;
+    case COND_NP:
+        return COND_P;
+    }
+    return cond;
+}
+
+// jmp/jcc L 后紧跟（若干标签中的）L
+static bool jump_to_next(MirFunction *fn, int i)
+{
+    MirInstr *instr = &fn->code[i];
+    if (instr->op != MIR_JMP && instr->op != MIR_JCC)
+        return false;
+    for (int j = i + 1; is_op(fn, j, MIR_LABEL); j++)
+    {
+        if (strcmp(fn->code[j].ops[0].symbol, instr->ops[0].symbol) == 0)
+        {
+            remove_instrs(fn, i, 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 无条件跳转之后、下一个标签之前的指令不可达（如 return 之后的 movl $0, %eax）
+static bool unreachable_after_jump(MirFunction *fn, int i)
+{
+    if (fn->code[i].op != MIR_JMP || i + 1 >= fn->count || fn->code[i + 1].op == MIR_LABEL)
+        return false;
+    remove_instrs(fn, i + 1, 1);
+    return true;
+}
+
+// jcc L1; jmp L2; L1:  →  j!cc L2; L1:
+static bool branch_over_jump(MirFunction *fn, int i)
+{
+    if (!is_op(fn, i, MIR_JCC) || !is_op(fn, i + 1, MIR_JMP) || !is_op(fn, i + 2, MIR_LABEL))
+        return false;
+    MirInstr *branch = &fn->code[i];
+    if (strcmp(branch->ops[0].symbol, fn->code[i + 2].ops[0].symbol) != 0)
+        return false;
+    branch->cond = invert_cond(branch->cond);
+    branch->ops[0] = fn->code[i + 1].ops[0];
+    remove_instrs(fn, i + 1, 1);
+    return true;
+}
+
+// movl A, B; movl B, A  →  movl A, B
+static bool store_reload(MirFunction *fn, int i)
+{
+    if (!is_op(fn, i, MIR_MOV) || !is_op(fn, i + 1, MIR_MOV))
+        return false;
+    MirInstr *store = &fn->code[i];
+    MirInstr *load = &fn->code[i + 1];
+    if (store->size != load->size || !mir_operand_equals(&store->ops[0], &load->ops[1]) ||
+        !mir_operand_equals(&store->ops[1], &load->ops[0]))
+        return false;
+    // movl (%rax), %eax 改变了地址寄存器，回写的不是同一个位置
+    const MirOperand *src = &store->ops[0];
+    if (src->kind == MOP_MEM && store->ops[1].kind == MOP_REG &&
+        (src->reg == store->ops[1].reg || src->index == store->ops[1].reg))
+        return false;
+    remove_instrs(fn, i + 1, 1);
+    return true;
+}
+
+// pushq R; popq R  →  （删除）；pushq R; popq S  →  movq R, S
+static bool push_pop(MirFunction *fn, int i)
+{
+    if (!is_op(fn, i, MIR_PUSH) || !is_op(fn, i + 1, MIR_POP))
+        return false;
+    MirOperand src = fn->code[i].ops[0];
+    MirOperand dst = fn->code[i + 1].ops[0];
+    if (src.kind != MOP_REG || dst.kind != MOP_REG)
+        return false;
+    if (src.reg == dst.reg)
+    {
+        remove_instrs(fn, i, 2);
+    }
+    else
+    {
+        MirInstr *move = &fn->code[i];
+        move->op = MIR_MOV;
+        move->size = 8;
+        move->nops = 2;
+        move->ops[0] = src;
+        move->ops[1] = dst;
+        remove_instrs(fn, i + 1, 1);
+    }
+    return true;
+}
+
+// movq R, R（32位自身传送会清零高位，不删除）
+static bool self_move(MirFunction *fn, int i)
+{
+    MirInstr *instr = &fn->code[i];
+    if (instr->op != MIR_MOV || instr->size != 8 || instr->ops[0].kind != MOP_REG ||
+        !mir_operand_equals(&instr->ops[0], &instr->ops[1]))
+        return false;
+    remove_instrs(fn, i, 1);
+    return true;
+}
+
+// cmp/ucomiss; setcc %al; movzbl %al, %eax; testl %eax, %eax; je/jne L  →  cmp/ucomiss; j(!)cc L
+// 条件分支的两个去向都不读 %eax（下一条语句总是先写 %eax），所以不必保留0/1结果。
+// ucomiss 之后只有 A/AE/B/BE 在无序（NaN）时与取反的条件码互补；浮点 == 和 != 还要看 PF，
+// 由 fuse_float_equal_branch 处理
+static bool fuse_compare_branch(MirFunction *fn, int i)
+{
+    if ((!is_op(fn, i, MIR_CMP) && !is_op(fn, i, MIR_UCOMISS)) || !is_op(fn, i + 1, MIR_SETCC) ||
+        !is_op(fn, i + 2, MIR_MOVZB) || !is_op(fn, i + 3, MIR_TEST) || !is_op(fn, i + 4, MIR_JCC))
+        return false;
+    MirInstr *setcc = &fn->code[i + 1];
+    MirInstr *test = &fn->code[i + 3];
+    MirInstr *branch = &fn->code[i + 4];
+    if (!is_reg(&setcc->ops[0], REG_RAX) || !is_reg(&test->ops[0], REG_RAX) || !is_reg(&test->ops[1], REG_RAX) ||
+        (branch->cond != COND_E && branch->cond != COND_NE))
+        return false;
+    if (fn->code[i].op == MIR_UCOMISS && setcc->cond != COND_A && setcc->cond != COND_AE &&
+        setcc->cond != COND_B && setcc->cond != COND_BE)
+        return false;
+
+    MirCond cond = branch->cond == COND_E ? invert_cond(setcc->cond) : setcc->cond;
+    branch->cond = cond;
+    fn->code[i + 1] = *branch;
+    remove_instrs(fn, i + 2, 3);
+    return true;
+}
+
+// 浮点 ==：ucomiss; sete %al; setnp %cl; movzbl %al, %eax; movzbl %cl, %ecx; andl %ecx, %eax;
+// testl %eax, %eax; je L（!= 多一条 xorl $1, %eax，再接 jne L），即不相等或无序时跳转
+//   →  ucomiss; jne L; jp L
+// 反方向（相等且有序时跳转）需要额外的标签，保持原样
+static bool fuse_float_equal_branch(MirFunction *fn, int i)
+{
+    if (!is_op(fn, i, MIR_UCOMISS) || !is_op(fn, i + 1, MIR_SETCC) || !is_op(fn, i + 2, MIR_SETCC) ||
+        !is_op(fn, i + 3, MIR_MOVZB) || !is_op(fn, i + 4, MIR_MOVZB) || !is_op(fn, i + 5, MIR_AND))
+        return false;
+    if (fn->code[i + 1].cond != COND_E || !is_reg(&fn->code[i + 1].ops[0], REG_RAX) ||
+        fn->code[i + 2].cond != COND_NP || !is_reg(&fn->code[i + 2].ops[0], REG_RCX) ||
+        !is_reg(&fn->code[i + 5].ops[0], REG_RCX) || !is_reg(&fn->code[i + 5].ops[1], REG_RAX))
+        return false;
+    int next = i + 6;
+    bool negated = is_op(fn, next, MIR_XOR);
+    if (negated)
+    {
+        MirInstr *flip = &fn->code[next];
+        if (flip->ops[0].kind != MOP_IMM || flip->ops[0].value != 1 || !is_reg(&flip->ops[1], REG_RAX))
+            return false;
+        next++;
+    }
+    if (!is_op(fn, next, MIR_TEST) || !is_op(fn, next + 1, MIR_JCC))
+        return false;
+    MirInstr *test = &fn->code[next];
+    MirInstr branch = fn->code[next + 1];
+    if (!is_reg(&test->ops[0], REG_RAX) || !is_reg(&test->ops[1], REG_RAX) ||
+        branch.cond != (negated ? COND_NE : COND_E))
+        return false;
+
+    branch.cond = COND_NE;
+    fn->code[i + 1] = branch;
+    branch.cond = COND_P;
+    fn->code[i + 2] = branch;
+    remove_instrs(fn, i + 3, next + 2 - (i + 3));
+    return true;
+}
+
+typedef struct
+{
+    const char *name;
+    bool (*apply)(MirFunction *fn, int index);
+    int fired;
+} PeepholeRule;
+
+static PeepholeRule rules[] = {
+    {"unreachable_after_jump", unreachable_after_jump, 0},
+    {"jump_to_next", jump_to_next, 0},
+    {"branch_over_jump", branch_over_jump, 0},
+    {"store_reload", store_reload, 0},
+    {"push_pop", push_pop, 0},
+    {"self_move", self_move, 0},
+    {"fuse_compare_branch", fuse_compare_branch, 0},
+    {"fuse_float_equal_branch", fuse_float_equal_branch, 0},
+};
+
+#define RULE_COUNT ((int)(sizeof(rules) / sizeof(rules[0])))
+
+int mir_peephole(MirFunction *fn)
+{
+    int total = 0;
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (int i = 0; i < fn->count; i++)
+        {
+            for (int r = 0; r < RULE_COUNT; r++)
+            {
+                // 改写后从同一位置重新匹配
+                while (i < fn->count && rules[r].apply(fn, i))
+                {
+                    // 各函数可以在不同线程中同时优化
+                    __atomic_fetch_add(&rules[r].fired, 1, __ATOMIC_RELAXED);
+                    total++;
+                    changed = true;
+                }
+            }
+        }
+    }
+    return total;
+}
+
+void mir_peephole_reset_stats(void)
+{
+    for (int r = 0; r < RULE_COUNT; r++)
+    {
+        rules[r].fired = 0;
+    }
+}
+
+void mir_peephole_report(FILE *output)
+{
+    int total = 0;
+    for (int r = 0; r < RULE_COUNT; r++)
+    {
+        total += rules[r].fired;
+    }
+    fprintf(output, "Peephole rewrites: %d\n", total);
+    for (int r = 0; r < RULE_COUNT; r++)
+    {
+        if (rules[r].fired > 0)
+            fprintf(output, "  %-24s %d\n", rules[r].name, rules[r].fired);
+    }
+}
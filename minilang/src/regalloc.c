@@ -0,0 +1,215 @@
+#include "mir.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 线性扫描寄存器分配：虚拟寄存器的活跃区间为首次到最后一次出现的指令位置，
+// 与循环（向后跳转到前面标签形成的区间）相交的活跃区间扩展到覆盖整个循环
+typedef struct
+{
+    int vreg;
+    int start;
+    int end;
+    int weight; // 出现次数，按循环嵌套深度加权，溢出时优先留下权重大的
+    int reg;    // 被调者保存寄存器下标，-1 表示溢出到栈上
+} LiveInterval;
+
+static int find_label(const MirFunction *fn, const char *label)
+{
+    for (int i = 0; i < fn->count; i++)
+    {
+        if (fn->code[i].op == MIR_LABEL && strcmp(fn->code[i].ops[0].symbol, label) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static int compare_interval_start(const void *a, const void *b)
+{
+    return ((const LiveInterval *)a)->start - ((const LiveInterval *)b)->start;
+}
+
+static void compute_intervals(const MirFunction *fn, LiveInterval *intervals)
+{
+    // 每条指令所在的循环层数
+    int *depth = calloc(fn->count + 1, sizeof(int));
+    int *loop_start = malloc((fn->count + 1) * sizeof(int));
+    int *loop_end = malloc((fn->count + 1) * sizeof(int));
+    int loop_count = 0;
+    for (int i = 0; i < fn->count; i++)
+    {
+        const MirInstr *instr = &fn->code[i];
+        if (instr->op != MIR_JMP && instr->op != MIR_JCC)
+            continue;
+        int target = find_label(fn, instr->ops[0].symbol);
+        if (target >= 0 && target < i)
+        {
+            loop_start[loop_count] = target;
+            loop_end[loop_count] = i;
+            loop_count++;
+            for (int j = target; j <= i; j++)
+            {
+                depth[j]++;
+            }
+        }
+    }
+
+    for (int v = 0; v < fn->vreg_count; v++)
+    {
+        intervals[v].vreg = v;
+        intervals[v].start = -1;
+        intervals[v].end = -1;
+        intervals[v].weight = 0;
+        intervals[v].reg = -1;
+    }
+    for (int i = 0; i < fn->count; i++)
+    {
+        const MirInstr *instr = &fn->code[i];
+        for (int k = 0; k < instr->nops; k++)
+        {
+            if (instr->ops[k].kind != MOP_VREG)
+                continue;
+            LiveInterval *interval = &intervals[instr->ops[k].reg];
+            if (interval->start < 0)
+                interval->start = i;
+            interval->end = i;
+            interval->weight += 1 << (3 * (depth[i] < 6 ? depth[i] : 6));
+        }
+    }
+
+    // 回边让循环中用到的值在整个循环内都活跃；外层循环覆盖内层，重复到不再变化
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (int l = 0; l < loop_count; l++)
+        {
+            for (int v = 0; v < fn->vreg_count; v++)
+            {
+                LiveInterval *interval = &intervals[v];
+                if (interval->start < 0 || interval->start > loop_end[l] || interval->end < loop_start[l])
+                    continue;
+                if (interval->start > loop_start[l])
+                {
+                    interval->start = loop_start[l];
+                    changed = true;
+                }
+                if (interval->end < loop_end[l])
+                {
+                    interval->end = loop_end[l];
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    free(depth);
+    free(loop_start);
+    free(loop_end);
+}
+
+// 按起点扫描区间；寄存器用完时比较权重，把权重最小的区间留在栈上
+static int scan_intervals(LiveInterval *sorted, int count, int reg_count)
+{
+    LiveInterval **active = malloc((count + 1) * sizeof(LiveInterval *));
+    int active_count = 0;
+    bool in_use[REG_COUNT] = {false};
+    int used = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        LiveInterval *current = &sorted[i];
+        if (current->start < 0)
+            continue;
+
+        // 释放已经结束的区间
+        int kept = 0;
+        for (int j = 0; j < active_count; j++)
+        {
+            if (active[j]->end < current->start)
+                in_use[active[j]->reg] = false;
+            else
+                active[kept++] = active[j];
+        }
+        active_count = kept;
+
+        int reg = -1;
+        for (int r = 0; r < reg_count; r++)
+        {
+            if (!in_use[r])
+            {
+                reg = r;
+                break;
+            }
+        }
+
+        if (reg < 0)
+        {
+            int victim = -1;
+            for (int j = 0; j < active_count; j++)
+            {
+                if (victim < 0 || active[j]->weight < active[victim]->weight)
+                    victim = j;
+            }
+            if (victim < 0 || active[victim]->weight >= current->weight)
+                continue;
+            reg = active[victim]->reg;
+            active[victim]->reg = -1;
+            active[victim] = active[--active_count];
+        }
+
+        current->reg = reg;
+        in_use[reg] = true;
+        active[active_count++] = current;
+        if (reg + 1 > used)
+            used = reg + 1;
+    }
+    free(active);
+    return used;
+}
+
+void mir_allocate_registers(MirFunction *fn)
+{
+    int count = fn->vreg_count;
+    LiveInterval *intervals = malloc((count + 1) * sizeof(LiveInterval));
+    compute_intervals(fn, intervals);
+
+    LiveInterval *sorted = malloc((count + 1) * sizeof(LiveInterval));
+    memcpy(sorted, intervals, count * sizeof(LiveInterval));
+    qsort(sorted, count, sizeof(LiveInterval), compare_interval_start);
+    fn->saved_regs = scan_intervals(sorted, count, mir_target->saved_reg_count);
+
+    // 分配结果写回按编号索引的表；溢出的虚拟寄存器依次放在已有栈帧之后
+    MirOperand *homes = malloc((count + 1) * sizeof(MirOperand));
+    int frame = fn->frame_size;
+    for (int i = 0; i < count; i++)
+    {
+        intervals[sorted[i].vreg].reg = sorted[i].reg;
+    }
+    for (int v = 0; v < count; v++)
+    {
+        if (intervals[v].reg >= 0)
+        {
+            homes[v] = mir_reg(mir_target->saved_regs[intervals[v].reg], 4);
+        }
+        else
+        {
+            frame += 4;
+            homes[v] = mir_mem(REG_RBP, -frame);
+        }
+    }
+
+    for (int i = 0; i < fn->count; i++)
+    {
+        MirInstr *instr = &fn->code[i];
+        for (int k = 0; k < instr->nops; k++)
+        {
+            if (instr->ops[k].kind == MOP_VREG)
+                instr->ops[k] = homes[instr->ops[k].reg];
+        }
+    }
+    fn->frame_size = (frame + 15) & ~15;
+
+    free(homes);
+    free(sorted);
+    free(intervals);
+}
@@ -0,0 +1,26 @@
+#include "mlrt.h"
+#include <stdlib.h>
+
+#ifdef ML_FREESTANDING
+#include "mlrt_sys.h"
+#define array_alloc(size) ml_sys_alloc(size)
+#define array_free(data) ml_sys_free(data)
+#else
+// 大数组由 calloc 直接得到清零的新页
+#define array_alloc(size) calloc(size, 1)
+#define array_free(data) free(data)
+#endif
+
+void *ml_array_new(void *old, int n)
+{
+    array_free(old);
+    void *data = n > 0 ? array_alloc((size_t)n * 4) : NULL;
+    if (data == NULL)
+        ml_runtime_error("Runtime error: Invalid array size\n");
+    return data;
+}
+
+void ml_array_free(void *data)
+{
+    array_free(data);
+}
@@ -0,0 +1,464 @@
+#include "mlrt.h"
+#include <errno.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef ML_FREESTANDING
+#include "mlrt_sys.h"
+#else
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#endif
+
+// 输出缓冲区：print 只做内存拷贝，缓冲区满、程序退出或报告运行时错误时一次写出
+#define ML_OUTPUT_CAPACITY (1 << 16)
+// float 的十进制展开最多有149位小数（最小的非规格化数是 2^-149），更多的小数位都是0
+#define ML_FLOAT_FRACTION_DIGITS 149
+// format_float 的最长结果：整数部分（小于 2^128，最多39位）、小数点和全部小数位
+#define ML_FLOAT_TEXT_SIZE (39 + 1 + ML_FLOAT_FRACTION_DIGITS)
+
+__extension__ typedef unsigned __int128 ml_u128;
+
+static char output[ML_OUTPUT_CAPACITY];
+static size_t output_length;
+#ifndef ML_FREESTANDING
+static int flush_registered;
+#endif
+
+static void write_all(const char *data, size_t size)
+{
+    while (size > 0)
+    {
+#ifdef ML_FREESTANDING
+        long n = ml_sys_write(1, data, size);
+        if (n == -EINTR)
+            continue;
+#elif defined(_WIN32)
+        int n = _write(1, data, size > 0x40000000 ? 0x40000000u : (unsigned)size);
+#else
+        ssize_t n = write(1, data, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+#endif
+        if (n <= 0)
+            return;
+        data += n;
+        size -= (size_t)n;
+    }
+}
+
+void ml_flush(void)
+{
+    write_all(output, output_length);
+    output_length = 0;
+}
+
+// 保证缓冲区至少还有 size 字节空间（size 不超过容量）；第一次输出时登记退出时刷新
+// （独立构建由 _start 在 main 返回后刷新）
+static void output_reserve(size_t size)
+{
+#ifndef ML_FREESTANDING
+    if (!flush_registered)
+    {
+        flush_registered = 1;
+        atexit(ml_flush);
+    }
+#endif
+    if (output_length + size > ML_OUTPUT_CAPACITY)
+        ml_flush();
+}
+
+static void output_write(const char *data, size_t size)
+{
+    if (size > ML_OUTPUT_CAPACITY)
+    {
+        // 比整个缓冲区还大的内容直接写出
+        output_reserve(ML_OUTPUT_CAPACITY);
+        ml_flush();
+        write_all(data, size);
+        return;
+    }
+    output_reserve(size);
+    memcpy(output + output_length, data, size);
+    output_length += size;
+}
+
+static void output_repeat(char c, int count)
+{
+    char chunk[64];
+    memset(chunk, c, sizeof(chunk));
+    for (; count > 0; count -= (int)sizeof(chunk))
+    {
+        output_write(chunk, count < (int)sizeof(chunk) ? (size_t)count : sizeof(chunk));
+    }
+}
+
+// 无符号整数的十进制数字写到 end 之前，返回第一个数字的位置；digits 为最少位数（不足补0）
+static char *format_unsigned(char *end, uint64_t value, int digits)
+{
+    char *p = end;
+    do
+    {
+        *--p = (char)('0' + value % 10);
+        value /= 10;
+        digits--;
+    } while (value != 0 || digits > 0);
+    return p;
+}
+
+static char *format_wide(char *end, ml_u128 value, int digits)
+{
+    while (value > UINT64_MAX)
+    {
+        *--end = (char)('0' + (int)(value % 10));
+        value /= 10;
+        digits--;
+    }
+    return format_unsigned(end, (uint64_t)value, digits);
+}
+
+// 与 printf("%.<precision>f") 的结果相同（不含符号，*negative 为符号位）：float 的值为 m * 2^e，
+// 整数部分用128位整数计算，小数部分是160位定点数，每乘一次10得到一位小数，剩下的部分按就近偶数舍入。
+// 展开结束后还需要的小数位不写出，个数存入 *zeros，由调用者补0
+static char *format_float(char *end, float value, int precision, int *negative, int *zeros)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    *negative = (int)(bits >> 31);
+    *zeros = 0;
+    int exponent = (int)((bits >> 23) & 0xff);
+    uint32_t mantissa = bits & 0x7fffff;
+    if (exponent == 0xff)
+    {
+        end -= 3;
+        memcpy(end, mantissa != 0 ? "nan" : "inf", 3);
+        return end;
+    }
+    if (exponent == 0)
+        exponent = 1; // 非规格化数
+    else
+        mantissa |= 1u << 23;
+    int shift = exponent - 150;
+
+    // 小数部分为 fraction / 2^160，fraction[0] 是最低的32位
+    uint32_t fraction[5] = {0};
+    ml_u128 whole;
+    if (shift >= 0)
+    {
+        whole = (ml_u128)mantissa << shift;
+    }
+    else
+    {
+        int right = -shift; // 1..149
+        uint32_t low = mantissa;
+        whole = 0;
+        if (right < 24)
+        {
+            whole = mantissa >> right;
+            low = mantissa & ((1u << right) - 1);
+        }
+        int position = 160 - right;
+        uint64_t placed = (uint64_t)low << (position % 32);
+        fraction[position / 32] = (uint32_t)placed;
+        if (position / 32 < 4)
+            fraction[position / 32 + 1] = (uint32_t)(placed >> 32);
+    }
+
+    char digits[ML_FLOAT_FRACTION_DIGITS];
+    int count = 0;
+    while (count < precision && (fraction[0] | fraction[1] | fraction[2] | fraction[3] | fraction[4]) != 0)
+    {
+        uint64_t carry = 0;
+        for (int i = 0; i < 5; i++)
+        {
+            uint64_t product = (uint64_t)fraction[i] * 10 + carry;
+            fraction[i] = (uint32_t)product;
+            carry = product >> 32;
+        }
+        digits[count++] = (char)('0' + carry);
+    }
+
+    // 剩下的部分与 1/2 比较（最高位是 1/2）
+    int above_half = fraction[4] > 0x80000000u || (fraction[4] == 0x80000000u &&
+                                                   (fraction[0] | fraction[1] | fraction[2] | fraction[3]) != 0);
+    int half = fraction[4] == 0x80000000u && !above_half;
+    int odd = count > 0 ? (digits[count - 1] - '0') & 1 : (int)(whole & 1);
+    if (above_half || (half && odd))
+    {
+        int i = count - 1;
+        while (i >= 0 && digits[i] == '9')
+        {
+            digits[i--] = '0';
+        }
+        if (i >= 0)
+            digits[i]++;
+        else
+            whole++;
+    }
+
+    char *p = end - count;
+    memcpy(p, digits, (size_t)count);
+    *zeros = precision - count;
+    if (precision > 0)
+        *--p = '.';
+    return format_wide(p, whole, 1);
+}
+
+void ml_print_int(int value)
+{
+    char text[12];
+    char *end = text + sizeof(text);
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+    char *p = format_unsigned(end, magnitude, 1);
+    if (value < 0)
+        *--p = '-';
+    output_write(p, (size_t)(end - p));
+}
+
+void ml_print_float(float value)
+{
+    char text[64];
+    char *end = text + sizeof(text);
+    int negative;
+    int zeros;
+    char *p = format_float(end, value, 6, &negative, &zeros);
+    if (negative)
+        *--p = '-';
+    output_write(p, (size_t)(end - p));
+    output_repeat('0', zeros);
+}
+
+void ml_print_str(const char *str)
+{
+    output_write(str, strlen(str));
+}
+
+#ifdef ML_FREESTANDING
+// 不链接 C 库时的格式化输出：支持标志 -0+ 和空格、宽度、精度，以及 d i u x c s f % 转换，
+// 其他转换原样输出。浮点实参都由 float 转换而来，按 float 格式化。精度不受缓冲区大小限制：
+// 整数前面和小数后面补的0直接写出；%s 的实参为 NULL 时与 glibc 一样输出 (null)（精度小于6时不输出）
+int ml_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int total = 0;
+    for (const char *p = format; *p; p++)
+    {
+        if (*p != '%')
+        {
+            const char *start = p;
+            while (p[1] != '\0' && p[1] != '%')
+            {
+                p++;
+            }
+            output_write(start, (size_t)(p - start + 1));
+            total += (int)(p - start + 1);
+            continue;
+        }
+
+        const char *spec = p++;
+        int left = 0;
+        int zero = 0;
+        char sign = 0;
+        for (;; p++)
+        {
+            if (*p == '-')
+                left = 1;
+            else if (*p == '0')
+                zero = 1;
+            else if (*p == '+')
+                sign = '+';
+            else if (*p == ' ' && sign == 0)
+                sign = ' ';
+            else
+                break;
+        }
+        int width = 0;
+        while (*p >= '0' && *p <= '9')
+        {
+            width = width * 10 + (*p++ - '0');
+        }
+        int precision = -1;
+        if (*p == '.')
+        {
+            precision = 0;
+            p++;
+            while (*p >= '0' && *p <= '9')
+            {
+                precision = precision * 10 + (*p++ - '0');
+            }
+        }
+
+        char buffer[ML_FLOAT_TEXT_SIZE];
+        char *end = buffer + sizeof(buffer);
+        const char *text = end;
+        size_t length;
+        int negative = 0;
+        int leading_zeros = 0;  // 整数精度要求的前导0
+        int trailing_zeros = 0; // %f 展开结束后的小数位
+        switch (*p)
+        {
+        case 'd':
+        case 'i':
+        {
+            int value = va_arg(args, int);
+            uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+            // 与 printf 一样，精度为0时数值0不输出数字
+            if (magnitude != 0 || precision != 0)
+                text = format_unsigned(end, magnitude, 1);
+            negative = value < 0;
+            zero = zero && precision < 0;
+            break;
+        }
+        case 'u':
+        {
+            unsigned value = va_arg(args, unsigned);
+            if (value != 0 || precision != 0)
+                text = format_unsigned(end, value, 1);
+            sign = 0;
+            zero = zero && precision < 0;
+            break;
+        }
+        case 'x':
+        {
+            unsigned value = va_arg(args, unsigned);
+            char *q = end;
+            while (value != 0 || (q == end && precision != 0))
+            {
+                *--q = "0123456789abcdef"[value & 15];
+                value >>= 4;
+            }
+            text = q;
+            sign = 0;
+            zero = zero && precision < 0;
+            break;
+        }
+        case 'c':
+            buffer[0] = (char)va_arg(args, int);
+            text = buffer;
+            end = buffer + 1;
+            sign = 0;
+            break;
+        case 's':
+            text = va_arg(args, const char *);
+            if (text == NULL)
+                text = precision < 0 || precision >= 6 ? "(null)" : "";
+            end = (char *)text + strlen(text);
+            if (precision >= 0 && (size_t)precision < (size_t)(end - text))
+                end = (char *)text + precision;
+            sign = 0;
+            zero = 0;
+            break;
+        case 'f':
+            text = format_float(end, (float)va_arg(args, double), precision < 0 ? 6 : precision, &negative,
+                                &trailing_zeros);
+            zero = zero && text[0] >= '0' && text[0] <= '9'; // inf/nan 不补0
+            break;
+        case '%':
+            text = "%";
+            end = (char *)text + 1;
+            sign = 0;
+            width = 0;
+            break;
+        default:
+            // 不支持的转换原样输出
+            if (*p == '\0')
+                p--;
+            output_write(spec, (size_t)(p - spec + 1));
+            total += (int)(p - spec + 1);
+            continue;
+        }
+
+        length = (size_t)(end - text);
+        if ((*p == 'd' || *p == 'i' || *p == 'u' || *p == 'x') && precision > (int)length)
+            leading_zeros = precision - (int)length;
+        int digits = leading_zeros + (int)length + trailing_zeros;
+        char prefix = negative ? '-' : sign;
+        int padding = width - digits - (prefix != 0);
+        if (!left && !zero)
+            output_repeat(' ', padding);
+        if (prefix != 0)
+            output_write(&prefix, 1);
+        if (!left && zero)
+            output_repeat('0', padding);
+        output_repeat('0', leading_zeros);
+        output_write(text, length);
+        output_repeat('0', trailing_zeros);
+        if (left)
+            output_repeat(' ', padding);
+        total += digits + (prefix != 0) + (padding > 0 ? padding : 0);
+    }
+    va_end(args);
+    return total;
+}
+#else
+int ml_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    va_list copy;
+    va_copy(copy, args);
+
+    output_reserve(0);
+    size_t space = ML_OUTPUT_CAPACITY - output_length;
+    int n = vsnprintf(output + output_length, space, format, args);
+    if (n >= 0 && (size_t)n < space)
+    {
+        output_length += (size_t)n;
+    }
+    else if (n >= 0 && n < ML_OUTPUT_CAPACITY)
+    {
+        // 放不下：写出已有内容后在缓冲区开头重新格式化
+        ml_flush();
+        vsnprintf(output, ML_OUTPUT_CAPACITY, format, copy);
+        output_length = (size_t)n;
+    }
+    else if (n >= 0)
+    {
+        char *text = malloc((size_t)n + 1);
+        if (text)
+        {
+            vsnprintf(text, (size_t)n + 1, format, copy);
+            output_write(text, (size_t)n);
+            free(text);
+        }
+    }
+    va_end(copy);
+    va_end(args);
+    return n;
+}
+#endif
+
+void ml_runtime_error(const char *message)
+{
+    // 错误信息接在已有输出之后，与程序的输出顺序一致
+    output_write(message, strlen(message));
+    ml_flush();
+#ifdef ML_FREESTANDING
+    ml_sys_exit(1);
+#else
+    exit(1);
+#endif
+}
+
+void ml_bounds_error(void)
+{
+    ml_runtime_error("Runtime error: Array index out of bounds\n");
+}
+
+void ml_division_error(void)
+{
+    ml_runtime_error("Runtime error: Division by zero\n");
+}
+
+void ml_sort_size_error(const char *name, const char *keys, int size, int key_size)
+{
+    ml_printf("Runtime error: sort_by arrays '%s' and '%s' differ in size (%d vs %d)\n", name, keys, size, key_size);
+    ml_runtime_error("");
+}
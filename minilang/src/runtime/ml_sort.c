@@ -0,0 +1,247 @@
+#include "mlrt.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ML_FREESTANDING
+#include "mlrt_sys.h"
+#define sort_alloc(size) ml_sys_alloc(size)
+#define sort_free(data) ml_sys_free(data)
+#else
+#define sort_alloc(size) malloc(size)
+#define sort_free(data) free(data)
+#endif
+
+#ifndef ML_NO_THREADS
+#include <pthread.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#endif
+
+// 短于该长度使用内省排序，否则使用基数排序
+#define SORT_RADIX_MIN 256
+// 内省排序中短区间改用插入排序
+#define SORT_INSERTION_MAX 16
+// 每个线程至少分到的元素个数
+#define SORT_PARALLEL_CHUNK (1 << 18)
+#define SORT_MAX_THREADS 16
+
+// 并行排序/归并任务：处理 [lo, hi)，归并时 mid 为两段分界
+typedef struct
+{
+    void *src;
+    void *dst;
+    size_t lo;
+    size_t mid;
+    size_t hi;
+} SortJob;
+
+static int sort_depth_limit(size_t n)
+{
+    int depth = 0;
+    while (n > 1)
+    {
+        n >>= 1;
+        depth++;
+    }
+    return depth * 2;
+}
+
+static int sort_thread_count(size_t n)
+{
+#ifdef ML_NO_THREADS
+    (void)n;
+    return 1;
+#else
+    size_t wanted = n / SORT_PARALLEL_CHUNK;
+    if (wanted < 2)
+        return 1;
+
+    long cpus;
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    cpus = (long)info.dwNumberOfProcessors;
+#else
+    cpus = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (cpus < 1)
+        cpus = 1;
+    if (wanted > (size_t)cpus)
+        wanted = (size_t)cpus;
+    if (wanted > SORT_MAX_THREADS)
+        wanted = SORT_MAX_THREADS;
+    return (int)wanted;
+#endif
+}
+
+// 第一个任务在当前线程执行，其余各开一个线程；线程创建失败时就地执行
+static void run_jobs(void *(*fn)(void *), SortJob *jobs, int count)
+{
+#ifdef ML_NO_THREADS
+    for (int i = 0; i < count; i++)
+    {
+        fn(&jobs[i]);
+    }
+#else
+    pthread_t tids[SORT_MAX_THREADS];
+    bool started[SORT_MAX_THREADS];
+    for (int i = 1; i < count; i++)
+    {
+        started[i] = pthread_create(&tids[i], NULL, fn, &jobs[i]) == 0;
+        if (!started[i])
+        {
+            fn(&jobs[i]);
+        }
+    }
+    fn(&jobs[0]);
+    for (int i = 1; i < count; i++)
+    {
+        if (started[i])
+        {
+            pthread_join(tids[i], NULL);
+        }
+    }
+#endif
+}
+
+#define SORT_T uint32_t
+#define SORT_S u32
+#define SORT_KEY(x) (x)
+#include "ml_sort_impl.h"
+#undef SORT_T
+#undef SORT_S
+#undef SORT_KEY
+
+#define SORT_T uint64_t
+#define SORT_S u64
+#define SORT_KEY(x) ((uint32_t)((x) >> 32))
+#include "ml_sort_impl.h"
+#undef SORT_T
+#undef SORT_S
+#undef SORT_KEY
+
+// 保序键变换：变换后按无符号整数比较即为原值的大小关系
+static inline uint32_t int_to_key(uint32_t bits)
+{
+    return bits ^ 0x80000000u;
+}
+
+static inline uint32_t key_to_int(uint32_t key)
+{
+    return key ^ 0x80000000u;
+}
+
+// IEEE 754：非负数翻转符号位，负数按位取反
+static inline uint32_t float_to_key(uint32_t bits)
+{
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+static inline uint32_t key_to_float(uint32_t key)
+{
+    return (key & 0x80000000u) ? (key & 0x7fffffffu) : ~key;
+}
+
+static int sort_keys_in_place(uint32_t *keys, int n)
+{
+    uint32_t *tmp = NULL;
+    if (n >= SORT_RADIX_MIN)
+    {
+        // 分配失败时 sort_all 退化为原地内省排序
+        tmp = sort_alloc((size_t)n * sizeof(uint32_t));
+    }
+    sort_all_u32(keys, tmp, (size_t)n);
+    sort_free(tmp);
+    return 0;
+}
+
+int ml_sort_int(int *data, int n, int descending)
+{
+    if (data == NULL || n < 2)
+        return 0;
+
+    uint32_t *keys = (uint32_t *)(void *)data;
+    uint32_t flip = descending ? 0xffffffffu : 0u;
+    for (int i = 0; i < n; i++)
+    {
+        keys[i] = int_to_key(keys[i]) ^ flip;
+    }
+    sort_keys_in_place(keys, n);
+    for (int i = 0; i < n; i++)
+    {
+        keys[i] = key_to_int(keys[i] ^ flip);
+    }
+    return 0;
+}
+
+int ml_sort_float(float *data, int n, int descending)
+{
+    if (data == NULL || n < 2)
+        return 0;
+
+    uint32_t *keys = (uint32_t *)(void *)data;
+    uint32_t flip = descending ? 0xffffffffu : 0u;
+    for (int i = 0; i < n; i++)
+    {
+        uint32_t bits;
+        memcpy(&bits, &data[i], sizeof(bits));
+        keys[i] = float_to_key(bits) ^ flip;
+    }
+    sort_keys_in_place(keys, n);
+    for (int i = 0; i < n; i++)
+    {
+        uint32_t bits = key_to_float(keys[i] ^ flip);
+        memcpy(&data[i], &bits, sizeof(bits));
+    }
+    return 0;
+}
+
+int ml_sort_by_key(void *values, void *keys, int n, int key_is_float, int descending)
+{
+    if (values == NULL || keys == NULL || n < 2)
+        return 0;
+
+    // 高32位为变换后的键，低32位为原始下标
+    uint64_t *pairs = sort_alloc((size_t)n * sizeof(uint64_t));
+    uint32_t *scratch = sort_alloc((size_t)n * sizeof(uint32_t));
+    if (pairs == NULL || scratch == NULL)
+    {
+        sort_free(pairs);
+        sort_free(scratch);
+        return -1;
+    }
+    uint64_t *tmp = n >= SORT_RADIX_MIN ? sort_alloc((size_t)n * sizeof(uint64_t)) : NULL;
+
+    uint32_t *key_bits = keys;
+    uint32_t *value_bits = values;
+    uint32_t flip = descending ? 0xffffffffu : 0u;
+    for (int i = 0; i < n; i++)
+    {
+        uint32_t key = key_is_float ? float_to_key(key_bits[i]) : int_to_key(key_bits[i]);
+        pairs[i] = ((uint64_t)(key ^ flip) << 32) | (uint32_t)i;
+    }
+
+    sort_all_u64(pairs, tmp, (size_t)n);
+
+    for (int i = 0; i < n; i++)
+    {
+        scratch[i] = value_bits[(uint32_t)pairs[i]];
+    }
+    memcpy(value_bits, scratch, (size_t)n * sizeof(uint32_t));
+    for (int i = 0; i < n; i++)
+    {
+        uint32_t key = (uint32_t)(pairs[i] >> 32) ^ flip;
+        key_bits[i] = key_is_float ? key_to_float(key) : key_to_int(key);
+    }
+
+    sort_free(tmp);
+    sort_free(scratch);
+    sort_free(pairs);
+    return 0;
+}
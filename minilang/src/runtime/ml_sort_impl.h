@@ -0,0 +1,262 @@
+// 排序算法模板，由 ml_sort.c 按元素类型多次包含
+// 包含前需定义：
+//   SORT_T       元素类型（无符号整数）
+//   SORT_S       函数名后缀
+//   SORT_KEY(x)  元素的32位排序键（基数排序使用）
+// 元素之间直接按无符号整数比较；高位为键、低位为原始下标时比较结果即为稳定顺序
+
+#define SORT_CAT2(a, b) a##_##b
+#define SORT_CAT(a, b) SORT_CAT2(a, b)
+#define SORT_FN(name) SORT_CAT(name, SORT_S)
+
+static void SORT_FN(insertion_sort)(SORT_T *a, size_t n)
+{
+    for (size_t i = 1; i < n; i++)
+    {
+        SORT_T x = a[i];
+        size_t j = i;
+        while (j > 0 && x < a[j - 1])
+        {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = x;
+    }
+}
+
+static void SORT_FN(sift_down)(SORT_T *a, size_t i, size_t n)
+{
+    SORT_T x = a[i];
+    for (;;)
+    {
+        size_t child = 2 * i + 1;
+        if (child >= n)
+            break;
+        if (child + 1 < n && a[child] < a[child + 1])
+            child++;
+        if (!(x < a[child]))
+            break;
+        a[i] = a[child];
+        i = child;
+    }
+    a[i] = x;
+}
+
+static void SORT_FN(heap_sort)(SORT_T *a, size_t n)
+{
+    for (size_t i = n / 2; i > 0; i--)
+    {
+        SORT_FN(sift_down)(a, i - 1, n);
+    }
+    for (size_t end = n - 1; end > 0; end--)
+    {
+        SORT_T t = a[0];
+        a[0] = a[end];
+        a[end] = t;
+        SORT_FN(sift_down)(a, 0, end);
+    }
+}
+
+// 内省排序：三数取中快排，递归过深时退化为堆排序，短区间插入排序
+static void SORT_FN(intro_sort)(SORT_T *a, size_t n, int depth)
+{
+    while (n > SORT_INSERTION_MAX)
+    {
+        if (depth-- == 0)
+        {
+            SORT_FN(heap_sort)(a, n);
+            return;
+        }
+
+        SORT_T x = a[0], y = a[n / 2], z = a[n - 1];
+        SORT_T pivot = x < y ? (y < z ? y : (x < z ? z : x))
+                             : (x < z ? x : (y < z ? z : y));
+
+        // Hoare 划分：[0, j] <= pivot <= [j + 1, n)
+        ptrdiff_t i = -1, j = (ptrdiff_t)n;
+        for (;;)
+        {
+            do
+                i++;
+            while (a[i] < pivot);
+            do
+                j--;
+            while (pivot < a[j]);
+            if (i >= j)
+                break;
+            SORT_T t = a[i];
+            a[i] = a[j];
+            a[j] = t;
+        }
+
+        // 递归较短的一侧，循环处理较长的一侧
+        size_t left = (size_t)j + 1;
+        if (left < n - left)
+        {
+            SORT_FN(intro_sort)(a, left, depth);
+            a += left;
+            n -= left;
+        }
+        else
+        {
+            SORT_FN(intro_sort)(a + left, n - left, depth);
+            n = left;
+        }
+    }
+    SORT_FN(insertion_sort)(a, n);
+}
+
+// LSD 基数排序：每次8位共4趟，键的某个字节全部相同时跳过该趟
+static void SORT_FN(radix_sort)(SORT_T *a, SORT_T *tmp, size_t n)
+{
+    size_t count[4][256];
+    memset(count, 0, sizeof(count));
+    for (size_t i = 0; i < n; i++)
+    {
+        uint32_t k = SORT_KEY(a[i]);
+        count[0][k & 0xff]++;
+        count[1][(k >> 8) & 0xff]++;
+        count[2][(k >> 16) & 0xff]++;
+        count[3][k >> 24]++;
+    }
+
+    SORT_T *src = a;
+    SORT_T *dst = tmp;
+    for (int pass = 0; pass < 4; pass++)
+    {
+        int shift = pass * 8;
+        size_t *c = count[pass];
+        if (c[(SORT_KEY(src[0]) >> shift) & 0xff] == n)
+            continue;
+
+        size_t sum = 0;
+        for (int b = 0; b < 256; b++)
+        {
+            size_t t = c[b];
+            c[b] = sum;
+            sum += t;
+        }
+        for (size_t i = 0; i < n; i++)
+        {
+            SORT_T x = src[i];
+            dst[c[(SORT_KEY(x) >> shift) & 0xff]++] = x;
+        }
+
+        SORT_T *t = src;
+        src = dst;
+        dst = t;
+    }
+
+    if (src != a)
+    {
+        memcpy(a, src, n * sizeof(SORT_T));
+    }
+}
+
+static void SORT_FN(sort_run)(SORT_T *a, SORT_T *tmp, size_t n)
+{
+    if (n < SORT_RADIX_MIN || tmp == NULL)
+    {
+        SORT_FN(intro_sort)(a, n, sort_depth_limit(n));
+    }
+    else
+    {
+        SORT_FN(radix_sort)(a, tmp, n);
+    }
+}
+
+// 归并 src[0, mid) 与 src[mid, n) 到 dst，相等时取左段保证稳定
+static void SORT_FN(merge_runs)(const SORT_T *src, size_t mid, size_t n, SORT_T *dst)
+{
+    size_t i = 0, j = mid, k = 0;
+    while (i < mid && j < n)
+    {
+        dst[k++] = (src[j] < src[i]) ? src[j++] : src[i++];
+    }
+    memcpy(dst + k, src + i, (mid - i) * sizeof(SORT_T));
+    k += mid - i;
+    memcpy(dst + k, src + j, (n - j) * sizeof(SORT_T));
+}
+
+static void *SORT_FN(run_job)(void *arg)
+{
+    SortJob *job = arg;
+    SORT_T *src = job->src;
+    SORT_T *dst = job->dst;
+    SORT_FN(sort_run)(src + job->lo, dst + job->lo, job->hi - job->lo);
+    return NULL;
+}
+
+static void *SORT_FN(merge_job)(void *arg)
+{
+    SortJob *job = arg;
+    const SORT_T *src = job->src;
+    SORT_T *dst = job->dst;
+    SORT_FN(merge_runs)(src + job->lo, job->mid - job->lo, job->hi - job->lo, dst + job->lo);
+    return NULL;
+}
+
+// 大数组切分为若干段并行排序，再逐轮两两并行归并
+static void SORT_FN(sort_all)(SORT_T *a, SORT_T *tmp, size_t n)
+{
+    int threads = tmp ? sort_thread_count(n) : 1;
+    if (threads <= 1)
+    {
+        SORT_FN(sort_run)(a, tmp, n);
+        return;
+    }
+
+    size_t bounds[SORT_MAX_THREADS + 1];
+    SortJob jobs[SORT_MAX_THREADS];
+    for (int t = 0; t <= threads; t++)
+    {
+        bounds[t] = n * (size_t)t / (size_t)threads;
+    }
+    for (int t = 0; t < threads; t++)
+    {
+        jobs[t].src = a;
+        jobs[t].dst = tmp;
+        jobs[t].lo = bounds[t];
+        jobs[t].mid = bounds[t + 1];
+        jobs[t].hi = bounds[t + 1];
+    }
+    run_jobs(SORT_FN(run_job), jobs, threads);
+
+    SORT_T *src = a;
+    SORT_T *dst = tmp;
+    int runs = threads;
+    while (runs > 1)
+    {
+        int count = 0;
+        for (int r = 0; r < runs; r += 2)
+        {
+            jobs[count].src = src;
+            jobs[count].dst = dst;
+            jobs[count].lo = bounds[r];
+            jobs[count].mid = bounds[r + 1];
+            jobs[count].hi = (r + 2 <= runs) ? bounds[r + 2] : bounds[r + 1];
+            count++;
+        }
+        run_jobs(SORT_FN(merge_job), jobs, count);
+
+        for (int r = 0; r < count; r++)
+        {
+            bounds[r] = bounds[2 * r];
+        }
+        bounds[count] = n;
+        runs = count;
+
+        SORT_T *t = src;
+        src = dst;
+        dst = t;
+    }
+
+    if (src != a)
+    {
+        memcpy(a, src, n * sizeof(SORT_T));
+    }
+}
+
+#undef SORT_FN
+#undef SORT_CAT
+#undef SORT_CAT2
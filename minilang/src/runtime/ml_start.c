@@ -0,0 +1,145 @@
+#include "mlrt.h"
+#include "mlrt_sys.h"
+#include <stdint.h>
+
+// 独立运行时的程序入口和系统调用：进程从 _start 直接进入 main，不经过动态链接器和 C 库初始化。
+// 不链接 C 库时，编译器生成的代码仍可能调用 memcpy/memmove/memset/memcmp/strlen，这里一并提供
+
+#define SYS_WRITE 1
+#define SYS_MMAP 9
+#define SYS_MUNMAP 11
+#define SYS_EXIT_GROUP 231
+
+#define PROT_READ_WRITE 0x3
+#define MAP_PRIVATE_ANONYMOUS 0x22
+#define PAGE_SIZE 4096
+// ml_sys_alloc 在映射开头记录长度，返回的指针保持16字节对齐
+#define ALLOC_HEADER 16
+
+static long syscall2(long number, long a, long b)
+{
+    long result;
+    __asm__ volatile("syscall" : "=a"(result) : "a"(number), "D"(a), "S"(b) : "rcx", "r11", "memory");
+    return result;
+}
+
+static long syscall3(long number, long a, long b, long c)
+{
+    long result;
+    __asm__ volatile("syscall" : "=a"(result) : "a"(number), "D"(a), "S"(b), "d"(c) : "rcx", "r11", "memory");
+    return result;
+}
+
+static long syscall6(long number, long a, long b, long c, long d, long e, long f)
+{
+    long result;
+    register long r10 __asm__("r10") = d;
+    register long r8 __asm__("r8") = e;
+    register long r9 __asm__("r9") = f;
+    __asm__ volatile("syscall"
+                     : "=a"(result)
+                     : "a"(number), "D"(a), "S"(b), "d"(c), "r"(r10), "r"(r8), "r"(r9)
+                     : "rcx", "r11", "memory");
+    return result;
+}
+
+long ml_sys_write(int fd, const void *data, size_t size)
+{
+    return syscall3(SYS_WRITE, fd, (long)data, (long)size);
+}
+
+void ml_sys_exit(int status)
+{
+    for (;;)
+    {
+        syscall2(SYS_EXIT_GROUP, status, 0);
+    }
+}
+
+void *ml_sys_alloc(size_t size)
+{
+    size_t length = (size + ALLOC_HEADER + PAGE_SIZE - 1) & ~(size_t)(PAGE_SIZE - 1);
+    if (length < size)
+        return NULL;
+    long addr = syscall6(SYS_MMAP, 0, (long)length, PROT_READ_WRITE, MAP_PRIVATE_ANONYMOUS, -1, 0);
+    if (addr < 0 && addr > -PAGE_SIZE)
+        return NULL;
+    *(size_t *)addr = length;
+    return (char *)addr + ALLOC_HEADER;
+}
+
+void ml_sys_free(void *data)
+{
+    if (data == NULL)
+        return;
+    char *base = (char *)data - ALLOC_HEADER;
+    syscall2(SYS_MUNMAP, (long)base, (long)*(size_t *)base);
+}
+
+void ml_exit(int status)
+{
+    ml_flush();
+    ml_sys_exit(status);
+}
+
+// 栈顶依次是 argc、argv；对齐栈后调用 main，返回值作为退出状态
+__asm__(".text\n"
+        ".globl _start\n"
+        ".type _start, @function\n"
+        "_start:\n"
+        "\txorl %ebp, %ebp\n"
+        "\tmovq (%rsp), %rdi\n"
+        "\tleaq 8(%rsp), %rsi\n"
+        "\tandq $-16, %rsp\n"
+        "\tcall main\n"
+        "\tmovl %eax, %edi\n"
+        "\tcall ml_exit\n"
+        "\thlt\n"
+        ".size _start, .-_start\n");
+
+void *memcpy(void *dst, const void *src, size_t n)
+{
+    void *d = dst;
+    __asm__ volatile("rep movsb" : "+D"(d), "+S"(src), "+c"(n) : : "memory");
+    return dst;
+}
+
+void *memmove(void *dst, const void *src, size_t n)
+{
+    if ((uintptr_t)dst - (uintptr_t)src >= n)
+        return memcpy(dst, src, n);
+    // 目标与源重叠且在源之后：从末尾向前复制
+    void *d = (char *)dst + n - 1;
+    const void *s = (const char *)src + n - 1;
+    __asm__ volatile("std\n\trep movsb\n\tcld" : "+D"(d), "+S"(s), "+c"(n) : : "memory");
+    return dst;
+}
+
+void *memset(void *dst, int c, size_t n)
+{
+    void *d = dst;
+    __asm__ volatile("rep stosb" : "+D"(d), "+c"(n) : "a"(c) : "memory");
+    return dst;
+}
+
+int memcmp(const void *a, const void *b, size_t n)
+{
+    const unsigned char *p = a;
+    const unsigned char *q = b;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (p[i] != q[i])
+            return p[i] - q[i];
+    }
+    return 0;
+}
+
+size_t strlen(const char *str)
+{
+    const char *p = str;
+    while (*p)
+    {
+        p++;
+    }
+    return (size_t)(p - str);
+}
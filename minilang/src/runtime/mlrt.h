@@ -0,0 +1,39 @@
+#ifndef MLRT_H
+#define MLRT_H
+
+// MyLang 运行时库
+// 解释器与编译生成的本地程序共用这些入口（本地程序链接 build/libmlrt.a）
+
+// 排序：成功返回0，内存不足返回-1（数组保持原样）
+// descending 非0时降序
+int ml_sort_int(int *data, int n, int descending);
+int ml_sort_float(float *data, int n, int descending);
+
+// 按键排序：keys 排序的同时按相同的置换重排 values（稳定排序）
+// values 与 keys 的元素都是4字节（int 或 float）
+int ml_sort_by_key(void *values, void *keys, int n, int key_is_float, int descending);
+
+// 输出：写入运行时的输出缓冲区，缓冲区满或程序退出时写到标准输出
+// ml_print_int/ml_print_float/ml_print_str 分别与 printf 的 %d、%f、%s 输出相同，但不解析格式
+void ml_print_int(int value);
+void ml_print_float(float value);
+void ml_print_str(const char *str);
+// 通用格式输出，返回输出的字符数
+int ml_printf(const char *format, ...);
+// 立即写出缓冲区中的输出
+void ml_flush(void);
+
+// 运行时错误：在已有输出之后输出 message，以状态1退出
+void ml_runtime_error(const char *message);
+// 数组下标越界
+void ml_bounds_error(void);
+// 除数为0
+void ml_division_error(void);
+// sort_by 的两个数组元素个数不同
+void ml_sort_size_error(const char *name, const char *keys, int size, int key_size);
+
+// 数组：释放 old（可为 NULL）后分配 n 个清零的4字节元素；n 不是正数或内存不足时报错退出
+void *ml_array_new(void *old, int n);
+void ml_array_free(void *data);
+
+#endif // MLRT_H
@@ -0,0 +1,18 @@
+#ifndef MLRT_SYS_H
+#define MLRT_SYS_H
+
+// 运行时库内部接口：独立构建（ML_FREESTANDING，-static-start 链接的 libmlrt_start.a）不链接 C 库，
+// 输出、退出和内存分配直接使用 Linux x86-64 系统调用，由 ml_start.c 提供
+
+#include <stddef.h>
+
+// 写出失败时返回负的错误码
+long ml_sys_write(int fd, const void *data, size_t size);
+void ml_sys_exit(int status);
+// 按页映射的清零内存，失败时返回 NULL
+void *ml_sys_alloc(size_t size);
+void ml_sys_free(void *data);
+// main 返回后由 _start 调用：写出输出缓冲区后退出
+void ml_exit(int status);
+
+#endif // MLRT_SYS_H
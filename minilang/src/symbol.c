@@ -1,4 +1,5 @@
 #include "symbol.h"
+#include "map.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -32,7 +33,8 @@ Symbol *find_symbol(const char *name)
     return NULL;
 }
 
-void set_symbol(const char *name, int int_value, float float_value, char *string_value, int type, bool is_function)
+// 查找符号，不存在时在表尾新建（各字段清零）
+static Symbol *find_or_add_symbol(const char *name, bool *created)
 {
     if (name == NULL)
     {
@@ -40,22 +42,11 @@ void set_symbol(const char *name, int int_value, float float_value, char *string
         exit(1);
     }
 
-    for (int i = 0; i < symbol_count; i++)
+    Symbol *sym = find_symbol(name);
+    *created = sym == NULL;
+    if (sym)
     {
-        if (symbol_table[i].name != NULL && strcmp(symbol_table[i].name, name) == 0)
-        {
-            symbol_table[i].int_value = int_value;
-            symbol_table[i].float_value = float_value;
-            if (symbol_table[i].string_value != NULL)
-            {
-                free(symbol_table[i].string_value);
-            }
-            symbol_table[i].string_value = string_value ? strdup(string_value) : NULL;
-            symbol_table[i].type = type;
-            symbol_table[i].is_initialized = true;
-            symbol_table[i].is_function = is_function;
-            return;
-        }
+        return sym;
     }
 
     if (symbol_count >= symbol_capacity)
@@ -69,19 +60,36 @@ void set_symbol(const char *name, int int_value, float float_value, char *string
         }
     }
 
-    symbol_table[symbol_count].name = strdup(name);
-    symbol_table[symbol_count].int_value = int_value;
-    symbol_table[symbol_count].float_value = float_value;
-    symbol_table[symbol_count].string_value = string_value ? strdup(string_value) : NULL;
-    symbol_table[symbol_count].type = type;
-    symbol_table[symbol_count].array_size = 0;
-    symbol_table[symbol_count].array_data = NULL;
-    symbol_table[symbol_count].is_initialized = false;
-    symbol_table[symbol_count].is_function = is_function;
-    symbol_table[symbol_count].param_types = NULL;
-    symbol_table[symbol_count].param_count = 0;
-    symbol_table[symbol_count].function_def = NULL;
-    symbol_count++;
+    sym = &symbol_table[symbol_count++];
+    memset(sym, 0, sizeof(Symbol));
+    sym->name = strdup(name);
+    return sym;
+}
+
+// string_value 的引用由符号接管
+static void set_symbol_value(const char *name, int int_value, float float_value, MLString string_value,
+                             int type, bool is_function)
+{
+    bool created;
+    Symbol *sym = find_or_add_symbol(name, &created);
+    sym->int_value = int_value;
+    sym->float_value = float_value;
+    ml_string_release(&sym->string_value);
+    sym->string_value = string_value;
+    sym->type = type;
+    sym->is_initialized = !created;
+    sym->is_function = is_function;
+}
+
+void set_symbol(const char *name, int int_value, float float_value, char *string_value, int type, bool is_function)
+{
+    set_symbol_value(name, int_value, float_value, ml_string_from_cstr(string_value), type, is_function);
+}
+
+// 字符串赋值不复制内容，只转移引用
+void set_symbol_string(const char *name, MLString value)
+{
+    set_symbol_value(name, 0, 0.0f, value, TYPE_STRING, false);
 }
 
 void set_function_params(const char *name, char **param_types, int param_count)
@@ -119,6 +127,14 @@ int get_type_from_string(const char *type_str)
         return TYPE_FLOAT;
     if (strcmp(type_str, "string") == 0)
         return TYPE_STRING;
+    if (strcmp(type_str, "int[]") == 0)
+        return TYPE_INT_ARRAY;
+    if (strcmp(type_str, "float[]") == 0)
+        return TYPE_FLOAT_ARRAY;
+    if (strcmp(type_str, "string[]") == 0)
+        return TYPE_STRING_ARRAY;
+    if (strcmp(type_str, "map") == 0)
+        return TYPE_MAP;
     return TYPE_INT; // 默认
 }
 
@@ -126,25 +142,28 @@ void free_current_symbol_table()
 {
     for (int i = 0; i < symbol_count; i++)
     {
+        // 函数符号是从调用者符号表浅复制来的，由调用者释放
+        if (symbol_table[i].is_function)
+        {
+            continue;
+        }
         if (symbol_table[i].name != NULL)
         {
             free(symbol_table[i].name);
         }
-        if (symbol_table[i].string_value != NULL)
+        ml_string_release(&symbol_table[i].string_value);
+        if (symbol_table[i].array_data != NULL && symbol_table[i].type == TYPE_MAP)
         {
-            free(symbol_table[i].string_value);
+            map_free(symbol_table[i].array_data);
         }
-        if (symbol_table[i].array_data != NULL)
+        else if (symbol_table[i].array_data != NULL)
         {
             if (symbol_table[i].type == TYPE_STRING_ARRAY)
             {
-                char **str_array = (char **)symbol_table[i].array_data;
+                MLString *str_array = symbol_table[i].array_data;
                 for (int j = 0; j < symbol_table[i].array_size; j++)
                 {
-                    if (str_array[j] != NULL)
-                    {
-                        free(str_array[j]);
-                    }
+                    ml_string_release(&str_array[j]);
                 }
             }
             free(symbol_table[i].array_data);
@@ -167,21 +186,19 @@ void ast_free_symbol_table()
         {
             free(symbol_table[i].name);
         }
-        if (symbol_table[i].string_value != NULL)
+        ml_string_release(&symbol_table[i].string_value);
+        if (symbol_table[i].array_data != NULL && symbol_table[i].type == TYPE_MAP)
         {
-            free(symbol_table[i].string_value);
+            map_free(symbol_table[i].array_data);
         }
-        if (symbol_table[i].array_data != NULL)
+        else if (symbol_table[i].array_data != NULL)
         {
             if (symbol_table[i].type == TYPE_STRING_ARRAY)
             {
-                char **str_array = (char **)symbol_table[i].array_data;
+                MLString *str_array = symbol_table[i].array_data;
                 for (int j = 0; j < symbol_table[i].array_size; j++)
                 {
-                    if (str_array[j] != NULL)
-                    {
-                        free(str_array[j]);
-                    }
+                    ml_string_release(&str_array[j]);
                 }
             }
             free(symbol_table[i].array_data);
@@ -2,6 +2,7 @@
 #define SYMBOL_H
 
 #include "ast.h"
+#include "mlstring.h"
 
 // 明确的类型定义
 #define TYPE_INT 0
@@ -11,6 +12,7 @@
 #define TYPE_FLOAT_ARRAY 4
 #define TYPE_STRING_ARRAY 5
 #define TYPE_FUNCTION 6
+#define TYPE_MAP 7
 
 // 符号表结构
 typedef struct
@@ -18,10 +20,10 @@ typedef struct
     char *name;
     int int_value;
     float float_value;
-    char *string_value;
+    MLString string_value;
     int type;
     int array_size;
-    void *array_data;
+    void *array_data; // 数组元素（string[] 为 MLString 数组）；TYPE_MAP 时为 Map*
     bool is_initialized;
 
     // 函数相关字段
@@ -34,6 +36,7 @@ typedef struct
 // 符号表函数
 Symbol *find_symbol(const char *name);
 void set_symbol(const char *name, int int_value, float float_value, char *string_value, int type, bool is_function);
+void set_symbol_string(const char *name, MLString value);
 void set_function_params(const char *name, char **param_types, int param_count);
 void set_function_def(const char *name, ASTNode *func_def);
 int get_type_from_string(const char *type_str);
@@ -0,0 +1,573 @@
+#include "x86enc.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+void x86_code_init(X86Code *code)
+{
+    memset(code, 0, sizeof(*code));
+}
+
+void x86_code_free(X86Code *code)
+{
+    for (int i = 0; i < code->reloc_count; i++)
+    {
+        free((char *)code->relocs[i].symbol);
+    }
+    for (int i = 0; i < code->symbol_count; i++)
+    {
+        free((char *)code->symbols[i].name);
+    }
+    free(code->bytes);
+    free(code->relocs);
+    free(code->symbols);
+    memset(code, 0, sizeof(*code));
+}
+
+static void *grow(void *data, int *capacity, int needed, size_t item_size)
+{
+    if (needed <= *capacity)
+        return data;
+    int new_capacity = *capacity == 0 ? 64 : *capacity;
+    while (new_capacity < needed)
+    {
+        new_capacity *= 2;
+    }
+    data = realloc(data, new_capacity * item_size);
+    if (!data)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for machine code\n");
+        exit(1);
+    }
+    *capacity = new_capacity;
+    return data;
+}
+
+static void emit_byte(X86Code *code, int byte)
+{
+    code->bytes = grow(code->bytes, &code->capacity, code->length + 1, 1);
+    code->bytes[code->length++] = (unsigned char)byte;
+}
+
+static void emit_u32(X86Code *code, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        emit_byte(code, (value >> (8 * i)) & 0xff);
+    }
+}
+
+// 外部调用在汇编文本里带 @PLT 后缀，重定位只记录符号名
+static void add_reloc(X86Code *code, const char *symbol, X86RelocKind kind, int addend)
+{
+    code->relocs = grow(code->relocs, &code->reloc_capacity, code->reloc_count + 1, sizeof(X86Reloc));
+    const char *suffix = strstr(symbol, "@PLT");
+    size_t length = suffix ? (size_t)(suffix - symbol) : strlen(symbol);
+    char *name = malloc(length + 1);
+    memcpy(name, symbol, length);
+    name[length] = '\0';
+
+    X86Reloc *reloc = &code->relocs[code->reloc_count++];
+    reloc->offset = code->length;
+    reloc->symbol = name;
+    reloc->kind = suffix ? X86_RELOC_CALL : kind;
+    reloc->addend = addend;
+    emit_u32(code, 0);
+}
+
+static X86Symbol *add_symbol(X86Code *code, const char *name)
+{
+    code->symbols = grow(code->symbols, &code->symbol_capacity, code->symbol_count + 1, sizeof(X86Symbol));
+    X86Symbol *symbol = &code->symbols[code->symbol_count++];
+    symbol->name = strdup(name);
+    symbol->offset = code->length;
+    symbol->is_function = false;
+    symbol->global = false;
+    symbol->size = 0;
+    return symbol;
+}
+
+const X86Symbol *x86_find_symbol(const X86Code *code, const char *name)
+{
+    for (int i = 0; i < code->symbol_count; i++)
+    {
+        if (strcmp(code->symbols[i].name, name) == 0)
+            return &code->symbols[i];
+    }
+    return NULL;
+}
+
+void x86_resolve_local(X86Code *code)
+{
+    int kept = 0;
+    for (int i = 0; i < code->reloc_count; i++)
+    {
+        X86Reloc *reloc = &code->relocs[i];
+        const X86Symbol *target = x86_find_symbol(code, reloc->symbol);
+        if (target == NULL)
+        {
+            code->relocs[kept++] = *reloc;
+            continue;
+        }
+        uint32_t value = (uint32_t)(target->offset + reloc->addend - reloc->offset);
+        memcpy(code->bytes + reloc->offset, &value, 4);
+        free((char *)reloc->symbol);
+    }
+    code->reloc_count = kept;
+}
+
+// 编码上下文：MOP_ARG 的位移取决于函数保存的寄存器个数
+typedef struct
+{
+    X86Code *code;
+    const MirFunction *fn;
+} Encoder;
+
+static bool is_memory(const MirOperand *op)
+{
+    return op->kind == MOP_MEM || op->kind == MOP_RIP || op->kind == MOP_ARG;
+}
+
+// REX 前缀 + 操作码 + ModRM/SIB/位移；reg 为 ModRM.reg 字段（寄存器号或操作码扩展），
+// imm_size 为指令末尾立即数的字节数（%rip 相对位移以指令结尾为基准）
+static bool emit_modrm(Encoder *enc, bool wide, const unsigned char *opcode, int opcode_length, int reg,
+                       const MirOperand *rm, int imm_size)
+{
+    X86Code *code = enc->code;
+    int rex = wide ? 0x48 : 0;
+    if (reg >= 8)
+        rex |= 0x44;
+
+    int base = -1, index = -1, scale = 1;
+    long disp = 0;
+    switch (rm->kind)
+    {
+    case MOP_REG:
+        if (rm->reg >= 8)
+            rex |= 0x41;
+        // %spl/%bpl/%sil/%dil 需要 REX 前缀
+        else if (rm->size == 1 && rm->reg >= 4)
+            rex |= 0x40;
+        break;
+    case MOP_XMM:
+        if (rm->reg >= 8)
+            rex |= 0x41;
+        break;
+    case MOP_MEM:
+        base = rm->reg;
+        index = rm->index;
+        scale = rm->scale;
+        disp = rm->value;
+        break;
+    case MOP_ARG:
+        base = REG_RBP;
+        disp = 16 + 8L * enc->fn->saved_regs + rm->value;
+        break;
+    case MOP_RIP:
+        break;
+    default:
+        return false;
+    }
+    if (base >= 8)
+        rex |= 0x41;
+    if (index >= 8)
+        rex |= 0x42;
+    if (rex)
+        emit_byte(code, rex);
+    for (int i = 0; i < opcode_length; i++)
+    {
+        emit_byte(code, opcode[i]);
+    }
+
+    int reg_bits = (reg & 7) << 3;
+    if (rm->kind == MOP_REG || rm->kind == MOP_XMM)
+    {
+        emit_byte(code, 0xc0 | reg_bits | (rm->reg & 7));
+        return true;
+    }
+    if (rm->kind == MOP_RIP)
+    {
+        emit_byte(code, 0x05 | reg_bits);
+        add_reloc(code, rm->symbol, X86_RELOC_PC32, -4 - imm_size);
+        return true;
+    }
+
+    int mod;
+    if (disp == 0 && (base & 7) != 5)
+        mod = 0;
+    else if (disp >= -128 && disp <= 127)
+        mod = 1;
+    else
+        mod = 2;
+
+    if (index >= 0 || (base & 7) == 4)
+    {
+        int scale_bits = scale == 8 ? 3 : scale == 4 ? 2 : scale == 2 ? 1 : 0;
+        emit_byte(code, (mod << 6) | reg_bits | 4);
+        emit_byte(code, (scale_bits << 6) | ((index >= 0 ? index : 4) & 7) << 3 | (base & 7));
+    }
+    else
+    {
+        emit_byte(code, (mod << 6) | reg_bits | (base & 7));
+    }
+    if (mod == 1)
+        emit_byte(code, (int)disp & 0xff);
+    else if (mod == 2)
+        emit_u32(code, (uint32_t)disp);
+    return true;
+}
+
+static bool emit_op(Encoder *enc, bool wide, int opcode, int reg, const MirOperand *rm, int imm_size)
+{
+    unsigned char bytes[1] = {(unsigned char)opcode};
+    return emit_modrm(enc, wide, bytes, 1, reg, rm, imm_size);
+}
+
+static bool emit_op2(Encoder *enc, bool wide, int opcode, int reg, const MirOperand *rm)
+{
+    unsigned char bytes[2] = {0x0f, (unsigned char)opcode};
+    return emit_modrm(enc, wide, bytes, 2, reg, rm, 0);
+}
+
+// SSE 指令：必需前缀（0x66/0xf3，0 表示没有）在 REX 之前，操作码为 0f xx
+static bool emit_sse(Encoder *enc, int prefix, bool wide, int opcode, int reg, const MirOperand *rm)
+{
+    if (prefix)
+        emit_byte(enc->code, prefix);
+    return emit_op2(enc, wide, opcode, reg, rm);
+}
+
+static bool is_xmm(const MirOperand *op)
+{
+    return op->kind == MOP_XMM;
+}
+
+// 源操作数为 %xmm 或内存、目的为 %xmm 的运算
+static bool encode_sse_arith(Encoder *enc, const MirInstr *instr, int prefix, int opcode)
+{
+    const MirOperand *src = &instr->ops[0];
+    const MirOperand *dst = &instr->ops[1];
+    if (!is_xmm(dst) || (!is_xmm(src) && !is_memory(src)))
+        return false;
+    return emit_sse(enc, prefix, false, opcode, dst->reg, src);
+}
+
+static bool encode_sse(Encoder *enc, const MirInstr *instr)
+{
+    const MirOperand *src = &instr->ops[0];
+    const MirOperand *dst = &instr->ops[1];
+    bool wide = instr->size == 8;
+    switch (instr->op)
+    {
+    case MIR_MOVD:
+        // 66 0f 6e：r/m → xmm；66 0f 7e：xmm → r/m
+        if (is_xmm(dst) && !is_xmm(src))
+            return emit_sse(enc, 0x66, wide, 0x6e, dst->reg, src);
+        if (is_xmm(src) && !is_xmm(dst))
+            return emit_sse(enc, 0x66, wide, 0x7e, src->reg, dst);
+        return false;
+    case MIR_MOVSS:
+        if (is_xmm(dst))
+            return (is_xmm(src) || is_memory(src)) && emit_sse(enc, 0xf3, false, 0x10, dst->reg, src);
+        return is_xmm(src) && is_memory(dst) && emit_sse(enc, 0xf3, false, 0x11, src->reg, dst);
+    case MIR_ADDSS:
+        return encode_sse_arith(enc, instr, 0xf3, 0x58);
+    case MIR_MULSS:
+        return encode_sse_arith(enc, instr, 0xf3, 0x59);
+    case MIR_SUBSS:
+        return encode_sse_arith(enc, instr, 0xf3, 0x5c);
+    case MIR_DIVSS:
+        return encode_sse_arith(enc, instr, 0xf3, 0x5e);
+    case MIR_CVTSS2SD:
+        return encode_sse_arith(enc, instr, 0xf3, 0x5a);
+    case MIR_UCOMISS:
+        return encode_sse_arith(enc, instr, 0, 0x2e);
+    case MIR_MOVUPS:
+        if (is_xmm(dst))
+            return (is_xmm(src) || is_memory(src)) && emit_sse(enc, 0, false, 0x10, dst->reg, src);
+        return is_xmm(src) && is_memory(dst) && emit_sse(enc, 0, false, 0x11, src->reg, dst);
+    case MIR_PADDD:
+        return encode_sse_arith(enc, instr, 0x66, 0xfe);
+    case MIR_PSUBD:
+        return encode_sse_arith(enc, instr, 0x66, 0xfa);
+    case MIR_ADDPS:
+        return encode_sse_arith(enc, instr, 0, 0x58);
+    case MIR_SUBPS:
+        return encode_sse_arith(enc, instr, 0, 0x5c);
+    case MIR_MULPS:
+        return encode_sse_arith(enc, instr, 0, 0x59);
+    case MIR_DIVPS:
+        return encode_sse_arith(enc, instr, 0, 0x5e);
+    case MIR_PUNPCKLDQ:
+        return encode_sse_arith(enc, instr, 0x66, 0x62);
+    case MIR_PUNPCKLQDQ:
+        return encode_sse_arith(enc, instr, 0x66, 0x6c);
+    case MIR_CVTSI2SS:
+        return is_xmm(dst) && !is_xmm(src) && emit_sse(enc, 0xf3, false, 0x2a, dst->reg, src);
+    case MIR_CVTTSS2SI:
+        return dst->kind == MOP_REG && (is_xmm(src) || is_memory(src)) &&
+               emit_sse(enc, 0xf3, false, 0x2c, dst->reg, src);
+    default:
+        return false;
+    }
+}
+
+static bool fits_int8(long value)
+{
+    return value >= -128 && value <= 127;
+}
+
+// ADD/SUB/AND/XOR/CMP：立即数形式用 81/83 /ext，寄存器形式用 op_rm_r 或 op_r_rm
+static bool encode_alu(Encoder *enc, const MirInstr *instr, int ext, int op_rm_r)
+{
+    const MirOperand *src = &instr->ops[0];
+    const MirOperand *dst = &instr->ops[1];
+    bool wide = instr->size == 8;
+    if (src->kind == MOP_IMM)
+    {
+        if (fits_int8(src->value))
+        {
+            if (!emit_op(enc, wide, 0x83, ext, dst, 1))
+                return false;
+            emit_byte(enc->code, (int)src->value & 0xff);
+        }
+        else
+        {
+            if (!emit_op(enc, wide, 0x81, ext, dst, 4))
+                return false;
+            emit_u32(enc->code, (uint32_t)src->value);
+        }
+        return true;
+    }
+    if (src->kind == MOP_REG)
+        return emit_op(enc, wide, op_rm_r, src->reg, dst, 0);
+    if (dst->kind == MOP_REG)
+        return emit_op(enc, wide, op_rm_r + 2, dst->reg, src, 0);
+    return false;
+}
+
+static bool encode_mov(Encoder *enc, const MirInstr *instr)
+{
+    const MirOperand *src = &instr->ops[0];
+    const MirOperand *dst = &instr->ops[1];
+    bool wide = instr->size == 8;
+    if (src->kind == MOP_IMM)
+    {
+        if (dst->kind == MOP_REG && !wide)
+        {
+            if (dst->reg >= 8)
+                emit_byte(enc->code, 0x41);
+            emit_byte(enc->code, 0xb8 + (dst->reg & 7));
+        }
+        else if (!emit_op(enc, wide, 0xc7, 0, dst, 4))
+        {
+            return false;
+        }
+        emit_u32(enc->code, (uint32_t)src->value);
+        return true;
+    }
+    if (src->kind == MOP_REG)
+        return emit_op(enc, wide, 0x89, src->reg, dst, 0);
+    if (dst->kind == MOP_REG && is_memory(src))
+        return emit_op(enc, wide, 0x8b, dst->reg, src, 0);
+    return false;
+}
+
+static const int cond_codes[] = {0x4, 0x5, 0xc, 0xe, 0xf, 0xd, 0x2, 0x3, 0x7, 0x6, 0xa, 0xb};
+
+static bool encode_instr(Encoder *enc, const MirInstr *instr)
+{
+    X86Code *code = enc->code;
+    const MirOperand *a = &instr->ops[0];
+    const MirOperand *b = &instr->ops[1];
+    bool wide = instr->size == 8;
+
+    switch (instr->op)
+    {
+    case MIR_MOV:
+        return encode_mov(enc, instr);
+    case MIR_MOVZB:
+        return b->kind == MOP_REG && emit_op2(enc, wide, 0xb6, b->reg, a);
+    case MIR_LEA:
+        return b->kind == MOP_REG && is_memory(a) && emit_op(enc, true, 0x8d, b->reg, a, 0);
+    case MIR_ADD:
+        return encode_alu(enc, instr, 0, 0x01);
+    case MIR_SUB:
+        return encode_alu(enc, instr, 5, 0x29);
+    case MIR_AND:
+        return encode_alu(enc, instr, 4, 0x21);
+    case MIR_XOR:
+        return encode_alu(enc, instr, 6, 0x31);
+    case MIR_CMP:
+        return encode_alu(enc, instr, 7, 0x39);
+    case MIR_TEST:
+        return a->kind == MOP_REG && emit_op(enc, wide, 0x85, a->reg, b, 0);
+    case MIR_IMUL:
+        if (b->kind != MOP_REG)
+            return false;
+        if (a->kind == MOP_IMM)
+        {
+            if (!emit_op(enc, wide, 0x69, b->reg, b, 4))
+                return false;
+            emit_u32(code, (uint32_t)a->value);
+            return true;
+        }
+        return emit_op2(enc, wide, 0xaf, b->reg, a);
+    case MIR_IMUL_WIDE:
+        return emit_op(enc, wide, 0xf7, 5, a, 0);
+    case MIR_IDIV:
+        return emit_op(enc, wide, 0xf7, 7, a, 0);
+    case MIR_SAR:
+    case MIR_SHR:
+        if (a->kind != MOP_IMM || !emit_op(enc, wide, 0xc1, instr->op == MIR_SAR ? 7 : 5, b, 1))
+            return false;
+        emit_byte(code, (uint8_t)a->value);
+        return true;
+    case MIR_DEC:
+        return emit_op(enc, wide, 0xff, 1, a, 0);
+    case MIR_CDQ:
+        emit_byte(code, 0x99);
+        return true;
+    case MIR_REP_STOSQ:
+        emit_byte(code, 0xf3);
+        emit_byte(code, 0x48);
+        emit_byte(code, 0xab);
+        return true;
+    case MIR_SETCC:
+        return emit_op2(enc, false, 0x90 + cond_codes[instr->cond], 0, a);
+    case MIR_PUSH:
+    case MIR_POP:
+        if (a->kind != MOP_REG)
+            return false;
+        if (a->reg >= 8)
+            emit_byte(code, 0x41);
+        emit_byte(code, (instr->op == MIR_PUSH ? 0x50 : 0x58) + (a->reg & 7));
+        return true;
+    case MIR_JMP:
+        emit_byte(code, 0xe9);
+        add_reloc(code, a->symbol, X86_RELOC_PC32, -4);
+        return true;
+    case MIR_JCC:
+        emit_byte(code, 0x0f);
+        emit_byte(code, 0x80 + cond_codes[instr->cond]);
+        add_reloc(code, a->symbol, X86_RELOC_PC32, -4);
+        return true;
+    case MIR_CALL:
+        emit_byte(code, 0xe8);
+        add_reloc(code, a->symbol, X86_RELOC_CALL, -4);
+        return true;
+    case MIR_NOP:
+        emit_byte(code, 0x90);
+        return true;
+    case MIR_LABEL:
+        add_symbol(code, a->symbol);
+        return true;
+    case MIR_MOVD:
+    case MIR_MOVSS:
+    case MIR_ADDSS:
+    case MIR_SUBSS:
+    case MIR_MULSS:
+    case MIR_DIVSS:
+    case MIR_UCOMISS:
+    case MIR_CVTSI2SS:
+    case MIR_CVTTSS2SI:
+    case MIR_CVTSS2SD:
+    case MIR_MOVUPS:
+    case MIR_PADDD:
+    case MIR_PSUBD:
+    case MIR_ADDPS:
+    case MIR_SUBPS:
+    case MIR_MULPS:
+    case MIR_DIVPS:
+    case MIR_PUNPCKLDQ:
+    case MIR_PUNPCKLQDQ:
+        return encode_sse(enc, instr);
+    case MIR_RET:
+        break;
+    }
+    return false;
+}
+
+static void encode_push_reg(X86Code *code, MirReg reg)
+{
+    if (reg >= 8)
+        emit_byte(code, 0x41);
+    emit_byte(code, 0x50 + (reg & 7));
+}
+
+static void encode_pop_reg(X86Code *code, MirReg reg)
+{
+    if (reg >= 8)
+        emit_byte(code, 0x41);
+    emit_byte(code, 0x58 + (reg & 7));
+}
+
+// 与 mir_emit_function 输出的序言和尾声相同
+static void encode_prologue(X86Code *code, const MirFunction *fn)
+{
+    encode_push_reg(code, REG_RBP);
+    for (int i = 0; i < fn->saved_regs; i++)
+    {
+        encode_push_reg(code, mir_target->saved_regs[i]);
+    }
+    // movq %rsp, %rbp
+    emit_byte(code, 0x48);
+    emit_byte(code, 0x89);
+    emit_byte(code, 0xe5);
+
+    int frame_size = fn->frame_size + (fn->saved_regs % 2 != 0 ? 8 : 0);
+    if (frame_size > 0)
+    {
+        // subq $frame_size, %rsp
+        emit_byte(code, 0x48);
+        emit_byte(code, 0x81);
+        emit_byte(code, 0xec);
+        emit_u32(code, (uint32_t)frame_size);
+    }
+}
+
+static void encode_epilogue(X86Code *code, const MirFunction *fn)
+{
+    if (fn->saved_regs == 0)
+    {
+        emit_byte(code, 0xc9); // leave
+    }
+    else
+    {
+        // movq %rbp, %rsp
+        emit_byte(code, 0x48);
+        emit_byte(code, 0x89);
+        emit_byte(code, 0xec);
+        for (int i = fn->saved_regs - 1; i >= 0; i--)
+        {
+            encode_pop_reg(code, mir_target->saved_regs[i]);
+        }
+        encode_pop_reg(code, REG_RBP);
+    }
+    emit_byte(code, 0xc3); // ret
+}
+
+bool x86_encode_function(X86Code *code, const MirFunction *fn)
+{
+    Encoder enc = {code, fn};
+    int symbol_index = code->symbol_count;
+    X86Symbol *entry = add_symbol(code, fn->name);
+    entry->is_function = true;
+    entry->global = fn->global;
+
+    encode_prologue(code, fn);
+    for (int i = 0; i < fn->count; i++)
+    {
+        const MirInstr *instr = &fn->code[i];
+        if (instr->op == MIR_RET)
+        {
+            encode_epilogue(code, fn);
+            continue;
+        }
+        if (!encode_instr(&enc, instr))
+            return false;
+    }
+    // 符号表可能已扩容，重新取入口
+    code->symbols[symbol_index].size = code->length - code->symbols[symbol_index].offset;
+    return true;
+}
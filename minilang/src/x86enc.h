@@ -0,0 +1,55 @@
+#ifndef X86ENC_H
+#define X86ENC_H
+
+#include "mir.h"
+
+// x86-64 机器码编码：把寄存器分配后的 MIR 函数编码为字节，供 JIT 和目标文件输出使用
+
+typedef enum
+{
+    X86_RELOC_PC32, // 32位 PC 相对（%rip 寻址、跳转），值 = S + addend - P
+    X86_RELOC_CALL, // call/跳转到函数符号，外部符号由链接器经 PLT 解析
+} X86RelocKind;
+
+typedef struct
+{
+    int offset;         // 需要填写的4字节字段在代码中的位置
+    const char *symbol; // 目标符号（标签、函数或外部符号）
+    X86RelocKind kind;
+    int addend;
+} X86Reloc;
+
+typedef struct
+{
+    const char *name;
+    int offset;
+    bool is_function; // 函数入口（其余为函数内标签）
+    bool global;
+    int size; // 函数字节数
+} X86Symbol;
+
+typedef struct
+{
+    unsigned char *bytes;
+    int length;
+    int capacity;
+    X86Reloc *relocs;
+    int reloc_count;
+    int reloc_capacity;
+    X86Symbol *symbols;
+    int symbol_count;
+    int symbol_capacity;
+} X86Code;
+
+void x86_code_init(X86Code *code);
+void x86_code_free(X86Code *code);
+
+// 编码函数（含序言和尾声）追加到 code；遇到无法编码的指令时返回 false
+bool x86_encode_function(X86Code *code, const MirFunction *fn);
+
+const X86Symbol *x86_find_symbol(const X86Code *code, const char *name);
+
+// 填写目标在 code 内部的重定位并从列表中移除，剩下的是外部符号引用
+void x86_resolve_local(X86Code *code);
+
+#endif // X86ENC_H
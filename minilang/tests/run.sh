@@ -0,0 +1,96 @@
+#!/bin/bash
+
+# 回归测试（make check）：tests/ 下每个 <名字>.mylang 分别由解释器、-S、-c 和 -native 运行，
+# 程序的输出都要与 <名字>.expected 相同
+# 用法：tests/run.sh <minilang> <libmlrt.a> <工作目录>
+
+MINILANG=$1
+RUNTIME_LIB=$2
+WORK=$3
+CC=${CC:-gcc}
+TESTS=$(cd "$(dirname "$0")" && pwd)
+failed=0
+
+mkdir -p "$WORK"
+
+# 解释器把程序输出汇总在 "=== Print Output ===" 之后，最后一行是与下一节之间的空行
+interpreter_output() {
+    "$MINILANG" "$1" 2>&1 |
+        awk '/^=== Program Execution Result ===$/ { exit } p { print } /^=== Print Output ===$/ { p = 1 }' |
+        sed '$d'
+}
+
+# 编译后运行：-S 和 -c 的输出与运行时库链接，-native 直接生成可执行文件
+compiled_output() {
+    local mode=$1
+    local source=$2
+    local base=${source%.mylang}
+    "$MINILANG" "$mode" "$source" > "$base.log" 2>&1 || { echo "(compile failed)"; return; }
+    case "$mode" in
+        -S) $CC -o "$base" "$base.s" "$RUNTIME_LIB" -pthread || return ;;
+        -c) $CC -o "$base" "$base.o" "$RUNTIME_LIB" -pthread || return ;;
+    esac
+    "$base" 2>&1
+}
+
+report() {
+    local name=$1
+    local backend=$2
+    local actual=$3
+    if diff -u "$TESTS/$name.expected" <(printf '%s\n' "$actual") > "$WORK/$name.$backend.diff"; then
+        echo "✅ $name ($backend)"
+    else
+        echo "❌ $name ($backend)"
+        cat "$WORK/$name.$backend.diff"
+        failed=1
+    fi
+}
+
+for test in "$TESTS"/*.mylang; do
+    name=$(basename "$test" .mylang)
+    report "$name" interpreter "$(interpreter_output "$test")"
+    for mode in -S -c -native; do
+        source="$WORK/$name${mode}.mylang"
+        cp "$test" "$source"
+        report "$name" "${mode#-}" "$(compiled_output "$mode" "$source")"
+    done
+done
+
+# tests/errors/ 下的程序在每个后端都要以非0状态退出，输出中要有 <名字>.expected 的内容
+# （解释器和 -native 的错误信息以 "Error: " 开头，-S 和 -c 以 "Runtime error: " 开头）
+report_error() {
+    local name=$1
+    local backend=$2
+    local status=$3
+    local actual=$4
+    if [ "$status" -ne 0 ] && grep -qF -- "$(cat "$TESTS/errors/$name.expected")" <<< "$actual"; then
+        echo "✅ $name ($backend)"
+    else
+        echo "❌ $name ($backend): exit status $status"
+        printf '%s\n' "$actual"
+        failed=1
+    fi
+}
+
+for test in "$TESTS"/errors/*.mylang; do
+    name=$(basename "$test" .mylang)
+    actual=$("$MINILANG" "$test" 2>&1)
+    report_error "$name" interpreter $? "$actual"
+    for mode in -S -c -native; do
+        source="$WORK/$name${mode}.mylang"
+        cp "$test" "$source"
+        actual=$(compiled_output "$mode" "$source")
+        report_error "$name" "${mode#-}" $? "$actual"
+    done
+done
+
+# 默认选项下 examples/vector.mylang 的数组循环要向量化，而不是先被循环展开
+cp "$TESTS/../examples/vector.mylang" "$WORK/vector.mylang"
+if "$MINILANG" -S "$WORK/vector.mylang" 2>&1 | grep -q '^Vectorized loops: [1-9]'; then
+    echo "✅ vector (vectorized by default)"
+else
+    echo "❌ vector (vectorized by default)"
+    failed=1
+fi
+
+exit $failed